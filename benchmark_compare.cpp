@@ -0,0 +1,163 @@
+#include "include/BenchmarkHarness.hpp"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <regex>
+#include <cmath>
+#include <algorithm>
+
+#define ERROR(msg) std::cerr << "[ERROR] " << msg << std::endl;
+
+namespace {
+
+    enum class Verdict { Same, Faster, Slower, Added, Removed };
+
+    struct Comparison {
+        std::string name;
+        const Bench::Result* baseline = nullptr;
+        const Bench::Result* current = nullptr;
+        double change = 0.0;     // relative change of the median time, + is slower
+        double threshold = 0.0;  // |change| above this is significant
+        Verdict verdict = Verdict::Same;
+    };
+
+    // Relative spread of the repetitions: 1.4826 * MAD / median, which
+    // estimates the coefficient of variation for normal noise but ignores a
+    // single preempted repetition; the stored CV when there are too few samples
+    double robustCv(const Bench::Result& r) {
+        if (r.samples_ns.size() < 3 || r.median_ns <= 0.0) return r.cv;
+        std::vector<double> deviations;
+        for (double s : r.samples_ns) deviations.push_back(std::fabs(s - r.median_ns));
+        std::sort(deviations.begin(), deviations.end());
+        const size_t mid = deviations.size() / 2;
+        const double mad = deviations.size() % 2 ? deviations[mid] : 0.5 * (deviations[mid - 1] + deviations[mid]);
+        return 1.4826 * mad / r.median_ns;
+    }
+
+    // Noise band of one benchmark: sigma times the relative standard
+    // deviation of the difference of two single runs, estimated from the
+    // repetitions of both files, but never below min_threshold. Benchmarks
+    // that were noisy in either run need a larger change to count.
+    double noiseThreshold(const Bench::Result& a, const Bench::Result& b, double sigma, double min_threshold) {
+        const double cv_a = robustCv(a), cv_b = robustCv(b);
+        return std::max(min_threshold, sigma * std::sqrt(cv_a * cv_a + cv_b * cv_b));
+    }
+
+    std::string percent(double x, bool sign) {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(1) << (sign && x > 0 ? "+" : "") << 100.0 * x << "%";
+        return oss.str();
+    }
+
+} // namespace
+
+// Usage: benchmark_compare BASELINE.json CURRENT.json [--sigma K] [--min-threshold PCT] [--filter REGEX]
+// Compares two benchmark_suite --json files by median time per iteration.
+// A benchmark is significantly slower (or faster) when its median moved by
+// more than max(--min-threshold, K * sqrt(cv_baseline^2 + cv_current^2)),
+// i.e. by more than K standard deviations of the repetition noise seen in
+// the two runs (default K = 2, floor 5%). The CVs are taken from the median
+// absolute deviation of the samples, so one outlier repetition does not
+// widen the band. Exits 1 when any benchmark is
+// significantly slower, 2 on bad input, 0 otherwise.
+int main(int argc, char** argv) {
+    std::vector<std::string> files;
+    double sigma = 2.0;
+    double min_threshold = 0.05;
+    std::string filter;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--sigma" && i + 1 < argc) {
+            sigma = std::stod(argv[++i]);
+        } else if (arg == "--min-threshold" && i + 1 < argc) {
+            min_threshold = std::stod(argv[++i]) / 100.0;
+        } else if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (arg.rfind("--", 0) != 0 && files.size() < 2) {
+            files.push_back(arg);
+        } else {
+            files.clear();
+            break;
+        }
+    }
+    if (files.size() != 2) {
+        std::cerr << "Usage: benchmark_compare BASELINE.json CURRENT.json [--sigma K] [--min-threshold PCT]"
+                  << " [--filter REGEX]" << std::endl;
+        return 2;
+    }
+
+    std::vector<Bench::Result> baseline, current;
+    std::string error;
+    if (!Bench::readJson(files[0], baseline, error) || !Bench::readJson(files[1], current, error)) {
+        ERROR(error);
+        return 2;
+    }
+
+    // Baseline order first, then benchmarks only the current run has
+    const std::regex pattern(filter.empty() ? std::string(".*") : filter);
+    std::vector<Comparison> rows;
+    auto find = [](const std::vector<Bench::Result>& results, const std::string& name) -> const Bench::Result* {
+        for (const auto& r : results) {
+            if (r.name == name) return &r;
+        }
+        return nullptr;
+    };
+    for (const auto& b : baseline) {
+        if (std::regex_search(b.name, pattern)) rows.push_back({b.name, &b, find(current, b.name)});
+    }
+    for (const auto& c : current) {
+        if (std::regex_search(c.name, pattern) && !find(baseline, c.name)) rows.push_back({c.name, nullptr, &c});
+    }
+
+    size_t slower = 0, faster = 0;
+    for (auto& row : rows) {
+        if (!row.current) {
+            row.verdict = Verdict::Removed;
+            continue;
+        }
+        if (!row.baseline) {
+            row.verdict = Verdict::Added;
+            continue;
+        }
+        row.change = row.baseline->median_ns > 0.0 ? row.current->median_ns / row.baseline->median_ns - 1.0 : 0.0;
+        row.threshold = noiseThreshold(*row.baseline, *row.current, sigma, min_threshold);
+        if (row.change > row.threshold) {
+            row.verdict = Verdict::Slower;
+            ++slower;
+        } else if (row.change < -row.threshold) {
+            row.verdict = Verdict::Faster;
+            ++faster;
+        }
+    }
+
+    std::cout << std::left << std::setw(52) << "Benchmark" << std::right << std::setw(14) << "Baseline"
+              << std::setw(14) << "Current" << std::setw(10) << "Change" << std::setw(10) << "Noise"
+              << "  Verdict\n"
+              << std::string(109, '-') << "\n";
+    for (const auto& row : rows) {
+        std::cout << std::left << std::setw(52) << row.name << std::right
+                  << std::setw(14) << (row.baseline ? Bench::formatTime(row.baseline->median_ns) : "-")
+                  << std::setw(14) << (row.current ? Bench::formatTime(row.current->median_ns) : "-");
+        if (row.baseline && row.current) {
+            std::cout << std::setw(10) << percent(row.change, true) << std::setw(10)
+                      << percent(row.threshold, false);
+        } else {
+            std::cout << std::setw(10) << "" << std::setw(10) << "";
+        }
+        switch (row.verdict) {
+            case Verdict::Same: std::cout << "  ok"; break;
+            case Verdict::Faster: std::cout << "  FASTER"; break;
+            case Verdict::Slower: std::cout << "  SLOWER"; break;
+            case Verdict::Added: std::cout << "  new"; break;
+            case Verdict::Removed: std::cout << "  missing"; break;
+        }
+        std::cout << "\n";
+    }
+
+    std::cout << "\n" << rows.size() << " benchmarks: " << slower << " significantly slower, " << faster
+              << " significantly faster (" << sigma << " sigma, floor " << percent(min_threshold, false) << ")"
+              << std::endl;
+    return slower > 0 ? 1 : 0;
+}
@@ -4,14 +4,59 @@
 #include "include/MovingAverage.hpp"
 #include "include/GPUStrategy.hpp"
 #include "include/FileUtils.hpp"
+#include "include/GeneticStrategy.hpp"
+#include "include/EvaluationArena.hpp"
 #include <iostream>
 #include <chrono>
 #include <vector>
 #include <iomanip>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+// Counting allocator: every global operator new in this process bumps these,
+// so a test can report how many heap allocations a code path performs
+namespace AllocCounter {
+    std::atomic<size_t> allocations{0};
+    std::atomic<size_t> bytes{0};
+}
+
+// GCC sees the inlined free() below paired with the library operator new it
+// replaces and warns; the pairing is correct because both are replaced here
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    AllocCounter::allocations.fetch_add(1, std::memory_order_relaxed);
+    AllocCounter::bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+// Over-aligned forms (std::pmr::new_delete_resource allocates through these)
+void* operator new(std::size_t size, std::align_val_t align) {
+    AllocCounter::allocations.fetch_add(1, std::memory_order_relaxed);
+    AllocCounter::bytes.fetch_add(size, std::memory_order_relaxed);
+    std::size_t a = static_cast<std::size_t>(align);
+    if (void* p = std::aligned_alloc(a, (size + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t align) { return operator new(size, align); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
 
 // Declare the GPU function at global scope
 extern "C" void gpu_calculate_all_indicators_and_signals(
-    const double* prices, int n,
+    const double* prices, const double* highs, const double* lows, int n,
     double* sma, double* rsi, int* signals, double* stops, double* targets,
     int sma_period, int rsi_period, double rsi_oversold, double risk_reward
 );
@@ -27,7 +72,7 @@ public:
         testCPUIndicators(data);
         
         // Test GPU indicators (if available)
-        #ifdef USE_CUDA
+        #if USE_CUDA
         testGPUIndicators(data);
         #else
         std::cout << "GPU testing skipped - CUDA not available\n";
@@ -35,6 +80,12 @@ public:
         
         // Test full backtest performance
         testBacktestPerformance(data);
+
+        // Heap traffic of GA fitness evaluation
+        testEvaluationAllocations(data);
+
+        // Specialized vs switch-based gene evaluation
+        testGeneEvaluatorDispatch(data);
     }
     
 private:
@@ -86,9 +137,11 @@ private:
         const int test_iterations = 10;
         
         // Extract prices
-        std::vector<double> prices(data.size());
+        std::vector<double> prices(data.size()), highs(data.size()), lows(data.size());
         for (size_t i = 0; i < data.size(); ++i) {
             prices[i] = data[i].close;
+            highs[i] = data[i].high;
+            lows[i] = data[i].low;
         }
         
         // Allocate result arrays
@@ -102,7 +155,7 @@ private:
         auto start = std::chrono::high_resolution_clock::now();
         for (int iter = 0; iter < test_iterations; ++iter) {
             gpu_calculate_all_indicators_and_signals(
-                prices.data(), static_cast<int>(data.size()),
+                prices.data(), highs.data(), lows.data(), static_cast<int>(data.size()),
                 sma_values.data(), rsi_values.data(),
                 signals.data(), stops.data(), targets.data(),
                 sma_period, rsi_period, 30.0, 2.0
@@ -139,7 +192,7 @@ private:
         delete cpu_strategy;
         
         // Test GPU strategy (if available)
-        #ifdef USE_CUDA
+        #if USE_CUDA
         Strategy* gpu_strategy = createGPUGoldenFoundationStrategy(2.0);
         Backtester gpu_backtester(data, gpu_strategy, 10000.0);
         
@@ -157,6 +210,87 @@ private:
         
         std::cout << "\n";
     }
+
+    // Runs the same fixed-seed genes through evaluateFitness with the
+    // evaluation arena off (every temporary on the heap) and on
+    static void testEvaluationAllocations(const std::vector<OHLCV>& data) {
+        std::cout << "--- Fitness Evaluation Allocations ---\n";
+
+        const int gene_count = 50;
+        RandomStream rng(42);
+        std::vector<StrategyGene> genes;
+        for (int i = 0; i < gene_count; ++i) genes.push_back(StrategyGene::random(rng));
+
+        GeneticAlgorithm ga(data, gene_count, 1);
+        for (bool use_arena : {false, true}) {
+            EvaluationArena::setEnabled(use_arena);
+            ga.evaluateFitness(genes[0]); // warm up the arena and RSI scratch
+
+            size_t allocs_before = AllocCounter::allocations.load();
+            size_t bytes_before = AllocCounter::bytes.load();
+            double checksum = 0.0;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (const auto& gene : genes) {
+                checksum += ga.evaluateFitness(gene).fitness_score;
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+            size_t allocs = AllocCounter::allocations.load() - allocs_before;
+            size_t bytes = AllocCounter::bytes.load() - bytes_before;
+
+            std::cout << (use_arena ? "Arena: " : "Heap : ")
+                      << std::fixed << std::setprecision(1)
+                      << static_cast<double>(allocs) / gene_count << " allocations/eval, "
+                      << static_cast<double>(bytes) / gene_count / 1024.0 << " KiB/eval, "
+                      << duration.count() << "ms for " << gene_count << " evals"
+                      << " (checksum " << std::setprecision(6) << checksum << ")\n";
+        }
+        EvaluationArena::setEnabled(true);
+        std::cout << "\n";
+    }
+
+    // One genetic_evolution generation (200 random genes) through the
+    // EvolvedStrategy path and through the compile-time dispatch table
+    static void testGeneEvaluatorDispatch(const std::vector<OHLCV>& data) {
+        std::cout << "--- Gene Evaluator Dispatch ---\n";
+
+        const int gene_count = 200;
+        const int rounds = 3;
+        RandomStream rng(1234);
+        std::vector<StrategyGene> genes;
+        for (int i = 0; i < gene_count; ++i) genes.push_back(StrategyGene::random(rng));
+
+        GeneticAlgorithm ga(data, gene_count, 1);
+        std::vector<FitnessResult> generic(gene_count), specialized(gene_count);
+
+        auto time = [&](bool use_specialized) {
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int r = 0; r < rounds; ++r) {
+                for (int i = 0; i < gene_count; ++i) {
+                    if (use_specialized) specialized[i] = ga.evaluateFitness(genes[i]);
+                    else generic[i] = ga.evaluateFitnessGeneric(genes[i]);
+                }
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration<double, std::milli>(end - start).count() / rounds;
+        };
+        double generic_ms = time(false);
+        double specialized_ms = time(true);
+
+        int mismatches = 0;
+        for (int i = 0; i < gene_count; ++i) {
+            if (generic[i].fitness_score != specialized[i].fitness_score ||
+                generic[i].total_trades != specialized[i].total_trades) {
+                ++mismatches;
+            }
+        }
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << "Switch-based (EvolvedStrategy): " << generic_ms << "ms per generation\n"
+                  << "Specialized (dispatch table)  : " << specialized_ms << "ms per generation\n"
+                  << "Speedup: " << std::setprecision(2) << generic_ms / specialized_ms << "x, "
+                  << mismatches << " of " << gene_count << " results differ\n\n";
+    }
 };
 
 int main() {
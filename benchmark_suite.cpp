@@ -0,0 +1,434 @@
+#include "include/BenchmarkHarness.hpp"
+#include "include/SyntheticBars.hpp"
+#include "include/DataLoader.hpp"
+#include "include/DataStore.hpp"
+#include "include/TimeUtils.hpp"
+#include "include/BarView.hpp"
+#include "include/MovingAverage.hpp"
+#include "include/IndicatorSeries.hpp"
+#include "include/ComputeBackend.hpp"
+#include "include/Strategy.hpp"
+#include "include/Backtester.hpp"
+#include "include/PositionEngine.hpp"
+#include "include/GeneticStrategy.hpp"
+#include "include/GeneEvaluator.hpp"
+#include "include/PopulationEvaluator.hpp"
+#include "include/ThreadPool.hpp"
+#include <iostream>
+#include <filesystem>
+#include <sstream>
+#include <streambuf>
+#include <memory>
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+
+#define ERROR(msg) std::cerr << "[ERROR] " << msg << std::endl;
+
+// Microbenchmarks over synthetic random-walk bars (no market data needed).
+// Instance names are "<function>/<bars>[/<parameters>]"; the first argument
+// of every instance is the bar count, so --sizes rescales the whole suite.
+namespace {
+
+    // Bars per size, generated once per process with a fixed seed
+    const std::vector<OHLCV>& barsOf(int64_t n) {
+        static std::map<int64_t, std::vector<OHLCV>> cache;
+        auto it = cache.find(n);
+        if (it == cache.end()) it = cache.emplace(n, SyntheticBars::randomWalk(static_cast<size_t>(n))).first;
+        return it->second;
+    }
+
+    // Scratch directory for the loader benchmarks, removed at exit
+    std::filesystem::path& scratchDir() {
+        static std::filesystem::path dir;
+        return dir;
+    }
+
+    // CSV file per size, written on first use
+    std::string csvOf(int64_t n) {
+        static std::map<int64_t, std::string> files;
+        auto it = files.find(n);
+        if (it != files.end()) return it->second;
+        std::string path = (scratchDir() / ("bars_" + std::to_string(n) + ".csv")).string();
+        SyntheticBars::writeCSV(path, barsOf(n));
+        return files.emplace(n, path).first->second;
+    }
+
+    // Data store holding the bars of one size under symbol "SYN"
+    std::string storeOf(int64_t n) {
+        static std::map<int64_t, std::string> roots;
+        auto it = roots.find(n);
+        if (it != roots.end()) return it->second;
+        std::string root = (scratchDir() / ("store_" + std::to_string(n))).string();
+        DataStore::ingest(root, "SYN", barsOf(n));
+        return roots.emplace(n, root).first->second;
+    }
+
+    // The library logs to stdout on every load and backtest; benchmarks
+    // route it here so formatting is still paid for but nothing is printed
+    class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    };
+
+    void BM_SMA(Bench::State& state) {
+        const BarView bars(barsOf(state.arg(0)));
+        const size_t period = static_cast<size_t>(state.arg(1));
+        for (auto _ : state) {
+            double sum = 0.0;
+            for (size_t i = period; i < bars.size(); ++i) sum += Indicators::SMA(bars, i, period);
+            Bench::doNotOptimize(sum);
+        }
+        state.setItemsProcessed(state.iterations() * bars.size());
+    }
+
+    void BM_RSI(Bench::State& state) {
+        const BarView bars(barsOf(state.arg(0)));
+        const size_t period = static_cast<size_t>(state.arg(1));
+        for (auto _ : state) {
+            double sum = 0.0;
+            for (size_t i = period; i < bars.size(); ++i) sum += Indicators::RSI(bars, i, period);
+            Bench::doNotOptimize(sum);
+        }
+        state.setItemsProcessed(state.iterations() * bars.size());
+    }
+
+    void BM_DetectFVG(Bench::State& state) {
+        const BarView bars(barsOf(state.arg(0)));
+        for (auto _ : state) {
+            size_t gaps = 0;
+            for (size_t i = 2; i < bars.size(); ++i) gaps += Indicators::detectFVG(bars, i);
+            Bench::doNotOptimize(gaps);
+        }
+        state.setItemsProcessed(state.iterations() * bars.size());
+    }
+
+    void BM_BatchIndicators(Bench::State& state) {
+        const BarView bars(barsOf(state.arg(0)));
+        std::vector<double> sma, rsi;
+        for (auto _ : state) {
+            Indicators::calculateBatchIndicators(bars, sma, rsi, static_cast<size_t>(state.arg(1)),
+                                                 static_cast<size_t>(state.arg(2)));
+            Bench::doNotOptimize(sma.data());
+            Bench::doNotOptimize(rsi.data());
+        }
+        state.setItemsProcessed(state.iterations() * bars.size());
+    }
+
+    // Whole-series backends in Real; instance names carry the backend (and
+    // float32)
+    template <class Real>
+    void BM_Series(Bench::State& state, const std::string& indicator, ComputeBackend backend) {
+        const std::vector<OHLCV>& bars = barsOf(state.arg(0));
+        const size_t n = bars.size();
+        std::vector<Real> close(n), high(n), low(n), out(n);
+        std::vector<uint8_t> gaps(n);
+        for (size_t i = 0; i < n; ++i) {
+            close[i] = static_cast<Real>(bars[i].close);
+            high[i] = static_cast<Real>(bars[i].high);
+            low[i] = static_cast<Real>(bars[i].low);
+        }
+        const size_t period = state.arg(1) > 0 ? static_cast<size_t>(state.arg(1)) : 1;
+        for (auto _ : state) {
+            if (indicator == "sma") {
+                Indicators::Series::sma(close.data(), n, period, out.data(), backend);
+            } else if (indicator == "rsi") {
+                Indicators::Series::rsi(close.data(), n, period, out.data(), backend);
+            } else {
+                Indicators::Series::fvg(high.data(), low.data(), n, gaps.data(), backend);
+            }
+            Bench::doNotOptimize(out.data());
+            Bench::doNotOptimize(gaps.data());
+        }
+        state.setItemsProcessed(state.iterations() * n);
+    }
+
+    // Stop/target first-touch scans from every 16th bar, barriers arg(1)
+    // basis points either side of the entry close; items are bars scanned
+    template <class Real>
+    void BM_ScanBarrier(Bench::State& state, ComputeBackend backend) {
+        const std::vector<OHLCV>& bars = barsOf(state.arg(0));
+        const size_t n = bars.size();
+        std::vector<Real> high(n), low(n);
+        for (size_t i = 0; i < n; ++i) {
+            high[i] = static_cast<Real>(bars[i].high);
+            low[i] = static_cast<Real>(bars[i].low);
+        }
+        const Real width = static_cast<Real>(state.arg(1) * 1e-4);
+        size_t scanned = 0;
+        for (auto _ : state) {
+            scanned = 0;
+            for (size_t entry = 0; entry + 1 < n; entry += 16) {
+                const Real close = static_cast<Real>(bars[entry].close);
+                const size_t hit = PositionRules::scanBarrier(high.data(), low.data(), entry + 1, n,
+                                                              close * (Real(1) - width), close * (Real(1) + width), backend);
+                scanned += hit - entry;
+            }
+            Bench::doNotOptimize(scanned);
+        }
+        state.setItemsProcessed(state.iterations() * scanned);
+    }
+
+    void BM_LoadCSV(Bench::State& state) {
+        const std::string path = csvOf(state.arg(0));
+        size_t loaded = 0;
+        for (auto _ : state) {
+            std::vector<OHLCV> bars = DataLoader::loadCSV(path);
+            loaded = bars.size();
+            Bench::doNotOptimize(bars.data());
+        }
+        state.setItemsProcessed(state.iterations() * loaded);
+    }
+
+    void BM_StoreLoad(Bench::State& state) {
+        DataStore store(storeOf(state.arg(0)));
+        size_t loaded = 0;
+        for (auto _ : state) {
+            std::vector<OHLCV> bars = store.load("SYN", INT64_MIN, INT64_MAX);
+            loaded = bars.size();
+            Bench::doNotOptimize(bars.data());
+        }
+        state.setItemsProcessed(state.iterations() * loaded);
+    }
+
+    // Zero-copy mapping plus one pass over the closes
+    void BM_StoreMap(Bench::State& state) {
+        DataStore store(storeOf(state.arg(0)));
+        size_t mapped = 0;
+        for (auto _ : state) {
+            double sum = 0.0;
+            mapped = 0;
+            for (const BarSlice& slice : store.map("SYN", INT64_MIN, INT64_MAX)) {
+                for (const BarRecord& r : slice) sum += r.close;
+                mapped += slice.count;
+            }
+            Bench::doNotOptimize(sum);
+        }
+        state.setItemsProcessed(state.iterations() * mapped);
+    }
+
+    double goldenBacktest(const BarView& bars, int sma, int rsi, double rsi_th, double rr) {
+        std::unique_ptr<Strategy> strategy(createGoldenFoundationStrategy(rr));
+        if (auto* golden = dynamic_cast<GoldenFoundationStrategy*>(strategy.get())) {
+            golden->setSMA(sma);
+            golden->setRSI(rsi, rsi_th);
+        }
+        Backtester backtester(bars, strategy.get(), 10000.0);
+        backtester.setLogging(false);
+        backtester.run();
+        return backtester.getFinalEquity();
+    }
+
+    void BM_Backtest(Bench::State& state) {
+        const BarView bars(barsOf(state.arg(0)));
+        for (auto _ : state) {
+            double equity = goldenBacktest(bars, 20, 14, 30.0, 2.0);
+            Bench::doNotOptimize(equity);
+        }
+        state.setItemsProcessed(state.iterations() * bars.size());
+    }
+
+    // arg(1) fixed-seed random genes per iteration; specialized or generic path
+    template <bool Generic>
+    void BM_EvaluateFitness(Bench::State& state) {
+        const BarView bars(barsOf(state.arg(0)));
+        const size_t gene_count = static_cast<size_t>(state.arg(1));
+        RandomStream rng(7);
+        std::vector<StrategyGene> genes;
+        for (size_t i = 0; i < gene_count; ++i) genes.push_back(StrategyGene::random(rng));
+        GeneticAlgorithm ga(bars, static_cast<int>(gene_count), 1, 0.1, 0.8, 42, 1);
+        for (auto _ : state) {
+            double sum = 0.0;
+            for (const auto& gene : genes) {
+                sum += Generic ? ga.evaluateFitnessGeneric(gene).fitness_score : ga.evaluateFitness(gene).fitness_score;
+            }
+            Bench::doNotOptimize(sum);
+        }
+        state.setItemsProcessed(state.iterations() * gene_count * bars.size());
+    }
+
+    // The same genes as one batch on the CPU population backend, on one
+    // thread so it compares with evaluateFitness
+    template <Precision P>
+    void BM_PopulationBatch(Bench::State& state) {
+        const BarView bars(barsOf(state.arg(0)));
+        const size_t gene_count = static_cast<size_t>(state.arg(1));
+        RandomStream rng(7);
+        std::vector<CudaStrategyGene> genes;
+        for (size_t i = 0; i < gene_count; ++i) genes.push_back(PopulationEvaluator::pack(StrategyGene::random(rng)));
+        const TimeframePyramid pyramid = TimeframePyramid::build(bars);
+        const GeneEvaluator evaluator(bars, pyramid, P);
+        ThreadPool pool(1);
+        const PopulationEvaluator batch(bars, evaluator, pool);
+        std::vector<CudaFitnessResult> results(gene_count);
+        for (auto _ : state) {
+            batch.evaluate(genes.data(), genes.size(), results.data(), PopulationBackend::Cpu);
+            Bench::doNotOptimize(results.data());
+        }
+        state.setItemsProcessed(state.iterations() * gene_count * bars.size());
+    }
+
+    // The strategy_grid_search grid (180 GoldenFoundation backtests), serially
+    void BM_GridSweep(Bench::State& state) {
+        const BarView bars(barsOf(state.arg(0)));
+        size_t configs = 0;
+        for (auto _ : state) {
+            double best = 0.0;
+            configs = 0;
+            for (int sma : {5, 10, 20, 50, 100}) {
+                for (int rsi : {7, 14, 21}) {
+                    for (double rsi_th : {20.0, 30.0, 40.0}) {
+                        for (double rr : {1.5, 2.0, 3.0, 5.0}) {
+                            best = std::max(best, goldenBacktest(bars, sma, rsi, rsi_th, rr));
+                            ++configs;
+                        }
+                    }
+                }
+            }
+            Bench::doNotOptimize(best);
+        }
+        state.setItemsProcessed(state.iterations() * configs * bars.size());
+    }
+
+    std::vector<int64_t> parseList(const std::string& s) {
+        std::vector<int64_t> values;
+        std::stringstream ss(s);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            if (!item.empty()) values.push_back(std::stoll(item));
+        }
+        return values;
+    }
+
+} // namespace
+
+// Usage: benchmark_suite [--filter REGEX] [--sizes N,N,...] [--repetitions N] [--min-time S]
+//                        [--warmup S] [--json FILE] [--list] [--backend scalar|avx2|avx512]
+// Times every instance over --repetitions runs of at least --min-time
+// seconds (after --warmup seconds untimed) and prints mean, median and the
+// coefficient of variation per iteration. --json writes the results with
+// their raw samples for benchmark_compare. --sizes replaces the bar counts.
+// Before timing, every indicator backend is checked against the reference
+// kernels (Indicators::Series::validate); a mismatch fails the run.
+// --backend pins the CPU kernels every benchmark dispatches to (default: the
+// widest the host supports); the [backend] Series and scanBarrier instances
+// keep theirs.
+int main(int argc, char** argv) {
+    Bench::Options options;
+    std::string json_path;
+    bool list = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (arg == "--sizes" && i + 1 < argc) {
+            options.sizes = parseList(argv[++i]);
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            options.repetitions = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            options.min_time = std::stod(argv[++i]);
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            options.warmup_time = std::stod(argv[++i]);
+        } else if (arg == "--json" && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (arg == "--list") {
+            list = true;
+        } else if (arg == "--backend" && i + 1 < argc) {
+            ComputeBackend backend;
+            const std::string name = argv[++i];
+            if (!Compute::parse(name, backend) || !Compute::select(backend)) {
+                ERROR("Backend " << name << " is not a CPU backend this host supports (" << Compute::describe() << ")");
+                return 1;
+            }
+        } else {
+            std::cerr << "Usage: benchmark_suite [--filter REGEX] [--sizes N,N,...] [--repetitions N] [--min-time S]"
+                      << " [--warmup S] [--json FILE] [--list] [--backend scalar|avx2|avx512]" << std::endl;
+            return 1;
+        }
+    }
+
+    options.backend = Compute::name(Compute::cpu());
+
+    Bench::Suite suite;
+    suite.add("Indicators::SMA", BM_SMA, {{4096, 20}, {65536, 20}, {65536, 200}});
+    suite.add("Indicators::RSI", BM_RSI, {{4096, 14}, {65536, 14}, {65536, 50}});
+    suite.add("Indicators::detectFVG", BM_DetectFVG, {{4096}, {65536}});
+    suite.add("Indicators::calculateBatchIndicators", BM_BatchIndicators, {{4096, 20, 14}, {65536, 20, 14}, {65536, 200, 50}});
+    for (auto backend : {ComputeBackend::Scalar, ComputeBackend::Avx2, ComputeBackend::Avx512}) {
+        if (!Indicators::Series::available(backend)) continue;
+        const std::string suffix = std::string("[") + Compute::name(backend) + "]";
+        const std::string suffix_f32 = std::string("[") + Compute::name(backend) + ",float32]";
+        for (const char* indicator : {"sma", "rsi", "fvg"}) {
+            const std::vector<std::vector<int64_t>> args = std::string(indicator) == "fvg"
+                ? std::vector<std::vector<int64_t>>{{65536}}
+                : std::vector<std::vector<int64_t>>{{65536, 20}, {65536, 200}};
+            suite.add(std::string("Indicators::Series::") + indicator + suffix,
+                      [indicator, backend](Bench::State& state) { BM_Series<double>(state, indicator, backend); }, args);
+            suite.add(std::string("Indicators::Series::") + indicator + suffix_f32,
+                      [indicator, backend](Bench::State& state) { BM_Series<float>(state, indicator, backend); }, args);
+        }
+    }
+    for (auto backend : {ComputeBackend::Scalar, ComputeBackend::Avx2, ComputeBackend::Avx512}) {
+        if (!Compute::supported(backend)) continue;
+        suite.add(std::string("PositionRules::scanBarrier[") + Compute::name(backend) + "]",
+                  [backend](Bench::State& state) { BM_ScanBarrier<double>(state, backend); }, {{65536, 20}, {65536, 200}});
+        suite.add(std::string("PositionRules::scanBarrier[") + Compute::name(backend) + ",float32]",
+                  [backend](Bench::State& state) { BM_ScanBarrier<float>(state, backend); }, {{65536, 20}, {65536, 200}});
+    }
+    suite.add("DataLoader::loadCSV", BM_LoadCSV, {{4096}, {65536}});
+    suite.add("DataStore::load", BM_StoreLoad, {{4096}, {65536}});
+    suite.add("DataStore::map", BM_StoreMap, {{4096}, {65536}});
+    suite.add("Backtester::run", BM_Backtest, {{4096}, {65536}});
+    suite.add("GeneticAlgorithm::evaluateFitness", BM_EvaluateFitness<false>, {{4096, 16}, {65536, 16}});
+    suite.add("GeneticAlgorithm::evaluateFitnessGeneric", BM_EvaluateFitness<true>, {{4096, 16}});
+    suite.add("PopulationEvaluator::evaluate[cpu]", BM_PopulationBatch<Precision::Float64>, {{4096, 16}, {65536, 16}});
+    suite.add("PopulationEvaluator::evaluate[cpu,float32]", BM_PopulationBatch<Precision::Float32>, {{4096, 16}, {65536, 16}});
+    suite.add("GridSweep", BM_GridSweep, {{4096}});
+
+    if (list) {
+        suite.forEachInstance(options, [](const std::string& name) { std::cout << name << "\n"; });
+        return 0;
+    }
+
+    std::random_device rd;
+    scratchDir() = std::filesystem::temp_directory_path() / ("trading_bench_" + std::to_string(rd()));
+    std::error_code ec;
+    std::filesystem::create_directories(scratchDir(), ec);
+    if (ec) {
+        ERROR("Could not create " << scratchDir().string() << ": " << ec.message());
+        return 1;
+    }
+
+    std::cout << "Compute backend " << Compute::name(Compute::cpu()) << " (host supports " << Compute::describe()
+              << ")\nValidating indicator backends...\n";
+    std::ostringstream validation;
+    if (!Indicators::Series::validate(BarView(barsOf(65536)), validation)) {
+        std::cout << validation.str();
+        ERROR("Indicator backends disagree with the reference kernels");
+        std::filesystem::remove_all(scratchDir(), ec);
+        return 1;
+    }
+    std::cout << "All backends identical to the reference kernels\n\n";
+
+    std::cout << "Synthetic random-walk bars, " << options.repetitions << " repetitions of at least "
+              << options.min_time << " s each\n\n";
+    NullBuffer null_buffer;
+    std::streambuf* console = std::cout.rdbuf();
+    std::ostream report(console);
+    std::cout.rdbuf(&null_buffer);
+    std::vector<Bench::Result> results = suite.run(options, report);
+    std::cout.rdbuf(console);
+
+    std::filesystem::remove_all(scratchDir(), ec);
+
+    if (!json_path.empty()) {
+        if (!Bench::writeJson(json_path, results, options)) {
+            ERROR("Could not write " << json_path);
+            return 1;
+        }
+        std::cout << "\nResults written to " << json_path << std::endl;
+    }
+    return 0;
+}
@@ -3,23 +3,47 @@
 #include <string>
 #include <map>
 #include "DataLoader.hpp"
+#include "BarView.hpp"
 #include "Strategy.hpp"
+#include "LatencyHistogram.hpp"
+
+// Totals of Backtester::runSignals
+struct TradeTotals {
+    double final_equity = 0.0;
+    int trades = 0;
+    int wins = 0;
+};
 
 class Backtester {
 public:
-    Backtester(const std::vector<OHLCV>& data, Strategy* strategy, double initial_equity = 1000.0);
+    Backtester(const BarView& data, Strategy* strategy, double initial_equity = 1000.0);
     void run();
+    // Per-bar and per-trade tracing to stdout; on by default. Turn it off
+    // when many backtests run at once (e.g. in parallel sweeps).
+    void setLogging(bool enabled) { logging_ = enabled; }
+    // Records per-bar signal/update latency into latency (not owned) during
+    // run(); nullptr (the default) turns the timers off. Turn logging off
+    // too: per-bar log lines are written inside the timed windows.
+    void setLatency(BarLatency* latency) { latency_ = latency; }
     void printYearlyPnL() const;
     void printTotalGain() const;
     const std::map<int, double>& getYearlyPnL() const { return yearly_pnl_; }
     double getFinalEquity() const { return equity_; }
     int getTotalTrades() const { return total_trades_; }
     double getWinRate() const { return total_trades_ > 0 ? (double)winning_trades_ / total_trades_ : 0.0; }
+
+    // run()'s sizing and fills over GoldenFoundation signals precomputed on
+    // flat close/high/low arrays of n bars, without logging, latency, yearly
+    // P&L or the equity curve. Real = float screens in float32 (equity stays
+    // double). Positions jump to their exit with findExit.
+    template <class Real>
+    static TradeTotals runSignals(const Real* close, const Real* high, const Real* low, size_t n,
+                                  const GoldenFoundationSignals<Real>& signals, double initial_equity);
 private:
     int calculateDaysInDataset() const;
     void calculateAdditionalMetrics() const;
     void addToYearlyPnL(const std::string& entry_date, double pnl);
-    const std::vector<OHLCV>& data_;
+    BarView data_;
     Strategy* strategy_;
     double initial_equity_;
     double equity_;
@@ -27,4 +51,6 @@ private:
     std::vector<double> equity_curve_;
     int total_trades_ = 0;
     int winning_trades_ = 0;
+    bool logging_ = true;
+    BarLatency* latency_ = nullptr;
 };
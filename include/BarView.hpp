@@ -0,0 +1,101 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <map>
+#include <iterator>
+#include <cstdint>
+#include <cstddef>
+#include "DataLoader.hpp"
+
+// Non-owning view over a sorted bar buffer. Slicing by index or date range
+// is O(log n) and copies nothing; filtered views (e.g. regular trading
+// hours) share one index list instead of copying bars. The underlying
+// buffer must outlive every view taken from it.
+class BarView {
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = OHLCV;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const OHLCV*;
+        using reference = const OHLCV&;
+
+        const_iterator(const BarView* view, size_t pos) : view_(view), pos_(pos) {}
+        reference operator*() const { return (*view_)[pos_]; }
+        pointer operator->() const { return &(*view_)[pos_]; }
+        const_iterator& operator++() { ++pos_; return *this; }
+        const_iterator operator++(int) { const_iterator tmp = *this; ++pos_; return tmp; }
+        const_iterator& operator--() { --pos_; return *this; }
+        const_iterator operator--(int) { const_iterator tmp = *this; --pos_; return tmp; }
+        const_iterator& operator+=(difference_type n) { pos_ += n; return *this; }
+        const_iterator& operator-=(difference_type n) { pos_ -= n; return *this; }
+        const_iterator operator+(difference_type n) const { return const_iterator(view_, pos_ + n); }
+        const_iterator operator-(difference_type n) const { return const_iterator(view_, pos_ - n); }
+        difference_type operator-(const const_iterator& o) const { return static_cast<difference_type>(pos_) - static_cast<difference_type>(o.pos_); }
+        reference operator[](difference_type n) const { return (*view_)[pos_ + n]; }
+        bool operator==(const const_iterator& o) const { return pos_ == o.pos_; }
+        bool operator!=(const const_iterator& o) const { return pos_ != o.pos_; }
+        bool operator<(const const_iterator& o) const { return pos_ < o.pos_; }
+        bool operator>(const const_iterator& o) const { return pos_ > o.pos_; }
+        bool operator<=(const const_iterator& o) const { return pos_ <= o.pos_; }
+        bool operator>=(const const_iterator& o) const { return pos_ >= o.pos_; }
+    private:
+        const BarView* view_;
+        size_t pos_;
+    };
+
+    BarView() = default;
+    BarView(const std::vector<OHLCV>& bars) : base_(bars.data()), size_(bars.size()) {}
+    BarView(std::vector<OHLCV>&&) = delete; // a view of a temporary would dangle
+    BarView(const OHLCV* bars, size_t count) : base_(bars), size_(count) {}
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const OHLCV& operator[](size_t i) const {
+        return index_ ? base_[(*index_)[offset_ + i]] : base_[i];
+    }
+    const OHLCV& front() const { return (*this)[0]; }
+    const OHLCV& back() const { return (*this)[size_ - 1]; }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size_); }
+
+    // True when the view is one contiguous run of the underlying buffer
+    bool isContiguous() const { return !index_; }
+    // Pointer to the first bar; only meaningful for contiguous views
+    const OHLCV* data() const { return index_ ? nullptr : base_; }
+
+    // Bars [begin, end) of this view
+    BarView slice(size_t begin, size_t end) const;
+
+    // First position whose timestamp is >= ts (size() if none)
+    size_t lowerBound(const std::string& ts) const;
+    // Position of the bar with exactly this timestamp, or size() if absent
+    size_t indexOf(const std::string& ts) const;
+
+    // Bars with from <= timestamp < to. Timestamps compare as strings, so
+    // "2021-01-01" .. "2022-01-01" selects calendar 2021.
+    BarView dateRange(const std::string& from, const std::string& to) const;
+
+    // Bars of one calendar year (UTC)
+    BarView year(int year) const;
+    // Every calendar year present, in order
+    std::map<int, BarView> years() const;
+
+    // Bars inside the US regular session (09:30-16:00 New York time)
+    BarView regularTradingHours() const;
+
+    // Splits at fraction of the bars, e.g. 0.7 -> {first 70%, last 30%}
+    std::pair<BarView, BarView> split(double fraction) const;
+
+    // Materializes the view when an owning copy is really needed
+    std::vector<OHLCV> toVector() const;
+
+private:
+    const OHLCV* base_ = nullptr;    // first bar (contiguous) or buffer start (indexed)
+    size_t size_ = 0;
+    size_t offset_ = 0;              // start inside index_ for indexed views
+    std::shared_ptr<const std::vector<uint32_t>> index_;
+};
@@ -0,0 +1,496 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <functional>
+#include <chrono>
+#include <regex>
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <cstdint>
+#include <cstddef>
+#include "TimeUtils.hpp"
+
+// Minimal microbenchmark harness in the style of Google Benchmark: a
+// benchmark is a function of a State whose range-for loop is the timed
+// region, registered with one or more argument lists (e.g. bar count and
+// indicator period). Each instance is warmed up, its iteration count is
+// calibrated to a minimum run time, and it is then timed over several
+// repetitions so results carry their own noise estimate.
+//
+//   void BM_SMA(Bench::State& state) {
+//       auto bars = ...;                   // setup, not timed
+//       for (auto _ : state) { ... }       // timed
+//       state.setItemsProcessed(state.iterations() * bars.size());
+//   }
+//   suite.add("Indicators::SMA", BM_SMA, {{4096, 50}, {65536, 50}});
+namespace Bench {
+
+    // Keeps value (and the work that produced it) from being optimized away
+    template <class T>
+    inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static const volatile void* sink;
+        sink = &value;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+    }
+
+    class State {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        State(const std::vector<int64_t>& args, size_t iterations) : args_(args), iterations_(iterations) {}
+
+        int64_t arg(size_t i) const { return i < args_.size() ? args_[i] : 0; }
+        size_t iterations() const { return iterations_; }
+
+        // Total work done by all iterations, reported as items per second
+        void setItemsProcessed(size_t items) { items_ = items; }
+        size_t itemsProcessed() const { return items_; }
+
+        // Excludes per-iteration setup from the timed region
+        void pauseTiming() { elapsed_ += Clock::now() - start_; }
+        void resumeTiming() { start_ = Clock::now(); }
+
+        double seconds() const { return std::chrono::duration<double>(elapsed_).count(); }
+
+        struct [[maybe_unused]] Value {};  // the loop variable of "for (auto _ : state)"
+        class Iterator {
+        public:
+            explicit Iterator(State* state) : state_(state), remaining_(state ? state->iterations_ : 0) {}
+            Value operator*() const { return {}; }
+            Iterator& operator++() {
+                if (--remaining_ == 0) state_->stop();
+                return *this;
+            }
+            bool operator!=(const Iterator&) const { return remaining_ != 0; }
+        private:
+            State* state_;
+            size_t remaining_;
+        };
+
+        Iterator begin() {
+            elapsed_ = Clock::duration::zero();
+            start_ = Clock::now();
+            return Iterator(this);
+        }
+        Iterator end() { return Iterator(nullptr); }
+
+    private:
+        void stop() { elapsed_ += Clock::now() - start_; }
+
+        std::vector<int64_t> args_;
+        size_t iterations_;
+        size_t items_ = 0;
+        Clock::time_point start_;
+        Clock::duration elapsed_ = Clock::duration::zero();
+    };
+
+    struct Options {
+        double min_time = 0.1;      // seconds each repetition runs for, at least
+        double warmup_time = 0.05;  // untimed seconds before calibration
+        size_t repetitions = 5;
+        std::string filter;         // regex matched against instance names; empty runs all
+        std::vector<int64_t> sizes; // replaces every instance's first argument when set
+        std::string backend;        // compute backend of the run, recorded in the JSON context
+    };
+
+    // Aggregates over repetitions of one instance, per iteration
+    struct Result {
+        std::string name;
+        std::vector<int64_t> args;
+        size_t iterations = 0;
+        std::vector<double> samples_ns;  // one per repetition
+        double mean_ns = 0.0;
+        double median_ns = 0.0;
+        double stddev_ns = 0.0;          // sample standard deviation
+        double min_ns = 0.0;
+        double max_ns = 0.0;
+        double cv = 0.0;                 // stddev / mean
+        double items_per_second = 0.0;   // from the mean
+    };
+
+    // "123.4 ns", "5678 us", "12.3 ms"
+    inline std::string formatTime(double ns) {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(ns < 1e4 ? 1 : 0);
+        if (ns < 1e4) oss << ns << " ns";
+        else if (ns < 1e7) oss << ns / 1e3 << " us";
+        else oss << std::setprecision(1) << ns / 1e6 << " ms";
+        return oss.str();
+    }
+
+    // Fills the aggregates of r from its samples
+    inline void summarize(Result& r) {
+        const std::vector<double>& s = r.samples_ns;
+        const double n = static_cast<double>(s.size());
+        r.mean_ns = std::accumulate(s.begin(), s.end(), 0.0) / n;
+        std::vector<double> sorted = s;
+        std::sort(sorted.begin(), sorted.end());
+        const size_t mid = sorted.size() / 2;
+        r.median_ns = sorted.size() % 2 ? sorted[mid] : 0.5 * (sorted[mid - 1] + sorted[mid]);
+        r.min_ns = sorted.front();
+        r.max_ns = sorted.back();
+        double ss = 0.0;
+        for (double v : s) ss += (v - r.mean_ns) * (v - r.mean_ns);
+        r.stddev_ns = s.size() > 1 ? std::sqrt(ss / (n - 1.0)) : 0.0;
+        r.cv = r.mean_ns > 0.0 ? r.stddev_ns / r.mean_ns : 0.0;
+    }
+
+    class Suite {
+    public:
+        using Function = std::function<void(State&)>;
+
+        // One instance per argument list; none gives a single argument-less instance
+        void add(const std::string& name, Function fn, std::vector<std::vector<int64_t>> args = {{}}) {
+            benchmarks_.push_back({name, std::move(fn), std::move(args)});
+        }
+
+        // Calls fn(name) for every instance that options select, in run order
+        void forEachInstance(const Options& options, const std::function<void(const std::string&)>& fn) const {
+            for (const auto& inst : instances(options)) fn(inst.name);
+        }
+
+        std::vector<Result> run(const Options& options, std::ostream& out = std::cout) const {
+            std::vector<Result> results;
+            out << std::left << std::setw(52) << "Benchmark" << std::right << std::setw(14) << "Mean"
+                << std::setw(14) << "Median" << std::setw(9) << "CV" << std::setw(12) << "Iterations"
+                << std::setw(14) << "Items/s" << "\n"
+                << std::string(115, '-') << "\n";
+            for (const auto& inst : instances(options)) {
+                Result result = runInstance(*inst.fn, inst.name, inst.args, options);
+                print(out, result);
+                results.push_back(std::move(result));
+            }
+            return results;
+        }
+
+        static std::string instanceName(const std::string& name, const std::vector<int64_t>& args) {
+            std::string full = name;
+            for (int64_t a : args) full += "/" + std::to_string(a);
+            return full;
+        }
+
+    private:
+        struct Entry {
+            std::string name;
+            Function fn;
+            std::vector<std::vector<int64_t>> args;
+        };
+
+        struct Instance {
+            const Function* fn;
+            std::string name;
+            std::vector<int64_t> args;
+        };
+
+        std::vector<Instance> instances(const Options& options) const {
+            std::vector<Instance> selected;
+            const std::regex filter(options.filter.empty() ? std::string(".*") : options.filter);
+            for (const auto& bench : benchmarks_) {
+                std::vector<std::vector<int64_t>> arg_lists;
+                for (auto args : bench.args) {
+                    if (!options.sizes.empty() && !args.empty()) {
+                        for (int64_t size : options.sizes) {
+                            args[0] = size;
+                            if (std::find(arg_lists.begin(), arg_lists.end(), args) == arg_lists.end()) {
+                                arg_lists.push_back(args);
+                            }
+                        }
+                    } else {
+                        arg_lists.push_back(args);
+                    }
+                }
+                for (const auto& args : arg_lists) {
+                    std::string name = instanceName(bench.name, args);
+                    if (std::regex_search(name, filter)) selected.push_back({&bench.fn, std::move(name), args});
+                }
+            }
+            return selected;
+        }
+
+        static double timedRun(const Function& fn, const std::vector<int64_t>& args, size_t iterations,
+                               size_t& items) {
+            State state(args, iterations);
+            fn(state);
+            items = state.itemsProcessed();
+            return state.seconds();
+        }
+
+        static Result runInstance(const Function& fn, const std::string& name, const std::vector<int64_t>& args,
+                                  const Options& options) {
+            size_t items = 0;
+
+            // Warm caches, page in the data and settle the clock frequency
+            double warm = 0.0;
+            do {
+                warm += timedRun(fn, args, 1, items);
+            } while (warm < options.warmup_time);
+
+            // Grow the iteration count until one run lasts min_time
+            size_t iterations = 1;
+            for (;;) {
+                double seconds = timedRun(fn, args, iterations, items);
+                if (seconds >= options.min_time || iterations >= 1000000000) break;
+                double factor = seconds > 0.0 ? options.min_time * 1.4 / seconds : 10.0;
+                iterations = static_cast<size_t>(iterations * std::clamp(factor, 2.0, 10.0));
+            }
+
+            Result result;
+            result.name = name;
+            result.args = args;
+            result.iterations = iterations;
+            double items_total = 0.0;
+            for (size_t r = 0; r < std::max<size_t>(options.repetitions, 1); ++r) {
+                double seconds = timedRun(fn, args, iterations, items);
+                result.samples_ns.push_back(seconds * 1e9 / iterations);
+                items_total += static_cast<double>(items);
+            }
+            summarize(result);
+            if (items_total > 0.0) {
+                const double reps = static_cast<double>(result.samples_ns.size());
+                result.items_per_second = (items_total / reps / iterations) / (result.mean_ns * 1e-9);
+            }
+            return result;
+        }
+
+        static void print(std::ostream& out, const Result& r) {
+            std::ostringstream cv, items;
+            cv << std::fixed << std::setprecision(2) << 100.0 * r.cv << "%";
+            if (r.items_per_second > 0.0) items << std::scientific << std::setprecision(3) << r.items_per_second;
+            out << std::left << std::setw(52) << r.name << std::right << std::setw(14) << formatTime(r.mean_ns)
+                << std::setw(14) << formatTime(r.median_ns) << std::setw(9) << cv.str() << std::setw(12) << r.iterations
+                << std::setw(14) << items.str() << std::endl;
+        }
+
+        std::vector<Entry> benchmarks_;
+    };
+
+    inline std::string jsonEscape(const std::string& s) {
+        std::string out;
+        for (char c : s) {
+            if (c == '"' || c == '\\') out += '\\';
+            if (static_cast<unsigned char>(c) < 0x20) continue;
+            out += c;
+        }
+        return out;
+    }
+
+    // Writes results as {"context": {...}, "benchmarks": [...]}, one object
+    // per instance with its aggregates and raw per-repetition samples
+    inline bool writeJson(const std::string& path, const std::vector<Result>& results, const Options& options) {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out) return false;
+        out << std::setprecision(10);
+        out << "{\n  \"context\": {\n"
+            << "    \"date\": \"" << TimeUtils::formatTimestamp(static_cast<int64_t>(std::time(nullptr))) << "\",\n"
+            << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#if defined(__VERSION__)
+            << "    \"compiler\": \"" << jsonEscape(__VERSION__) << "\",\n"
+#elif defined(_MSC_VER)
+            << "    \"compiler\": \"MSVC " << _MSC_VER << "\",\n"
+#endif
+#if defined(NDEBUG)
+            << "    \"build_type\": \"release\",\n"
+#else
+            << "    \"build_type\": \"debug\",\n"
+#endif
+            << (options.backend.empty() ? std::string() : "    \"backend\": \"" + jsonEscape(options.backend) + "\",\n")
+            << "    \"min_time_s\": " << options.min_time << ",\n"
+            << "    \"repetitions\": " << options.repetitions << "\n"
+            << "  },\n  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            out << (i ? ",\n" : "\n") << "    {\"name\": \"" << jsonEscape(r.name) << "\", \"args\": [";
+            for (size_t a = 0; a < r.args.size(); ++a) out << (a ? ", " : "") << r.args[a];
+            out << "], \"iterations\": " << r.iterations
+                << ", \"repetitions\": " << r.samples_ns.size()
+                << ", \"mean_ns\": " << r.mean_ns
+                << ", \"median_ns\": " << r.median_ns
+                << ", \"stddev_ns\": " << r.stddev_ns
+                << ", \"min_ns\": " << r.min_ns
+                << ", \"max_ns\": " << r.max_ns
+                << ", \"cv\": " << r.cv
+                << ", \"items_per_second\": " << r.items_per_second
+                << ", \"samples_ns\": [";
+            for (size_t k = 0; k < r.samples_ns.size(); ++k) out << (k ? ", " : "") << r.samples_ns[k];
+            out << "]}";
+        }
+        out << "\n  ]\n}\n";
+        return out.good();
+    }
+
+    // Just enough JSON to read writeJson output back: objects, arrays,
+    // strings without unicode escapes, numbers, true/false/null
+    struct JsonValue {
+        enum class Type { Null, Bool, Number, String, Array, Object };
+        Type type = Type::Null;
+        double number = 0.0;
+        std::string string;
+        std::vector<JsonValue> items;
+        std::vector<std::pair<std::string, JsonValue>> fields;
+
+        const JsonValue* get(const std::string& key) const {
+            for (const auto& f : fields) {
+                if (f.first == key) return &f.second;
+            }
+            return nullptr;
+        }
+    };
+
+    class JsonParser {
+    public:
+        explicit JsonParser(const std::string& text) : text_(text) {}
+
+        bool parse(JsonValue& value) {
+            if (!parseValue(value, 0)) return false;
+            skipSpace();
+            return pos_ == text_.size();
+        }
+
+    private:
+        void skipSpace() {
+            while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) ++pos_;
+        }
+
+        bool consume(char c) {
+            skipSpace();
+            if (pos_ < text_.size() && text_[pos_] == c) {
+                ++pos_;
+                return true;
+            }
+            return false;
+        }
+
+        bool parseString(std::string& out) {
+            if (!consume('"')) return false;
+            out.clear();
+            while (pos_ < text_.size() && text_[pos_] != '"') {
+                char c = text_[pos_++];
+                if (c == '\\' && pos_ < text_.size()) {
+                    char e = text_[pos_++];
+                    c = e == 'n' ? '\n' : e == 't' ? '\t' : e;
+                }
+                out += c;
+            }
+            return pos_++ < text_.size();
+        }
+
+        bool parseValue(JsonValue& value, int depth) {
+            if (depth > 64) return false;
+            skipSpace();
+            if (pos_ >= text_.size()) return false;
+            const char c = text_[pos_];
+            if (c == '{') {
+                ++pos_;
+                value.type = JsonValue::Type::Object;
+                if (consume('}')) return true;
+                do {
+                    std::pair<std::string, JsonValue> field;
+                    if (!parseString(field.first) || !consume(':') || !parseValue(field.second, depth + 1)) return false;
+                    value.fields.push_back(std::move(field));
+                } while (consume(','));
+                return consume('}');
+            }
+            if (c == '[') {
+                ++pos_;
+                value.type = JsonValue::Type::Array;
+                if (consume(']')) return true;
+                do {
+                    value.items.emplace_back();
+                    if (!parseValue(value.items.back(), depth + 1)) return false;
+                } while (consume(','));
+                return consume(']');
+            }
+            if (c == '"') {
+                value.type = JsonValue::Type::String;
+                return parseString(value.string);
+            }
+            for (const char* word : {"true", "false", "null"}) {
+                if (text_.compare(pos_, std::strlen(word), word) == 0) {
+                    pos_ += std::strlen(word);
+                    value.type = word[0] == 'n' ? JsonValue::Type::Null : JsonValue::Type::Bool;
+                    value.number = word[0] == 't' ? 1.0 : 0.0;
+                    return true;
+                }
+            }
+            const char* begin = text_.c_str() + pos_;
+            char* end = nullptr;
+            value.number = std::strtod(begin, &end);
+            if (end == begin) return false;
+            value.type = JsonValue::Type::Number;
+            pos_ += static_cast<size_t>(end - begin);
+            return true;
+        }
+
+        const std::string& text_;
+        size_t pos_ = 0;
+    };
+
+    // Reads a writeJson file. Aggregates are recomputed from the samples
+    // when present, so hand-trimmed files stay consistent.
+    inline bool readJson(const std::string& path, std::vector<Result>& results, std::string& error) {
+        std::ifstream in(path);
+        if (!in) {
+            error = "cannot open " + path;
+            return false;
+        }
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        const std::string text = buffer.str();
+        JsonValue root;
+        if (!JsonParser(text).parse(root)) {
+            error = path + " is not valid JSON";
+            return false;
+        }
+        const JsonValue* list = root.get("benchmarks");
+        if (!list || list->type != JsonValue::Type::Array) {
+            error = path + " has no \"benchmarks\" array";
+            return false;
+        }
+        results.clear();
+        for (const JsonValue& item : list->items) {
+            const JsonValue* name = item.get("name");
+            if (!name || name->type != JsonValue::Type::String) continue;
+            Result r;
+            r.name = name->string;
+            auto number = [&](const char* key) {
+                const JsonValue* v = item.get(key);
+                return v && v->type == JsonValue::Type::Number ? v->number : 0.0;
+            };
+            if (const JsonValue* args = item.get("args")) {
+                for (const JsonValue& a : args->items) r.args.push_back(static_cast<int64_t>(a.number));
+            }
+            r.iterations = static_cast<size_t>(number("iterations"));
+            r.items_per_second = number("items_per_second");
+            if (const JsonValue* samples = item.get("samples_ns")) {
+                for (const JsonValue& v : samples->items) r.samples_ns.push_back(v.number);
+            }
+            if (!r.samples_ns.empty()) {
+                summarize(r);
+            } else {
+                r.mean_ns = number("mean_ns");
+                r.median_ns = number("median_ns");
+                r.stddev_ns = number("stddev_ns");
+                r.min_ns = number("min_ns");
+                r.max_ns = number("max_ns");
+                r.cv = number("cv");
+            }
+            results.push_back(std::move(r));
+        }
+        return true;
+    }
+}
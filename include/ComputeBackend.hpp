@@ -0,0 +1,56 @@
+#pragma once
+#include <string>
+
+// Compute backends for the indicator and backtest kernels. Binaries are
+// built for the baseline ISA; kernels for wider vector units are compiled
+// with per-function target attributes (COMPUTE_TARGET_*) and picked at run
+// time from cpuid, so one binary runs on any x86-64 host and uses the widest
+// unit it has. Cuda is the GPU: reached through the CUDA entry points
+// (PopulationEvaluator, GPUStrategy), never by the CPU kernels.
+enum class ComputeBackend { Scalar, Avx2, Avx512, Cuda };
+
+// Arithmetic precision of a fitness evaluation. Float32 runs bars,
+// indicators and backtest state in float: twice the values per vector and
+// half the memory traffic, for screening many candidates whose finalists
+// are re-scored in Float64 (ScreeningReport.hpp).
+enum class Precision { Float64, Float32 };
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define COMPUTE_X86 1
+#endif
+
+// MSVC compiles intrinsics without arch flags; GCC and Clang need the
+// function's target to include the instruction set. FMA is left out so the
+// compiler cannot contract a * b + c differently from the scalar kernels.
+#if defined(COMPUTE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define COMPUTE_TARGET_AVX2 __attribute__((target("avx2,bmi,bmi2")))
+#define COMPUTE_TARGET_AVX512 __attribute__((target("avx512f,avx512dq,avx512vl,avx512bw,avx2,bmi,bmi2")))
+#else
+#define COMPUTE_TARGET_AVX2
+#define COMPUTE_TARGET_AVX512
+#endif
+
+namespace Compute {
+    // This build and host can run backend: cpuid feature bits plus OS support
+    // for the register state (XCR0); Cuda in builds with USE_CUDA
+    bool supported(ComputeBackend backend);
+
+    // CPU backend the kernels dispatch on: the widest supported one, or the
+    // override from select() or the TRADING_BACKEND environment variable.
+    // Detected once; cheap to call per kernel invocation.
+    ComputeBackend cpu();
+
+    // Overrides cpu() for the whole process (benchmarking, A/B runs). Fails
+    // for Cuda and for backends the host cannot run.
+    bool select(ComputeBackend backend);
+
+    const char* name(ComputeBackend backend);
+    // "scalar", "avx2", "avx512" or "cuda"
+    bool parse(const std::string& name, ComputeBackend& out);
+
+    // Supported backends, in order, e.g. "scalar avx2 avx512"
+    std::string describe();
+
+    // "float64" or "float32"
+    const char* name(Precision precision);
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "DataLoader.hpp"
+
+// On-disk bar record used by the sharded store (fixed size, little endian)
+struct BarRecord {
+    int64_t time;   // epoch seconds, UTC
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+};
+static_assert(sizeof(BarRecord) == 48, "BarRecord layout must stay fixed");
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return data_ != nullptr; }
+    const unsigned char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const unsigned char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_handle_ = nullptr;
+    void* mapping_handle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+// One row of the store index: a single symbol-month shard
+struct ShardInfo {
+    std::string symbol;
+    int year_month = 0;        // e.g. 202403
+    std::string file;          // path relative to the store root
+    int64_t first_time = 0;
+    int64_t last_time = 0;
+    uint64_t rows = 0;
+    uint64_t byte_offset = 0;  // offset of the first record in the file
+    uint64_t byte_length = 0;  // rows * sizeof(BarRecord)
+};
+
+// Contiguous run of records inside a mapped shard. Holds the mapping alive.
+struct BarSlice {
+    std::shared_ptr<MappedFile> file;
+    const BarRecord* records = nullptr;
+    size_t count = 0;
+
+    const BarRecord* begin() const { return records; }
+    const BarRecord* end() const { return records + count; }
+};
+
+// Directory-based bar store: one binary shard per symbol per month
+//
+//   <root>/index.csv              symbol,month,file,first,last,rows,offset,length
+//   <root>/<SYMBOL>/<YYYY-MM>.bars
+//
+// Queries read only the index and map only the shards that intersect the
+// requested range; records outside the range are skipped by binary search,
+// so untouched pages are never read from disk.
+class DataStore {
+public:
+    // Opens an existing store (an empty or missing index gives an empty store)
+    explicit DataStore(const std::string& root);
+
+    // Writes bars for one symbol into monthly shards and updates the index.
+    // Months present in bars replace any existing shard for that month.
+    static bool ingest(const std::string& root, const std::string& symbol, const std::vector<OHLCV>& bars);
+
+    const std::string& root() const { return root_; }
+    const std::vector<ShardInfo>& shards() const { return shards_; }
+    std::vector<std::string> symbols() const;
+
+    // Index rows for symbol intersecting [from, to] (epoch seconds, inclusive)
+    std::vector<ShardInfo> shardsFor(const std::string& symbol, int64_t from, int64_t to) const;
+
+    // Memory-maps the intersecting shards and returns the records in range
+    std::vector<BarSlice> map(const std::string& symbol, int64_t from, int64_t to) const;
+
+    // Convenience: copies the mapped range into OHLCV bars
+    std::vector<OHLCV> load(const std::string& symbol, int64_t from, int64_t to) const;
+
+private:
+    bool readIndex();
+
+    std::string root_;
+    std::vector<ShardInfo> shards_; // sorted by (symbol, year_month)
+};
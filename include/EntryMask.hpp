@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "GeneticStrategy.hpp"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Whole-series entry conditions as packed bitmasks: bit i of word i / 64 is
+// set when an EvolvedStrategy gene would enter at bar i. Masks are built in
+// one vectorized pass over the precomputed indicator series; the backtest
+// then visits only the set bits instead of testing every bar.
+namespace EntryMask {
+    using Word = uint64_t;
+
+    inline size_t wordsFor(size_t bars) { return (bars + 63) / 64; }
+
+    inline unsigned countTrailingZeros(Word w) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, w);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctzll(w)); // tzcnt with -mbmi
+#endif
+    }
+
+    // Writes wordsFor(n) words. Bars before warmup never enter.
+    // CROSS_ABOVE / CROSS_BELOW: primary crosses primary_threshold
+    // ABOVE / BELOW: primary and secondary both beyond their thresholds
+    // INSIDE_BB / OUTSIDE_BB: no band series is computed for genes, so
+    // these never enter (same as the per-bar evaluation they replace)
+    void build(StrategyGene::EntryCondition condition,
+               const double* primary, const double* secondary, size_t n,
+               double primary_threshold, double secondary_threshold,
+               size_t warmup, Word* out);
+    // float32 series (Precision::Float32); thresholds are compared in float
+    void build(StrategyGene::EntryCondition condition,
+               const float* primary, const float* secondary, size_t n,
+               float primary_threshold, float secondary_threshold,
+               size_t warmup, Word* out);
+
+    inline bool test(const Word* mask, size_t i) {
+        return (mask[i >> 6] >> (i & 63)) & 1;
+    }
+
+    // Calls fn(i) for every set bit, in increasing order
+    template <class Fn>
+    void forEachSetBit(const Word* mask, size_t words, Fn&& fn) {
+        for (size_t w = 0; w < words; ++w) {
+            Word bits = mask[w];
+            while (bits) {
+                fn(w * 64 + countTrailingZeros(bits));
+                bits &= bits - 1;
+            }
+        }
+    }
+}
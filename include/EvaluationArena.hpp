@@ -0,0 +1,43 @@
+#pragma once
+#include <memory_resource>
+#include <memory>
+#include <optional>
+#include <cstddef>
+
+// Per-thread scratch memory for fitness evaluations. Buffers built during one
+// evaluation (indicator series and their temporaries) are bump-allocated from
+// a block sized from the dataset length and dropped together by reset(), so a
+// GA run does a handful of mallocs per thread instead of several per
+// individual. Requests beyond the block fall back to the heap.
+class EvaluationArena {
+public:
+    // Arena of the calling thread, grown to hold at least bytes
+    static EvaluationArena& forThread(size_t bytes);
+
+    // Scratch bytes one evaluation over `bars` bars needs without spilling
+    static size_t bytesFor(size_t bars);
+
+    // Disabling routes every request to the heap (for allocation counts and
+    // sanitizer runs); applies to arenas handed out afterwards
+    static void setEnabled(bool enabled);
+    static bool enabled();
+
+    EvaluationArena(const EvaluationArena&) = delete;
+    EvaluationArena& operator=(const EvaluationArena&) = delete;
+
+    std::pmr::memory_resource* resource();
+
+    // Releases everything allocated since the last reset. Nothing allocated
+    // from the arena may still be alive.
+    void reset();
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    EvaluationArena() = default;
+    void reserve(size_t bytes);
+
+    std::unique_ptr<std::byte[]> buffer_;
+    size_t capacity_ = 0;
+    std::optional<std::pmr::monotonic_buffer_resource> resource_;
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include <string>
+#include <deque>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+#include <limits>
+
+// One row of per-generation GA telemetry
+struct GenerationStats {
+    int generation = 0;
+    double best_fitness = 0.0;
+    double mean_fitness = 0.0;
+    double median_fitness = 0.0;
+    double diversity = 0.0;        // distinct genes / population size
+    size_t backtests = 0;          // fitness evaluations actually run
+    size_t pruned = 0;             // backtests stopped early by racing
+    size_t bars_run = 0;           // bars those backtests covered
+    double bars_saved = 0.0;       // share of their bars racing skipped
+    double backtests_per_sec = 0.0;
+    double bars_per_sec = 0.0;
+    size_t cache_hits = 0;
+    size_t cache_misses = 0;
+    double evaluate_ms = 0.0;
+    double select_ms = 0.0;
+    double crossover_ms = 0.0;
+    double mutate_ms = 0.0;
+};
+
+// Appends GenerationStats rows to a CSV file from a background thread, so a
+// slow disk never stalls evolution: record() only queues the row. Rows are
+// flushed as they are written; the destructor drains the queue.
+class EvolutionTelemetry {
+public:
+    // append keeps the rows of an earlier (resumed) run up to generation
+    // keep_through; later rows are dropped, as the resumed run writes them again
+    explicit EvolutionTelemetry(const std::string& path, bool append = false,
+                                int keep_through = std::numeric_limits<int>::max());
+    ~EvolutionTelemetry();
+
+    EvolutionTelemetry(const EvolutionTelemetry&) = delete;
+    EvolutionTelemetry& operator=(const EvolutionTelemetry&) = delete;
+
+    bool isOpen() const { return open_; }
+
+    void record(const GenerationStats& stats);
+
+private:
+    void writerLoop();
+
+    std::ofstream out_;
+    bool open_ = false;
+    std::deque<GenerationStats> queue_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread writer_;
+};
@@ -3,6 +3,15 @@
 #include <vector>
 #include <filesystem>
 #include <iostream>
+#include <fstream>
+#include <system_error>
+#include <cstdio>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 namespace FileUtils {
     inline std::string findDataFile(const std::string& filename) {
@@ -26,4 +35,58 @@ namespace FileUtils {
         // If not found, return the original path for error reporting
         return filename;
     }
+
+    // Writes to a temporary file, flushes it to disk and renames it over the
+    // target (then flushes the directory entry on POSIX), so readers, a
+    // crash or a power loss mid-write never leave a half-written file behind.
+    inline bool atomicWrite(const std::filesystem::path& target, const std::string& bytes) {
+        std::filesystem::path tmp = target;
+        tmp += ".tmp";
+        std::FILE* out = std::fopen(tmp.string().c_str(), "wb");
+        if (!out) return false;
+        bool ok = std::fwrite(bytes.data(), 1, bytes.size(), out) == bytes.size() && std::fflush(out) == 0;
+#ifdef _WIN32
+        ok = ok && _commit(_fileno(out)) == 0;
+#else
+        ok = ok && ::fsync(fileno(out)) == 0;
+#endif
+        ok = std::fclose(out) == 0 && ok;
+        if (!ok) {
+            std::cerr << "[ERROR] Could not write " << tmp.string() << std::endl;
+            return false;
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp, target, ec);
+        if (ec) {
+            std::cerr << "[ERROR] Could not rename " << tmp.string() << " -> " << target.string() << ": " << ec.message() << std::endl;
+            return false;
+        }
+#ifndef _WIN32
+        // The rename itself is durable only once the directory is flushed
+        std::filesystem::path dir = target.parent_path();
+        if (dir.empty()) dir = ".";
+        int fd = ::open(dir.string().c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd >= 0) {
+            ::fsync(fd);
+            ::close(fd);
+        }
+#endif
+        return true;
+    }
+
+    // Appends bytes to target (created if missing) and flushes them to disk.
+    // A failed append may leave part of bytes behind.
+    inline bool durableAppend(const std::filesystem::path& target, const std::string& bytes) {
+        std::FILE* out = std::fopen(target.string().c_str(), "ab");
+        if (!out) return false;
+        bool ok = std::fwrite(bytes.data(), 1, bytes.size(), out) == bytes.size() && std::fflush(out) == 0;
+#ifdef _WIN32
+        ok = ok && _commit(_fileno(out)) == 0;
+#else
+        ok = ok && ::fsync(fileno(out)) == 0;
+#endif
+        ok = std::fclose(out) == 0 && ok;
+        if (!ok) std::cerr << "[ERROR] Could not append to " << target.string() << std::endl;
+        return ok;
+    }
 } 
\ No newline at end of file
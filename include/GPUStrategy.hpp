@@ -10,8 +10,10 @@ extern "C" {
         int sma_period, int rsi_period
     );
     
+    // FVG needs the bar ranges, so highs and lows are passed with the closes
     void gpu_generate_signals(
-        const double* prices, const double* sma, const double* rsi,
+        const double* prices, const double* highs, const double* lows,
+        const double* sma, const double* rsi,
         int n, double rsi_oversold, double risk_reward,
         int* signals, double* stops, double* targets
     );
@@ -22,10 +24,10 @@ public:
     GPUGoldenFoundationStrategy(double risk_reward = 3.0);
     ~GPUGoldenFoundationStrategy();
     
-    TradeSignal generateSignal(const std::vector<OHLCV>& data, size_t current_index) override;
+    TradeSignal generateSignal(const BarView& data, size_t current_index) override;
     
     // Pre-calculate all indicators and signals for the entire dataset
-    void precomputeSignals(const std::vector<OHLCV>& data);
+    void precomputeSignals(const BarView& data);
     
 private:
     double risk_reward_;
@@ -0,0 +1,117 @@
+#pragma once
+#include <vector>
+#include <array>
+#include <memory_resource>
+#include <utility>
+#include <cmath>
+#include "GeneticStrategy.hpp"
+#include "BarView.hpp"
+#include "Resampler.hpp"
+#include "ComputeBackend.hpp"
+
+// Fitness evaluation specialized at compile time. Every (entry, exit)
+// combination gets its own instantiation of the backtest loop with the
+// indicator, entry and exit kernels inlined; a gene is dispatched once, through a
+// function-pointer table, instead of switching inside per-bar loops.
+// Results are identical to the EvolvedStrategy path
+// (GeneticAlgorithm::evaluateFitnessGeneric).
+//
+// A Float32 evaluator runs the same rules on float copies of the bars:
+// indicator series, entry masks, stops, targets, exit scans and trade returns
+// are all float (equity and the streaming metrics still accumulate in
+// double). It is for screening: its scores approximate the Float64 ones and
+// are checked against them with ScreeningReport.
+class GeneEvaluator {
+public:
+    // Early stopping for racing (GeneticAlgorithm::setRacing): the backtest
+    // runs in `blocks` time blocks and stops at a block boundary once an upper
+    // bound on the gene's final fitness score falls below threshold
+    struct RaceLimit {
+        double threshold = -HUGE_VAL;
+        size_t blocks = 8;
+    };
+
+    struct RaceOutcome {
+        bool pruned = false;
+        size_t bars = 0;  // bars backtested; size() unless pruned
+    };
+
+    // Indicator series of a gene's legs computed by the caller (see
+    // indicatorSeries), e.g. once for every gene of a batch that shares them;
+    // a null leg is computed by the evaluation itself. Float32 evaluators
+    // read the _f32 pointers.
+    struct Legs {
+        const double* primary = nullptr;
+        const double* secondary = nullptr;
+        const float* primary_f32 = nullptr;
+        const float* secondary_f32 = nullptr;
+    };
+
+    using EvaluateFn = FitnessResult (*)(const GeneEvaluator&, const StrategyGene&, const RaceLimit*, RaceOutcome*,
+                                         const Legs*);
+
+    static constexpr size_t kEntryCount = 6;  // StrategyGene::EntryCondition values
+    static constexpr size_t kExitCount = 4;   // StrategyGene::ExitCondition values
+
+    // Copies close/high/low of data (and of every pyramid level) into flat
+    // arrays of the given precision once; the bars themselves are not copied.
+    // An unbuilt pyramid is enough when every leg is M1.
+    GeneEvaluator(const BarView& data, const TimeframePyramid& pyramid,
+                  Precision precision = Precision::Float64);
+
+    // With a limit, a pruned gene returns the metrics of the bars it ran
+    // and its fitness bound as fitness_score (which is below the threshold)
+    FitnessResult evaluate(const StrategyGene& gene, const RaceLimit* limit = nullptr,
+                           RaceOutcome* outcome = nullptr, const Legs* legs = nullptr) const {
+        return select(gene, precision_)(*this, gene, limit, outcome, legs);
+    }
+
+    // Specialized function for the gene's (entry, exit) pair
+    static EvaluateFn select(const StrategyGene& gene, Precision precision = Precision::Float64);
+
+    // Whether the gene's (entry, exit) pair reads each leg; unused legs are
+    // never computed
+    static bool usesPrimary(const StrategyGene& gene);
+    static bool usesSecondary(const StrategyGene& gene);
+
+    // Indicator series of a gene leg, aligned to the base bars; out must
+    // hold size() values. The float overload is for Float32 evaluators.
+    void indicatorSeries(StrategyGene::IndicatorType type, int period, Timeframe tf, double* out,
+                         std::pmr::memory_resource* scratch) const;
+    void indicatorSeries(StrategyGene::IndicatorType type, int period, Timeframe tf, float* out,
+                         std::pmr::memory_resource* scratch) const;
+
+    Precision precision() const { return precision_; }
+    size_t size() const { return precision_ == Precision::Float32 ? f32_.close.size() : f64_.close.size(); }
+
+private:
+    // Flat price arrays in one precision
+    template <class Real>
+    struct Prices {
+        std::vector<Real> close;
+        std::vector<Real> high;
+        std::vector<Real> low;
+        std::vector<Real> later_high;  // highest high after each bar (racing bounds)
+        std::array<std::vector<Real>, kTimeframeCount> level_close;
+    };
+
+    template <class Real>
+    const Prices<Real>& prices() const;
+
+    template <class Real>
+    void series(StrategyGene::IndicatorType type, int period, Timeframe tf, Real* out,
+                std::pmr::memory_resource* scratch) const;
+
+    template <class Real, StrategyGene::EntryCondition Entry, StrategyGene::ExitCondition Exit>
+    static FitnessResult run(const GeneEvaluator& self, const StrategyGene& gene,
+                             const RaceLimit* limit, RaceOutcome* outcome, const Legs* legs);
+
+    // run<> for every (entry, exit) pair, indexed entry * kExitCount + exit
+    template <class Real, size_t... I>
+    static std::array<EvaluateFn, sizeof...(I)> makeTable(std::index_sequence<I...>);
+
+    const TimeframePyramid& pyramid_;
+    Precision precision_;
+    Prices<double> f64_;  // Float64 evaluators
+    Prices<float> f32_;   // Float32 evaluators
+};
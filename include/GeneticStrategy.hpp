@@ -2,9 +2,20 @@
 #include <vector>
 #include <random>
 #include <memory>
+#include <memory_resource>
 #include <string>
+#include <cstdint>
+#include <limits>
+#include <deque>
+#include <unordered_map>
 #include "Strategy.hpp"
 #include "DataLoader.hpp"
+#include "BarView.hpp"
+#include "Resampler.hpp"
+#include "RandomStream.hpp"
+#include "PopulationEvaluator.hpp"
+#include "ComputeBackend.hpp"
+#include "ScreeningReport.hpp"
 
 // Represents a single trading strategy's parameters
 struct StrategyGene {
@@ -18,7 +29,7 @@ struct StrategyGene {
         CROSS_ABOVE, CROSS_BELOW, ABOVE, BELOW, INSIDE_BB, OUTSIDE_BB
     };
     
-    // Exit conditions
+    // Exit conditions (see GeneExit in PositionEngine.hpp)
     enum class ExitCondition {
         FIXED_RR, TRAILING_STOP, TIME_BASED, INDICATOR_SIGNAL
     };
@@ -32,11 +43,15 @@ struct StrategyGene {
     double secondary_threshold = 30.0;
     EntryCondition entry_condition = EntryCondition::CROSS_ABOVE;
     ExitCondition exit_condition = ExitCondition::FIXED_RR;
-    double risk_reward_ratio = 2.5;
-    double stop_loss_pct = 0.045;
-    double take_profit_pct = 0.04;
-    int max_hold_time = 24;
+    double risk_reward_ratio = 2.5;   // FIXED_RR target, in multiples of the stop distance
+    double stop_loss_pct = 0.045;     // also the TRAILING_STOP trail distance
+    double take_profit_pct = 0.04;    // TIME_BASED / INDICATOR_SIGNAL target
+    int max_hold_time = 24;           // TIME_BASED, hours
     double position_size_pct = 0.25;
+    // Timeframe each indicator is computed on (values come from the last
+    // bar of that timeframe that closed before the current 1m bar)
+    Timeframe primary_timeframe = Timeframe::M1;
+    Timeframe secondary_timeframe = Timeframe::M1;
     
     // Fitness score
     double fitness = 0.0;
@@ -47,13 +62,13 @@ struct StrategyGene {
     StrategyGene& operator=(const StrategyGene& other) = default;
     
     // Generate random strategy
-    static StrategyGene random(std::mt19937& rng);
+    static StrategyGene random(RandomStream& rng);
     
     // Mutate this strategy
-    void mutate(std::mt19937& rng, double mutation_rate = 0.1);
+    void mutate(RandomStream& rng, double mutation_rate = 0.1);
     
     // Crossover with another strategy
-    StrategyGene crossover(const StrategyGene& other, std::mt19937& rng) const;
+    StrategyGene crossover(const StrategyGene& other, RandomStream& rng) const;
     
     // Convert to string for debugging
     std::string toString() const;
@@ -62,6 +77,12 @@ struct StrategyGene {
     std::string toPineScript() const;
 };
 
+class StreamingMetrics;
+class GeneEvaluator;
+class ThreadPool;
+class EvolutionTelemetry;
+struct GenerationStats;
+
 // Fitness evaluation results
 struct FitnessResult {
     double total_return = 0.0;
@@ -76,31 +97,111 @@ struct FitnessResult {
     double fitness_score = 0.0;
     
     std::string toString() const;
+
+    // Fills every field (including the combined score) from a finished run
+    static FitnessResult fromMetrics(const StreamingMetrics& metrics);
 };
 
 // Genetic Algorithm for strategy evolution
 class GeneticAlgorithm {
 public:
-    GeneticAlgorithm(const std::vector<OHLCV>& data, 
+    // data is not copied; the bars it views must outlive the GA. Every
+    // random draw derives from seed (see RandomStream), so a seed reproduces
+    // a run exactly at any thread count; threads == 0 uses all cores.
+    GeneticAlgorithm(const BarView& data, 
                      int population_size = 50,
                      int generations = 100,
                      double mutation_rate = 0.1,
-                     double crossover_rate = 0.8);
+                     double crossover_rate = 0.8,
+                     uint64_t seed = randomSeed(),
+                     size_t threads = 0);
+    ~GeneticAlgorithm();
+
+    GeneticAlgorithm(const GeneticAlgorithm&) = delete;
+    GeneticAlgorithm& operator=(const GeneticAlgorithm&) = delete;
     
     // Run the genetic algorithm
     std::vector<StrategyGene> evolve();
     
-    // Evaluate fitness of a single strategy
+    // Evaluate fitness of a single strategy (compile-time specialized path)
     FitnessResult evaluateFitness(const StrategyGene& gene);
+
+    // Same result through EvolvedStrategy::generateSignal; kept as the
+    // reference the specialized evaluators are checked and benchmarked against
+    FitnessResult evaluateFitnessGeneric(const StrategyGene& gene);
     
     // Get the best strategy found
     StrategyGene getBestStrategy() const;
     
     // Export best strategy to Pine Script
     std::string exportBestToPineScript() const;
+
+    uint64_t seed() const { return seed_; }
+
+    // Nondeterministic seed, for runs that do not ask for one
+    static uint64_t randomSeed();
+
+    // Snapshot the whole run state to path after every `every` generations.
+    // Snapshots are written to path.tmp and renamed over path; the fitness
+    // cache is appended to the log path.cache.<epoch> next to it.
+    void setCheckpoint(const std::string& path, int every = 1);
+
+    // Caps the fitness cache; past the cap the oldest entries are evicted
+    // first, which keeps the cache (and its checkpoint log) bounded on long runs
+    void setFitnessCacheLimit(size_t entries);
+
+    // Binary snapshot of population, seed (the RNG state: streams are keyed
+    // by seed and generation), best gene, fitness cache, screening precision
+    // and finalists, and the next generation to run
+    bool saveCheckpoint(const std::string& path);
+
+    // Restores a snapshot taken over the same bars and population size; the
+    // next evolve() continues from the saved generation and ends exactly as
+    // the uninterrupted run would have
+    bool resume(const std::string& path);
+
+    // Per-generation fitness, diversity, throughput, cache and phase-time
+    // rows, appended to a CSV file by a background writer. With append,
+    // rows of the generations a resumed run replays are dropped first, so
+    // call it after resume().
+    void setTelemetry(const std::string& path, bool append = false);
+
+    // Racing: each backtest runs in `blocks` time blocks and is abandoned
+    // once its fitness upper bound cannot reach the `rank`-th best fitness of
+    // the previous generation. Pruned genes get -infinity as their fitness,
+    // so selection ranks them below every evaluated gene; they are not
+    // cached and are left out of the statistics and the next threshold.
+    // Off by default.
+    void setRacing(bool enabled, size_t blocks = 8, size_t rank = 10);
+
+    // Evaluates each generation's cache misses in one batched call through
+    // backend (see PopulationEvaluator.hpp) instead of gene by gene. Racing
+    // does not apply to batches. Off by default. Fails (batching stays off)
+    // for Cuda: its kernel does not implement the gene rules yet.
+    bool setBatchEvaluation(bool enabled, PopulationBackend backend = PopulationBackend::Cpu);
+
+    // Float32 screens every generation in single precision (see
+    // GeneEvaluator). The `finalists` best distinct genes screened are kept
+    // and re-scored in Float64 when evolve() ends; the best of those becomes
+    // the best strategy, with its Float64 fitness, and screeningReport()
+    // compares the two rankings. Checkpoints hold screened fitness and the
+    // finalists so far, so call this before resume() with the same precision
+    // (resume() refuses another). Float64 (the default) screens nothing.
+    void setScreening(Precision precision, size_t finalists = 20);
+    const ScreeningReport& screeningReport() const { return screening_report_; }
+
+    int generation() const { return generation_; }
+    size_t cacheHits() const { return cache_hits_; }
+    size_t cacheMisses() const { return cache_misses_; }
+    size_t prunedBacktests() const { return pruned_; }
+
+    // Share of the bars of all backtests that racing skipped
+    double barsSavedFraction() const;
     
 private:
-    std::vector<OHLCV> data_;
+    BarView data_;
+    TimeframePyramid pyramid_;
+    std::unique_ptr<GeneEvaluator> evaluator_;
     std::vector<StrategyGene> population_;
     StrategyGene best_strategy_;
     FitnessResult best_fitness_;
@@ -110,8 +211,71 @@ private:
     double mutation_rate_;
     double crossover_rate_;
     
-    std::mt19937 rng_;
+    uint64_t seed_;
+    int generation_ = 0;
+    bool resumed_ = false;
+    std::unique_ptr<ThreadPool> pool_;
+
+    // Fitness score by gene content; genes that survive a generation
+    // unchanged (elites, pairs that skip crossover) are not re-evaluated
+    std::unordered_map<uint64_t, double> fitness_cache_;
+    std::deque<uint64_t> cache_order_;  // keys by insertion, oldest first
+    size_t cache_limit_ = 200000;
+    size_t cache_hits_ = 0;
+    size_t cache_misses_ = 0;
+    size_t backtests_ = 0;
+
+    bool racing_ = false;
+    size_t race_blocks_ = 8;
+    size_t race_rank_ = 10;
+    double race_threshold_ = -std::numeric_limits<double>::infinity();  // rank-th best fitness of the last evaluated generation
+    size_t pruned_ = 0;
+    std::vector<bool> pruned_genes_;  // population indices pruned in the last evaluation
+    size_t bars_run_ = 0;
+    size_t bars_total_ = 0;
+
+    bool batched_ = false;
+    PopulationBackend batch_backend_ = PopulationBackend::Cpu;
+    std::unique_ptr<PopulationEvaluator> batch_evaluator_;
+
+    // Float32 evaluator of the screening generations, null without screening
+    std::unique_ptr<GeneEvaluator> screen_evaluator_;
+    size_t finalist_count_ = 20;
+    std::vector<std::pair<uint64_t, StrategyGene>> finalists_;  // best screened by gene key, by fitness
+    ScreeningReport screening_report_;
+
+    std::unique_ptr<EvolutionTelemetry> telemetry_;
+
+    std::string checkpoint_path_;
+    int checkpoint_every_ = 1;
+    std::string cache_log_path_;   // checkpoint whose cache log is in step, empty if none
+    uint64_t cache_log_epoch_ = 0;
+    size_t cache_logged_ = 0;      // inserts in that log
+    size_t cache_unlogged_ = 0;    // inserts since the last snapshot
+    uint64_t data_hash_ = 0;
+
+    RandomStream stream(size_t individual, RandomStream::Op op) const {
+        return RandomStream(seed_, static_cast<uint64_t>(generation_), individual, op);
+    }
     
+    bool writeCheckpoint(const std::string& path, int next_generation);
+
+    // Evaluator of the generations: the screening one when set
+    const GeneEvaluator& generationEvaluator() const;
+
+    // Keeps the best finalist_count_ distinct genes of the population;
+    // keys[i] is geneKey of population_[i], skip[i] marks racing bounds
+    void trackFinalists(const std::vector<uint64_t>& keys, const std::vector<bool>& skip);
+
+    // Float64 scores of the finalists; picks the best strategy from them
+    void rescoreFinalists();
+
+    // Inserts into the fitness cache, evicting the oldest entries past cache_limit_
+    void cacheFitness(uint64_t key, double fitness);
+
+    // Fitness summary and diversity of the evaluated population
+    void populationStats(GenerationStats& stats) const;
+
     // Genetic algorithm steps
     void initializePopulation();
     void evaluatePopulation();
@@ -119,33 +283,33 @@ private:
     void crossover();
     void mutate();
     void elitism();
-    
-    // Helper functions
-    double calculateSharpeRatio(const std::vector<double>& returns);
-    double calculateMaxDrawdown(const std::vector<double>& equity_curve);
-    double calculateProfitFactor(const std::vector<double>& profits, const std::vector<double>& losses);
+
 };
 
 // Strategy implementation that uses StrategyGene
 class EvolvedStrategy : public Strategy {
 public:
-    EvolvedStrategy(const StrategyGene& gene);
-    TradeSignal generateSignal(const std::vector<OHLCV>& data, size_t current_index) override;
+    // pyramid supplies higher-timeframe bars for data; when it is null (or
+    // built over different bars) one is built on first use if the gene needs it.
+    // Indicator series are allocated from resource.
+    EvolvedStrategy(const StrategyGene& gene, const TimeframePyramid* pyramid = nullptr,
+                    std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    TradeSignal generateSignal(const BarView& data, size_t current_index) override;
+
+    // Packed entry bitmask over data (see EntryMask.hpp); bars whose bit is
+    // clear never produce a signal
+    const std::pmr::vector<uint64_t>& entryMask(const BarView& data);
     
 private:
     StrategyGene gene_;
-    std::vector<double> primary_values_;
-    std::vector<double> secondary_values_;
+    const TimeframePyramid* pyramid_;
+    std::unique_ptr<TimeframePyramid> own_pyramid_;
+    std::pmr::vector<double> primary_values_;
+    std::pmr::vector<double> secondary_values_;
+    std::pmr::vector<uint64_t> entry_mask_;
     bool precomputed_ = false;
     
-    void precomputeIndicators(const std::vector<OHLCV>& data);
-    double calculateIndicator(const std::vector<OHLCV>& data, size_t index, StrategyGene::IndicatorType type, int period);
-    bool checkEntryCondition(const std::vector<OHLCV>& data, size_t index);
-    double calculateStopLoss(const std::vector<OHLCV>& data, size_t index);
-    double calculateTakeProfit(const std::vector<OHLCV>& data, size_t index);
+    void precomputeIndicators(const BarView& data);
+    void indicatorSeries(const BarView& data, StrategyGene::IndicatorType type, int period, Timeframe tf, double* out);
+    double calculateIndicator(const BarView& data, size_t index, StrategyGene::IndicatorType type, int period);
 };
-
-#ifdef USE_CUDA
-// Evaluate the fitness of the entire population on the GPU
-void evaluatePopulationGPU(std::vector<StrategyGene>& population, const std::vector<OHLCV>& data, std::vector<FitnessResult>& results);
-#endif 
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+#include <cstddef>
+#include <utility>
+
+// Reference indicator kernels: the per-bar Indicators:: functions, the
+// whole-series backends (IndicatorSeries.hpp), the gene evaluators and the
+// CUDA kernels all compute through these, so every engine produces the same
+// bits. Close is any callable returning the close of bar i (a BarView lambda
+// or ArrayClose). Sums always use kSumLanes partial sums folded left to right
+// and then the remainder, independent of the instruction set the file was
+// compiled for, so a vectorized backend reproduces them exactly. All
+// arithmetic is done in the type the close values have (double, or float
+// for the float32 screening pipeline).
+#ifdef __CUDACC__
+#define INDICATOR_HD __host__ __device__
+#else
+#define INDICATOR_HD
+#endif
+
+namespace Indicators {
+namespace Kernels {
+    constexpr size_t kSumLanes = 4;
+
+    // Relative gap between adjacent bars that counts as a fair value gap
+    constexpr double kFvgGap = 0.001;
+
+    template <class T>
+    struct ArrayClose {
+        const T* close;
+        INDICATOR_HD T operator()(size_t i) const { return close[i]; }
+    };
+    template <class T>
+    ArrayClose(const T*) -> ArrayClose<T>;
+
+    // Type of the values a Close callable returns
+    template <class Close>
+    using ValueOf = decltype(std::declval<Close>()(size_t()));
+
+    // Lane-partitioned sum of value(0..count-1)
+    template <size_t Lanes, class Value>
+    INDICATOR_HD inline auto laneSum(Value value, size_t count) {
+        using T = decltype(value(size_t()));
+        T lane[Lanes] = {};
+        const size_t loops = count / Lanes;
+        for (size_t i = 0; i < loops; ++i) {
+            for (size_t k = 0; k < Lanes; ++k) lane[k] += value(i * Lanes + k);
+        }
+        T total = lane[0];
+        for (size_t k = 1; k < Lanes; ++k) total += lane[k];
+        for (size_t i = loops * Lanes; i < count; ++i) total += value(i);
+        return total;
+    }
+
+    template <class Value>
+    INDICATOR_HD inline auto sequentialSum(Value value, size_t count) {
+        decltype(value(size_t())) total = 0;
+        for (size_t i = 0; i < count; ++i) total += value(i);
+        return total;
+    }
+
+    // Mean of close over [end_index + 1 - period, end_index]; 0 during warmup
+    template <class Close>
+    INDICATOR_HD inline ValueOf<Close> sma(Close close, size_t end_index, size_t period) {
+        if (end_index + 1 < period) return 0;
+        const size_t start = end_index + 1 - period;
+        auto price = [&](size_t k) { return close(start + k); };
+        if (period >= 8) return laneSum<kSumLanes>(price, period) / period;
+        return sequentialSum(price, period) / period;
+    }
+
+    // RSI from the gain and loss sums of one window
+    template <class T>
+    INDICATOR_HD inline T rsiFromSums(T total_gain, T total_loss, size_t period) {
+        if (total_gain + total_loss < T(1e-10)) return T(50);
+
+        T avg_gain = total_gain / period;
+        T avg_loss = total_loss / period;
+
+        if (avg_loss < T(1e-10)) return T(100);
+
+        T rs = avg_gain / avg_loss;
+        return T(100) - (T(100) / (T(1) + rs));
+    }
+
+    // Cutler RSI over the last period changes; 50 during warmup. Change k
+    // of the window contributes max(change, 0) to the gain sum and
+    // max(-change, 0) to the loss sum in lane k % kSumLanes, so the result
+    // does not depend on how many gains precede it.
+    template <class Close>
+    INDICATOR_HD inline ValueOf<Close> rsi(Close close, size_t end_index, size_t period) {
+        using T = ValueOf<Close>;
+        if (end_index < period || period == 0) return T(50);
+        const size_t first = end_index + 1 - period;
+        auto gain = [&](size_t k) {
+            T change = close(first + k) - close(first + k - 1);
+            return change > 0 ? change : T(0);
+        };
+        auto loss = [&](size_t k) {
+            T change = close(first + k) - close(first + k - 1);
+            return change < 0 ? -change : T(0);
+        };
+        return rsiFromSums(laneSum<kSumLanes>(gain, period), laneSum<kSumLanes>(loss, period), period);
+    }
+
+    // Bullish (low above the previous high) or bearish (high below the
+    // previous low) gap of more than kFvgGap between adjacent bars
+    template <class T>
+    INDICATOR_HD inline bool fvg(T prev_high, T prev_low, T high, T low) {
+        return low > prev_high * T(1.0 + kFvgGap) || high < prev_low * T(1.0 - kFvgGap);
+    }
+}
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include "BarView.hpp"
+#include "ComputeBackend.hpp"
+
+// Whole-series indicator backends. Every backend returns exactly the values
+// of the per-bar reference kernels in IndicatorKernels.hpp (out[i] is
+// Kernels::sma(close, i, period) and so on), so choosing a backend only
+// changes speed. Scalar loops over the reference kernels; Avx2 computes four
+// consecutive bars per step with the same lane layout, Avx512 eight, with
+// masked loads and stores for the last partial step. Backends are picked at
+// run time (ComputeBackend.hpp); the default is Compute::cpu().
+namespace Indicators {
+namespace Series {
+    // Backend the kernels run for requested: the widest one implemented that
+    // is not wider than it
+    ComputeBackend resolve(ComputeBackend requested = Compute::cpu());
+    // Kernels exist for backend and the host can run them
+    bool available(ComputeBackend backend);
+
+    void sma(const double* close, size_t n, size_t period, double* out, ComputeBackend backend = Compute::cpu());
+    void rsi(const double* close, size_t n, size_t period, double* out, ComputeBackend backend = Compute::cpu());
+    // out[i] = 1 when bars i - 1 and i form a fair value gap (out[0] = 0)
+    void fvg(const double* high, const double* low, size_t n, uint8_t* out,
+             ComputeBackend backend = Compute::cpu());
+
+    // float32 versions for screening (Precision::Float32): every step in
+    // float, twice the bars per vector. Backends agree bit for bit with the
+    // float32 scalar kernels, not with the double ones.
+    void sma(const float* close, size_t n, size_t period, float* out, ComputeBackend backend = Compute::cpu());
+    void rsi(const float* close, size_t n, size_t period, float* out, ComputeBackend backend = Compute::cpu());
+    void fvg(const float* high, const float* low, size_t n, uint8_t* out,
+             ComputeBackend backend = Compute::cpu());
+
+    // Checks every backend against the scalar reference and the per-bar
+    // Indicators:: functions bit for bit over data, for a spread of
+    // periods, and the float32 backends against the float32 scalar kernels;
+    // prints one line per check (and the float32 error against double) and
+    // returns false on any mismatch
+    bool validate(const BarView& data, std::ostream& out);
+}
+}
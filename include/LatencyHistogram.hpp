@@ -0,0 +1,118 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Fixed-memory latency histogram with the HdrHistogram bucket layout: values
+// from 1 to `highest` are kept to `significant_digits` decimal digits of
+// precision (3 digits = within 0.1%) in a counts array sized once at
+// construction. record() is a few shifts and one relaxed atomic add, so any
+// number of threads can record into the same histogram without locks; reads
+// (percentiles, export) may run concurrently and see a slightly stale count.
+//
+// Values are nanoseconds by convention. Values above `highest` are counted in
+// the top bucket (and in clamped()); max() stays exact.
+class LatencyHistogram {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit LatencyHistogram(uint64_t highest = 10'000'000'000ULL, int significant_digits = 3);
+
+    static uint64_t now() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now().time_since_epoch()).count());
+    }
+
+    void record(uint64_t value) {
+        const uint64_t clamped = value > highest_ ? highest_ : value;
+        counts_[countsIndex(clamped)].fetch_add(1, std::memory_order_relaxed);
+        total_.fetch_add(1, std::memory_order_relaxed);
+        if (clamped != value) clamped_.fetch_add(1, std::memory_order_relaxed);
+        uint64_t seen = max_.load(std::memory_order_relaxed);
+        while (value > seen && !max_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+    }
+
+    // Records now() - start_ns
+    void recordSince(uint64_t start_ns) { record(now() - start_ns); }
+
+    void reset();
+
+    uint64_t count() const { return total_.load(std::memory_order_relaxed); }
+    uint64_t clamped() const { return clamped_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+    double mean() const;
+    double stddev() const;
+
+    // Smallest recorded value v such that percentile % of values are <= v,
+    // reported as the highest value equivalent to v at this precision;
+    // percentile in [0, 100]
+    uint64_t valueAtPercentile(double percentile) const;
+
+    // HdrHistogram percentile distribution text (.hgrm), values divided by
+    // unit_scale (1000 for microseconds); plots with HdrHistogram's plotter
+    void writePercentiles(std::ostream& out, double unit_scale = 1000.0, int ticks_per_half_distance = 5) const;
+    bool writeHgrm(const std::string& path, double unit_scale = 1000.0) const;
+
+private:
+    static int leadingZeros(uint64_t v) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, v);
+        return 63 - static_cast<int>(index);
+#else
+        return __builtin_clzll(v);
+#endif
+    }
+
+    // value | mask is never 0, so the bit scans are defined
+    size_t countsIndex(uint64_t value) const {
+        const int pow2_ceiling = 64 - leadingZeros(value | sub_bucket_mask_);
+        const int bucket = pow2_ceiling - (sub_bucket_half_count_magnitude_ + 1);
+        const uint64_t sub_bucket = value >> bucket;
+        return (static_cast<size_t>(bucket + 1) << sub_bucket_half_count_magnitude_) +
+               static_cast<size_t>(sub_bucket - sub_bucket_half_count_);
+    }
+    uint64_t valueFromIndex(size_t index) const;
+    uint64_t highestEquivalent(uint64_t value) const;
+    uint64_t medianEquivalent(uint64_t value) const;
+    uint64_t equivalentRange(uint64_t value) const;
+
+    uint64_t highest_;
+    int significant_digits_;
+    int sub_bucket_half_count_magnitude_;
+    uint64_t sub_bucket_half_count_;
+    uint64_t sub_bucket_count_;
+    uint64_t sub_bucket_mask_;
+    int bucket_count_;
+    size_t counts_length_;
+    std::unique_ptr<std::atomic<uint64_t>[]> counts_;
+    std::atomic<uint64_t> total_{0};
+    std::atomic<uint64_t> clamped_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+// Per-bar processing latency of a backtest or replay, recorded by
+// Backtester and PortfolioBacktester when attached with setLatency().
+// A flat bar spends its time in signal (Strategy::generateSignal) and then
+// update (position open and bookkeeping); a bar with an open position only
+// in update (stop/target/exit checks). bar is the whole bar, or the whole
+// timestamp slice in a portfolio replay.
+struct BarLatency {
+    LatencyHistogram signal;
+    LatencyHistogram update;
+    LatencyHistogram bar;
+
+    // p50/p90/p99/p99.9/max per histogram, in microseconds
+    void report(std::ostream& out) const;
+
+    // prefix_signal.hgrm, prefix_update.hgrm, prefix_bar.hgrm
+    bool writeHgrm(const std::string& prefix) const;
+};
@@ -1,19 +1,22 @@
 #pragma once
 #include <vector>
 #include "DataLoader.hpp"
+#include "BarView.hpp"
 
 namespace Indicators {
     // Simple Moving Average
-    double SMA(const std::vector<OHLCV>& data, size_t end_index, size_t period);
+    double SMA(const BarView& data, size_t end_index, size_t period);
 
     // Relative Strength Index (RSI)
-    double RSI(const std::vector<OHLCV>& data, size_t end_index, size_t period);
+    double RSI(const BarView& data, size_t end_index, size_t period);
 
-    // Fair Value Gap (FVG) detection: returns true if a FVG is detected at end_index
-    bool detectFVG(const std::vector<OHLCV>& data, size_t end_index);
+    // Fair Value Gap (FVG) detection: returns true if bars end_index - 1 and
+    // end_index leave a gap of more than 0.1% (Kernels::fvg)
+    bool detectFVG(const BarView& data, size_t end_index);
     
-    // Optimized batch calculation of indicators
-    void calculateBatchIndicators(const std::vector<OHLCV>& data, 
+    // SMA and RSI for every bar at once (Series backends), identical to
+    // calling SMA and RSI per bar
+    void calculateBatchIndicators(const BarView& data, 
                                  std::vector<double>& sma_values,
                                  std::vector<double>& rsi_values,
                                  size_t sma_period, size_t rsi_period);
@@ -0,0 +1,106 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Batched population evaluation: one call scores every gene of a population
+// against the same bars. The three structs are the contract shared with the
+// CUDA evaluator (evaluate_population_gpu in gpu_kernels.cu) and are copied to
+// the device as they are, so they stay plain data.
+struct CudaOHLCV {
+    double open, high, low, close, volume;
+};
+
+// StrategyGene with its enums as ints
+struct CudaStrategyGene {
+    int primary_indicator;
+    int secondary_indicator;
+    int primary_period;
+    int secondary_period;
+    double primary_threshold;
+    double secondary_threshold;
+    int entry_condition;
+    int exit_condition;
+    double risk_reward_ratio;
+    double stop_loss_pct;
+    double take_profit_pct;
+    int max_hold_time;
+    double position_size_pct;
+    // Timeframe of each leg; the CUDA kernel has no higher-timeframe bars
+    // and ignores them
+    int primary_timeframe;
+    int secondary_timeframe;
+};
+
+struct CudaFitnessResult {
+    double total_return;
+    double sharpe_ratio;
+    double max_drawdown;
+    double win_rate;
+    int total_trades;
+    double profit_factor;
+    double calmar_ratio;
+    double fitness_score;
+};
+
+#ifdef USE_CUDA
+extern "C" void evaluate_population_gpu(const CudaStrategyGene* genes, int population_size,
+                                        const CudaOHLCV* data, int data_size, CudaFitnessResult* results);
+#endif
+
+// The same contract on the CPU, on all cores: real gene semantics
+// (GeneEvaluator, identical to GeneticAlgorithm::evaluateFitness) and any
+// number of bars. CudaOHLCV has no timestamps, so every leg is computed on
+// the bars as given whatever its timeframe; use PopulationEvaluator with a
+// timeframe pyramid for higher-timeframe legs.
+void evaluate_population_cpu(const CudaStrategyGene* genes, int population_size,
+                             const CudaOHLCV* data, int data_size, CudaFitnessResult* results);
+
+struct StrategyGene;
+struct FitnessResult;
+class BarView;
+class GeneEvaluator;
+class ThreadPool;
+
+enum class PopulationBackend { Cpu, Cuda };
+
+// Runs batches through a runtime-selected backend. The CPU backend computes
+// every indicator series that several genes of the batch share once, then
+// evaluates the genes in parallel on pool with those legs supplied. A
+// Float32 GeneEvaluator gets float series. The Cuda backend is refused:
+// evaluate_population_gpu still enters on a placeholder rule, not the gene's.
+class PopulationEvaluator {
+public:
+    // evaluator must be built over data; both, and pool, must outlive this
+    PopulationEvaluator(const BarView& data, const GeneEvaluator& evaluator, ThreadPool& pool);
+
+    // Cpu only, until the CUDA kernel implements the gene rules
+    static bool available(PopulationBackend backend);
+    static const char* name(PopulationBackend backend);
+    // "cpu" or "cuda"
+    static bool parse(const std::string& name, PopulationBackend& out);
+
+    // results[i] is the fitness of genes[i]. Returns false, with results
+    // untouched, for a backend that is not available.
+    bool evaluate(const CudaStrategyGene* genes, size_t count, CudaFitnessResult* results,
+                  PopulationBackend backend = PopulationBackend::Cpu) const;
+
+    // Memory for series shared across one batch (256 MB by default); legs
+    // that do not fit are computed per gene, as without batching
+    void setSharedSeriesBudget(size_t bytes) { shared_budget_ = bytes; }
+
+    static CudaStrategyGene pack(const StrategyGene& gene);
+    static StrategyGene unpack(const CudaStrategyGene& gene);
+    static CudaFitnessResult pack(const FitnessResult& result);
+    static FitnessResult unpack(const CudaFitnessResult& result);
+
+private:
+    void evaluateCpu(const CudaStrategyGene* genes, size_t count, CudaFitnessResult* results) const;
+    // Shared series in Real, the evaluator's precision
+    template <class Real>
+    void evaluateCpuAs(const CudaStrategyGene* genes, size_t count, CudaFitnessResult* results) const;
+
+    const GeneEvaluator& evaluator_;
+    ThreadPool& pool_;
+    size_t shared_budget_ = size_t(256) << 20;
+};
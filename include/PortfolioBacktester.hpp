@@ -0,0 +1,108 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <map>
+#include <memory>
+#include <functional>
+#include "DataLoader.hpp"
+#include "Strategy.hpp"
+#include "ThreadPool.hpp"
+#include "LatencyHistogram.hpp"
+
+// One symbol's bar series. Bars must be sorted by timestamp.
+struct SymbolSeries {
+    std::string symbol;
+    std::vector<OHLCV> bars;
+};
+
+// Position sizing and risk limits shared by the whole portfolio
+struct PortfolioConfig {
+    double initial_equity = 100000.0;
+    double risk_per_trade = 0.01;      // fraction of equity risked between entry and stop
+    double max_position_pct = 0.10;    // max notional of a single position, fraction of equity
+    double max_gross_exposure = 1.0;   // max total open notional, fraction of equity
+    int max_open_positions = 20;
+    size_t threads = 0;                // 0 = hardware concurrency
+    size_t min_parallel_symbols = 16;  // slices smaller than this are evaluated inline
+};
+
+struct SymbolStats {
+    int trades = 0;
+    int winning_trades = 0;
+    double pnl = 0.0;
+};
+
+struct PortfolioMetrics {
+    double final_equity = 0.0;
+    double total_return = 0.0;
+    double sharpe_ratio = 0.0;       // per-slice returns, not annualized
+    double max_drawdown = 0.0;       // mark-to-market, fraction of peak
+    double profit_factor = 0.0;
+    double win_rate = 0.0;
+    int total_trades = 0;
+    int winning_trades = 0;
+    int rejected_signals = 0;        // BUY signals dropped by sizing/risk limits
+    int max_concurrent_positions = 0;
+    size_t slices = 0;               // distinct timestamps processed
+    std::map<std::string, SymbolStats> per_symbol;
+
+    std::string toString() const;
+};
+
+// Runs one strategy instance per symbol over a time-aligned merge of all
+// series. Each symbol keeps its own position; equity and risk limits are
+// shared. Within a timestamp slice, signals are generated in parallel and
+// then applied in symbol order so results do not depend on thread count.
+class PortfolioBacktester {
+public:
+    using StrategyFactory = std::function<std::unique_ptr<Strategy>(const std::string& symbol)>;
+
+    PortfolioBacktester(const std::vector<SymbolSeries>& universe,
+                        StrategyFactory factory,
+                        const PortfolioConfig& config = PortfolioConfig());
+
+    void run();
+    void printSummary() const;
+    // Records latency (not owned) while replaying: signal per symbol bar
+    // (from the worker threads), update and bar per timestamp slice
+    void setLatency(BarLatency* latency) { latency_ = latency; }
+
+    const PortfolioMetrics& getMetrics() const { return metrics_; }
+    const std::vector<double>& getEquityCurve() const { return equity_curve_; }
+
+private:
+    struct PositionState {
+        Position position;  // exit rules from the entry signal
+        double size = 0.0;
+        double last_close = 0.0;
+    };
+
+    // (symbol, bar index) pairs sharing one timestamp
+    struct SliceEntry {
+        size_t symbol;
+        size_t bar;
+    };
+
+    void processSlice(const std::vector<SliceEntry>& slice);
+    void closePosition(size_t symbol, double exit_price);
+    double markToMarket() const;
+
+    const std::vector<SymbolSeries>& universe_;
+    StrategyFactory factory_;
+    PortfolioConfig config_;
+    ThreadPool pool_;
+
+    std::vector<std::unique_ptr<Strategy>> strategies_;
+    std::vector<PositionState> positions_;
+    std::vector<TradeSignal> pending_signals_;
+    std::vector<double> equity_curve_;
+
+    double cash_equity_ = 0.0;   // realized equity (initial + closed P&L)
+    double unrealized_pnl_ = 0.0; // open positions marked at their last close
+    double open_notional_ = 0.0; // sum of entry notionals of open positions
+    int open_positions_ = 0;
+    double gross_profit_ = 0.0;
+    double gross_loss_ = 0.0;
+    PortfolioMetrics metrics_;
+    BarLatency* latency_ = nullptr;
+};
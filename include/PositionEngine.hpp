@@ -0,0 +1,291 @@
+#pragma once
+#include <cstddef>
+#include <cmath>
+#include "ComputeBackend.hpp"
+
+// Exit rules for an open long position, shared by Backtester,
+// PortfolioBacktester, the gene evaluators and the CUDA population kernel so
+// every engine closes a trade on the same bar at the same price.
+//
+// On each bar after entry the rules run in a fixed order:
+//   1. low <= stop          -> exit at the stop
+//   2. high >= target       -> exit at the target
+//   3. trailing stop        -> stop = max(stop, high * (1 - trail_pct))
+//   4. hold time reached    -> exit at the close
+//   5. signal < threshold   -> exit at the close
+// The stop is tested before the target when a bar touches both, and a
+// trailing stop only ratchets after the bar's low was tested against it.
+//
+// Prices are double everywhere except the float32 screening evaluators
+// (Precision::Float32), which instantiate the same rules with Real = float.
+#ifdef __CUDACC__
+#define POSITION_HD __host__ __device__
+#else
+#define POSITION_HD
+#endif
+
+enum class ExitMode {
+    FixedBarrier,    // stop and target only
+    TrailingStop,    // stop follows the highest high since entry
+    TimeBased,       // stop, target, and a close after max_hold_bars
+    IndicatorSignal  // stop, target, and a close when signal drops below threshold
+};
+
+template <class Real>
+struct BasicExitSpec {
+    ExitMode mode = ExitMode::FixedBarrier;
+    Real trail_pct = 0;               // TrailingStop: distance below the peak high
+    size_t max_hold_bars = 0;         // TimeBased: bars after entry, 0 = no limit
+    const Real* signal = nullptr;     // IndicatorSignal: series indexed by bar
+    Real signal_threshold = 0;
+};
+using ExitSpec = BasicExitSpec<double>;
+
+enum class ExitReason { None, Stop, Target, Time, Signal, EndOfData };
+
+struct ExitFill {
+    size_t bar = 0;
+    double price = 0.0;
+    ExitReason reason = ExitReason::None;
+};
+
+namespace PositionRules {
+    // No target (trailing exits)
+    POSITION_HD inline double noTarget() { return HUGE_VAL; }
+
+    // Rules 1-5 for bar j of a position entered at entry_bar. stop is the
+    // live stop and is ratcheted in place. Returns true with fill set when
+    // the position closes on this bar.
+    template <ExitMode M, class Real>
+    POSITION_HD inline bool step(const BasicExitSpec<Real>& spec, size_t entry_bar, size_t j,
+                                 Real high, Real low, Real close,
+                                 Real& stop, Real target, ExitFill& fill) {
+        if (low <= stop) {
+            fill = {j, stop, ExitReason::Stop};
+            return true;
+        }
+        if (high >= target) {
+            fill = {j, target, ExitReason::Target};
+            return true;
+        }
+        if constexpr (M == ExitMode::TrailingStop) {
+            Real trail = high * (Real(1) - spec.trail_pct);
+            if (trail > stop) stop = trail;
+        }
+        if constexpr (M == ExitMode::TimeBased) {
+            if (spec.max_hold_bars && j - entry_bar >= spec.max_hold_bars) {
+                fill = {j, close, ExitReason::Time};
+                return true;
+            }
+        }
+        if constexpr (M == ExitMode::IndicatorSignal) {
+            if (spec.signal && spec.signal[j] < spec.signal_threshold) {
+                fill = {j, close, ExitReason::Signal};
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Vector versions of scanBarrier (PositionEngine.cpp), for hosts with
+    // the instruction set
+    size_t scanBarrierAvx2(const double* high, const double* low, size_t from, size_t to,
+                           double stop, double target);
+    size_t scanBarrierAvx512(const double* high, const double* low, size_t from, size_t to,
+                             double stop, double target);
+    size_t scanBarrierAvx2(const float* high, const float* low, size_t from, size_t to, float stop, float target);
+    size_t scanBarrierAvx512(const float* high, const float* low, size_t from, size_t to, float stop, float target);
+
+    template <class Real>
+    POSITION_HD inline size_t scanBarrierScalar(const Real* high, const Real* low, size_t from, size_t to,
+                                                Real stop, Real target) {
+        for (size_t j = from; j < to; ++j) {
+            if (low[j] <= stop || high[j] >= target) return j;
+        }
+        return to;
+    }
+
+    // scanBarrier on a given CPU backend, which the host must support
+    // (Compute::supported); for benchmarks and A/B runs
+    template <class Real>
+    inline size_t scanBarrier(const Real* high, const Real* low, size_t from, size_t to,
+                              Real stop, Real target, ComputeBackend backend) {
+#ifdef COMPUTE_X86
+        if (from + 8 <= to) {
+            if (backend == ComputeBackend::Avx512) return scanBarrierAvx512(high, low, from, to, stop, target);
+            if (backend == ComputeBackend::Avx2) return scanBarrierAvx2(high, low, from, to, stop, target);
+        }
+#endif
+        (void)backend;
+        return scanBarrierScalar(high, low, from, to, stop, target);
+    }
+
+    // First bar in [from, to) whose low <= stop or high >= target, or to
+    template <class Real>
+    POSITION_HD inline size_t scanBarrier(const Real* high, const Real* low, size_t from, size_t to,
+                                          Real stop, Real target) {
+#if defined(COMPUTE_X86) && !defined(__CUDA_ARCH__)
+        if (from + 8 <= to) return scanBarrier(high, low, from, to, stop, target, Compute::cpu());
+#endif
+        return scanBarrierScalar(high, low, from, to, stop, target);
+    }
+}
+
+// First exit of a position entered at entry_bar, scanning flat high/low/close
+// arrays of n bars. Fixed barriers (and the barrier part of time exits) are
+// scanned four (AVX2) or eight (AVX-512) bars per compare, twice that in
+// float32; trailing and signal exits run the shared step rule in a tight
+// loop. Returns bar n with reason None when the position is still open at the
+// end of the data.
+template <ExitMode M, class Real>
+POSITION_HD inline ExitFill findExit(const Real* high, const Real* low, const Real* close,
+                                     size_t entry_bar, size_t n, Real stop, Real target,
+                                     const BasicExitSpec<Real>& spec) {
+    ExitFill fill;
+    fill.bar = n;
+    if constexpr (M == ExitMode::FixedBarrier || M == ExitMode::TimeBased) {
+        // A time exit fires at the close of bar entry_bar + max_hold_bars
+        size_t end = n;
+        bool timed = false;
+        if (M == ExitMode::TimeBased && spec.max_hold_bars && spec.max_hold_bars < n - entry_bar) {
+            end = entry_bar + spec.max_hold_bars + 1;
+            timed = true;
+        }
+        size_t j = PositionRules::scanBarrier(high, low, entry_bar + 1, end, stop, target);
+        if (j < end) {
+            fill = (low[j] <= stop) ? ExitFill{j, stop, ExitReason::Stop}
+                                    : ExitFill{j, target, ExitReason::Target};
+        } else if (timed) {
+            fill = {end - 1, close[end - 1], ExitReason::Time};
+        }
+        return fill;
+    } else {
+        for (size_t j = entry_bar + 1; j < n; ++j) {
+            if (PositionRules::step<M>(spec, entry_bar, j, high[j], low[j], close[j], stop, target, fill)) {
+                return fill;
+            }
+        }
+        return fill;
+    }
+}
+
+// Runtime-mode entry point for findExit
+template <class Real>
+POSITION_HD inline ExitFill findExit(const Real* high, const Real* low, const Real* close,
+                                     size_t entry_bar, size_t n, Real stop, Real target,
+                                     const BasicExitSpec<Real>& spec) {
+    switch (spec.mode) {
+        case ExitMode::TrailingStop:
+            return findExit<ExitMode::TrailingStop>(high, low, close, entry_bar, n, stop, target, spec);
+        case ExitMode::TimeBased:
+            return findExit<ExitMode::TimeBased>(high, low, close, entry_bar, n, stop, target, spec);
+        case ExitMode::IndicatorSignal:
+            return findExit<ExitMode::IndicatorSignal>(high, low, close, entry_bar, n, stop, target, spec);
+        default:
+            return findExit<ExitMode::FixedBarrier>(high, low, close, entry_bar, n, stop, target, spec);
+    }
+}
+
+// Bar-by-bar state machine over the same rules, for engines that walk the
+// bars themselves (Backtester, PortfolioBacktester, the CUDA kernel)
+template <class Real>
+class BasicPosition {
+public:
+    POSITION_HD void open(size_t bar, Real entry_price, Real stop, Real target, const BasicExitSpec<Real>& spec) {
+        entry_bar_ = bar;
+        entry_price_ = entry_price;
+        stop_ = stop;
+        target_ = target;
+        spec_ = spec;
+        open_ = true;
+    }
+
+    // Applies bar's range; returns true with fill set when the position
+    // closes on this bar
+    POSITION_HD bool step(size_t bar, Real high, Real low, Real close, ExitFill& fill) {
+        if (!open_) return false;
+        bool closed;
+        switch (spec_.mode) {
+            case ExitMode::TrailingStop:
+                closed = PositionRules::step<ExitMode::TrailingStop>(spec_, entry_bar_, bar, high, low, close, stop_, target_, fill);
+                break;
+            case ExitMode::TimeBased:
+                closed = PositionRules::step<ExitMode::TimeBased>(spec_, entry_bar_, bar, high, low, close, stop_, target_, fill);
+                break;
+            case ExitMode::IndicatorSignal:
+                closed = PositionRules::step<ExitMode::IndicatorSignal>(spec_, entry_bar_, bar, high, low, close, stop_, target_, fill);
+                break;
+            default:
+                closed = PositionRules::step<ExitMode::FixedBarrier>(spec_, entry_bar_, bar, high, low, close, stop_, target_, fill);
+                break;
+        }
+        if (closed) open_ = false;
+        return closed;
+    }
+
+    // Closes at price regardless of the rules (end of data)
+    POSITION_HD ExitFill close(size_t bar, Real price) {
+        open_ = false;
+        return {bar, price, ExitReason::EndOfData};
+    }
+
+    POSITION_HD bool isOpen() const { return open_; }
+    POSITION_HD size_t entryBar() const { return entry_bar_; }
+    POSITION_HD Real entryPrice() const { return entry_price_; }
+    POSITION_HD Real stop() const { return stop_; }
+    POSITION_HD Real target() const { return target_; }
+
+private:
+    BasicExitSpec<Real> spec_;
+    size_t entry_bar_ = 0;
+    Real entry_price_ = 0;
+    Real stop_ = 0;
+    Real target_ = 0;
+    bool open_ = false;
+};
+using Position = BasicPosition<double>;
+
+// Stop, target and exit rules of an evolved gene entered at entry_price.
+// Gene is StrategyGene or its CUDA mirror; exit_condition follows
+// StrategyGene::ExitCondition (FIXED_RR, TRAILING_STOP, TIME_BASED,
+// INDICATOR_SIGNAL). Hold times are in hours of 1-minute base bars;
+// secondary is the gene's secondary indicator series, aligned to the base.
+// The gene's parameters are rounded to Real before use.
+template <class Real>
+struct BasicGeneExit {
+    static constexpr size_t kBarsPerHour = 60;
+
+    Real stop;
+    Real target;
+    BasicExitSpec<Real> spec;
+
+    template <class Gene>
+    POSITION_HD static BasicGeneExit forGene(const Gene& gene, Real entry_price, const Real* secondary) {
+        BasicGeneExit e;
+        e.stop = entry_price * (Real(1) - Real(gene.stop_loss_pct));
+        e.target = entry_price * (Real(1) + Real(gene.take_profit_pct));
+        switch (static_cast<int>(gene.exit_condition)) {
+            case 0: // FIXED_RR: target at risk_reward_ratio times the stop distance
+                e.target = entry_price + Real(gene.risk_reward_ratio) * (entry_price - e.stop);
+                break;
+            case 1: // TRAILING_STOP: no target
+                e.target = Real(PositionRules::noTarget());
+                e.spec.mode = ExitMode::TrailingStop;
+                e.spec.trail_pct = Real(gene.stop_loss_pct);
+                break;
+            case 2:
+                e.spec.mode = ExitMode::TimeBased;
+                e.spec.max_hold_bars = static_cast<size_t>(gene.max_hold_time > 0 ? gene.max_hold_time : 0) * kBarsPerHour;
+                break;
+            case 3:
+                e.spec.mode = ExitMode::IndicatorSignal;
+                e.spec.signal = secondary;
+                e.spec.signal_threshold = Real(gene.secondary_threshold);
+                break;
+            default:
+                break;
+        }
+        return e;
+    }
+};
+using GeneExit = BasicGeneExit<double>;
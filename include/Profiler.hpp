@@ -0,0 +1,150 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <iosfwd>
+
+// Low-overhead hot-path instrumentation, compiled in only when
+// TRADING_PROFILE is defined (cmake -DTRADING_PROFILE=ON). Otherwise
+// PROFILE_ZONE expands to nothing and none of this is referenced.
+//
+//   void Backtester::run() {
+//       PROFILE_ZONE("Backtester::run");   // timed until the end of scope
+//       ...
+//   }
+//
+// A zone costs two timestamp-counter reads and a few adds into a buffer
+// owned by the calling thread, so zones on worker threads never contend.
+// Per-zone calls, total/min/max time and, when enabled with
+// TRADING_PROFILE_COUNTERS=1 (Linux perf_event), cycles, instructions,
+// cache misses and branch misses are merged across threads and printed to
+// stderr at exit. Counters add two read() syscalls per zone, so keep them
+// for coarse zones.
+//
+// Tracing (startTrace, or TRADING_TRACE=file.json in the environment) also
+// records every zone and PROFILE_EVENT as a Chrome Trace Event, viewable in
+// Perfetto or chrome://tracing. Events go to fixed-size per-thread chunks;
+// full chunks are handed to a writer thread that streams them to the file,
+// so the hot path never does I/O. At most kMaxQueuedChunks chunks wait for
+// the writer; beyond that events are dropped and counted, never blocked on.
+#if defined(TRADING_PROFILE)
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define PROFILER_HAS_TSC 1
+#else
+#include <chrono>
+#endif
+#include <string>
+
+namespace Profiler {
+    constexpr size_t kMaxSites = 256;
+    constexpr size_t kCounterCount = 4;  // cycles, instructions, cache misses, branch misses
+    constexpr size_t kChunkEvents = 4096;     // trace events per chunk (128 KiB)
+    constexpr size_t kMaxQueuedChunks = 64;   // chunks waiting for the trace writer
+
+    // One static instance per PROFILE_ZONE call site
+    struct Site {
+        explicit Site(const char* name);
+        const char* name;
+        uint32_t id;
+    };
+
+    // Raw timestamp: TSC ticks on x86, steady-clock nanoseconds elsewhere
+    inline uint64_t now() {
+#if defined(PROFILER_HAS_TSC)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    struct ThreadBuffer;
+
+    // Calling thread's buffer, registered on first use
+    ThreadBuffer& threadBuffer();
+
+    // Hardware counters of the calling thread's perf group; false when
+    // counters are off or unavailable
+    bool readCounters(ThreadBuffer& buffer, uint64_t* values);
+
+    // Adds one finished zone to the thread's statistics (and to the trace)
+    void record(ThreadBuffer& buffer, uint32_t site, uint64_t start, uint64_t ticks, int64_t arg,
+                const uint64_t* counter_delta);
+
+    // Instant trace event (e.g. a cache hit); no statistics
+    void instant(const Site& site, int64_t arg);
+
+    class Zone {
+    public:
+        // arg is shown with the zone's trace event (e.g. generation, individual)
+        explicit Zone(const Site& site, int64_t arg = -1) : buffer_(threadBuffer()), site_(site.id), arg_(arg) {
+            counting_ = readCounters(buffer_, counters_);
+            start_ = now();
+        }
+        ~Zone() {
+            const uint64_t ticks = now() - start_;
+            if (counting_) {
+                uint64_t end[kCounterCount];
+                if (readCounters(buffer_, end)) {
+                    for (size_t k = 0; k < kCounterCount; ++k) counters_[k] = end[k] - counters_[k];
+                    record(buffer_, site_, start_, ticks, arg_, counters_);
+                    return;
+                }
+            }
+            record(buffer_, site_, start_, ticks, arg_, nullptr);
+        }
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        ThreadBuffer& buffer_;
+        uint32_t site_;
+        int64_t arg_;
+        bool counting_;
+        uint64_t start_;
+        uint64_t counters_[kCounterCount];
+    };
+
+    // Starts streaming trace events to path (Chrome Trace Event JSON);
+    // false if the file cannot be written or a trace is already running
+    bool startTrace(const std::string& path);
+
+    // Flushes every thread's pending events and closes the file. Called at
+    // exit for a running trace; call it earlier only while no other thread
+    // is inside a zone.
+    void stopTrace();
+
+    // Merged per-zone table, busiest zone first
+    void report(std::ostream& out);
+
+    // Clears every thread's statistics
+    void reset();
+}
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(name)                                                              \
+    static const Profiler::Site PROFILE_CONCAT(profile_site_, __LINE__)(name);         \
+    Profiler::Zone PROFILE_CONCAT(profile_zone_, __LINE__)(PROFILE_CONCAT(profile_site_, __LINE__))
+#define PROFILE_ZONE_ARG(name, arg)                                                     \
+    static const Profiler::Site PROFILE_CONCAT(profile_site_, __LINE__)(name);         \
+    Profiler::Zone PROFILE_CONCAT(profile_zone_, __LINE__)(PROFILE_CONCAT(profile_site_, __LINE__), \
+                                                           static_cast<int64_t>(arg))
+#define PROFILE_EVENT(name, arg)                                                        \
+    do {                                                                                \
+        static const Profiler::Site profile_event_site(name);                           \
+        Profiler::instant(profile_event_site, static_cast<int64_t>(arg));               \
+    } while (0)
+
+#else
+
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_ZONE_ARG(name, arg) ((void)0)
+#define PROFILE_EVENT(name, arg) ((void)0)
+
+#endif
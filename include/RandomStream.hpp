@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+
+// Counter-based random numbers for the genetic algorithm. A stream is a pure
+// function of its key (seed, generation, individual, operation) and of how
+// many values were drawn from it, so any thread can produce the draws of any
+// individual without touching shared generator state: selection, crossover
+// and mutation give the same population at every thread count.
+//
+// Keys are hashed with the SplitMix64 finalizer and the stream itself is
+// SplitMix64 started from the key (Weyl counter + finalizer). Satisfies
+// UniformRandomBitGenerator, so it works with the <random> distributions.
+class RandomStream {
+public:
+    using result_type = uint64_t;
+
+    // What the draws are used for; part of the key so the operations of one
+    // individual never share numbers
+    enum class Op : uint64_t { Init = 1, Select, Crossover, Mutate };
+
+    explicit RandomStream(uint64_t seed) : state_(mix(seed)) {}
+
+    RandomStream(uint64_t seed, uint64_t generation, uint64_t individual, Op op)
+        : state_(mix(mix(mix(mix(seed) ^ generation) ^ individual) ^ static_cast<uint64_t>(op))) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        state_ += kGamma;
+        return mix(state_);
+    }
+
+private:
+    static constexpr uint64_t kGamma = 0x9e3779b97f4a7c15ULL;
+
+    static uint64_t mix(uint64_t z) {
+        z += kGamma;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t state_;
+};
@@ -0,0 +1,81 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "DataLoader.hpp"
+#include "BarView.hpp"
+
+// Bar timeframes built from the 1-minute base series
+enum class Timeframe {
+    M1, M5, M15, H1, D1
+};
+
+constexpr Timeframe kTimeframes[] = {
+    Timeframe::M1, Timeframe::M5, Timeframe::M15, Timeframe::H1, Timeframe::D1
+};
+constexpr size_t kTimeframeCount = sizeof(kTimeframes) / sizeof(kTimeframes[0]);
+
+namespace Resampler {
+    // "1m", "5m", "15m", "1h", "1d"
+    const char* timeframeName(Timeframe tf);
+    // Parses a name produced by timeframeName; returns false if unknown
+    bool parseTimeframe(const std::string& name, Timeframe& out);
+
+    // Start (epoch seconds, UTC) of the bucket containing t. Intraday
+    // buckets are anchored to the 09:30 New York open, so 1h bars are
+    // 09:30-10:30, ..., and no bucket crosses a New York calendar day.
+    // Daily buckets are New York calendar days.
+    int64_t bucketStart(int64_t t, Timeframe tf);
+}
+
+// One aggregated level of the pyramid
+struct TimeframeLevel {
+    Timeframe timeframe = Timeframe::M1;
+    std::vector<OHLCV> bars;         // timestamp = bucket start (UTC)
+    std::vector<uint32_t> base_end;  // one past the last base bar folded into bars[k]
+};
+
+// All higher timeframes of a base series, built in one streaming pass.
+// Levels are owned here; view() hands out zero-copy BarViews. The base bars
+// are not copied and must outlive the pyramid.
+class TimeframePyramid {
+public:
+    TimeframePyramid() = default;
+
+    // Aggregates every timeframe above M1 from base in a single pass. Pass
+    // base.regularTradingHours() to build session-only bars.
+    static TimeframePyramid build(const BarView& base);
+
+    // Loads the levels persisted next to symbol in the data store, or builds
+    // and saves them when they are missing or were built from other bars
+    // (bar count, last timestamp or hash of the base differ).
+    static TimeframePyramid loadOrBuild(const std::string& store_root, const std::string& symbol, const BarView& base);
+
+    // Writes every level into the data store as "<symbol>@<tf>", then the
+    // base's fingerprint as <store_root>/<symbol>.pyramid
+    bool save(const std::string& store_root, const std::string& symbol) const;
+
+    // False for a default-constructed pyramid, which has no levels
+    bool built() const { return !levels_.empty(); }
+    // True when data is still the base this was built from: the same bars in
+    // memory, whose first and last timestamps have not changed since
+    bool builtFrom(const BarView& data) const;
+    const BarView& base() const { return base_; }
+    BarView view(Timeframe tf) const;
+    const TimeframeLevel& level(Timeframe tf) const;
+
+    // Expands one value per bar of tf to one value per base bar, taking the
+    // most recent bar of tf that closed before each base bar (no lookahead).
+    // Base bars inside the first bucket get fill.
+    // out must hold base().size() values. T is double or float.
+    template <class T>
+    void alignToBase(Timeframe tf, const T* values, size_t count, T* out, T fill = T(0)) const;
+
+private:
+    void setBase(const BarView& base);
+
+    BarView base_;
+    std::string base_first_, base_last_; // base timestamps when built
+    std::vector<TimeframeLevel> levels_; // kTimeframes order, M1 left empty
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Agreement between screening scores (Precision::Float32) and the Float64
+// scores of the same candidates, e.g. the finalists of a screened GA run or
+// grid search. Ranks tie-average, so equal scores rank equally in both.
+struct ScreeningReport {
+    // Default bounds for within(): screening may move a score by 0.1% and
+    // must keep the order of the finalists nearly intact
+    static constexpr double kMaxRelError = 1e-3;
+    static constexpr double kMinRankCorrelation = 0.99;
+
+    size_t candidates = 0;
+    double spearman = 1.0;        // rank correlation
+    double kendall_tau = 1.0;     // tau-b, O(candidates^2)
+    bool same_best = true;        // screening's best is a reference best
+    size_t top_k = 0;
+    size_t top_k_overlap = 0;     // candidates in both top-k lists
+    double max_abs_error = 0.0;   // |screened - reference|
+    double max_rel_error = 0.0;   // relative to |reference|; HUGE_VAL if only one is finite
+    size_t worst = 0;             // candidate with max_rel_error
+
+    // screened[i] and reference[i] score candidate i; top_k is clamped to
+    // the candidate count
+    static ScreeningReport compare(const std::vector<double>& screened, const std::vector<double>& reference,
+                                   size_t top_k);
+
+    // Errors and rank agreement inside the bounds, and the same best
+    bool within(double max_rel_error_bound = kMaxRelError,
+                double min_rank_correlation = kMinRankCorrelation) const;
+
+    // Multi-line summary for the tools' output
+    std::string toString() const;
+};
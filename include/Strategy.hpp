@@ -1,9 +1,12 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <cstdint>
 #include <chrono>
 #include <ctime>
 #include "DataLoader.hpp"
+#include "BarView.hpp"
+#include "PositionEngine.hpp"
 
 enum class SignalType {
     NONE,
@@ -16,17 +19,18 @@ struct TradeSignal {
     size_t index;
     double stop_loss;
     double take_profit;
-    std::string reason; // For logging/analysis
+    const char* reason; // For logging/analysis (static string, so signals never allocate)
+    ExitSpec exit;      // Rules after entry; fixed stop/target unless set
 };
 
 class Strategy {
 public:
     virtual ~Strategy() = default;
     // Generate a signal for the current bar
-    virtual TradeSignal generateSignal(const std::vector<OHLCV>& data, size_t current_index) = 0;
+    virtual TradeSignal generateSignal(const BarView& data, size_t current_index) = 0;
     
     // New method to calculate dynamic SMA periods based on data date range
-    static std::pair<size_t, size_t> calculateDynamicPeriods(const std::vector<OHLCV>& data);
+    static std::pair<size_t, size_t> calculateDynamicPeriods(const BarView& data);
     
 protected:
     // Helper method to parse timestamp and calculate time differences
@@ -37,22 +41,40 @@ protected:
 // Factory function for GUI
 Strategy* createGoldenFoundationStrategy(double risk_reward = 3.0);
 
+// GoldenFoundationStrategy's rule over whole series of n bars, for Real =
+// double (the strategy) and float (float32 screening in the grid search):
+// a long from bar max(sma_period, rsi_period) on where the close is above its
+// SMA, the RSI is below oversold and a fair-value gap is open, with the stop
+// 0.5%/risk_reward below the entry and the target risk_reward times that above
+template <class Real>
+struct GoldenFoundationSignals {
+    std::vector<Real> sma;
+    std::vector<Real> rsi;
+    std::vector<uint8_t> entry;  // 1 on signal bars
+    std::vector<Real> stop;
+    std::vector<Real> target;
+    size_t count = 0;            // signal bars
+
+    void compute(const Real* close, const Real* high, const Real* low, size_t n,
+                 size_t sma_period, size_t rsi_period, double rsi_oversold, double risk_reward);
+};
+
 class GoldenFoundationStrategy : public Strategy {
 public:
     GoldenFoundationStrategy(double risk_reward = 3.0);
-    void setSMA(int period) { sma_period_ = period; }
-    void setRSI(int period, double oversold) { rsi_period_ = period; rsi_oversold_ = oversold; }
-    TradeSignal generateSignal(const std::vector<OHLCV>& data, size_t current_index) override;
-    void precomputeSignals(const std::vector<OHLCV>& data);
+    // Explicit periods replace the ones derived from the data's date span
+    // (which would otherwise change with the window being backtested)
+    void setSMA(int period) { sma_period_ = period; fixed_sma_ = true; }
+    void setRSI(int period, double oversold) { rsi_period_ = period; rsi_oversold_ = oversold; fixed_rsi_ = true; }
+    TradeSignal generateSignal(const BarView& data, size_t current_index) override;
+    void precomputeSignals(const BarView& data);
 private:
     double risk_reward_ = 3.0;
-    std::vector<double> sma_values_;
-    std::vector<double> rsi_values_;
-    std::vector<int> signals_;
-    std::vector<double> stops_;
-    std::vector<double> targets_;
+    GoldenFoundationSignals<double> signals_;
     bool precomputed_ = false;
     size_t sma_period_ = 20;
     size_t rsi_period_ = 7;
     double rsi_oversold_ = 30.0;
+    bool fixed_sma_ = false;
+    bool fixed_rsi_ = false;
 };
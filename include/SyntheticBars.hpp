@@ -0,0 +1,73 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <fstream>
+#include <iomanip>
+#include "DataLoader.hpp"
+#include "RandomStream.hpp"
+#include "TimeUtils.hpp"
+
+// Reproducible synthetic 1-minute bars for benchmarks and experiments that
+// must run without downloaded market data.
+namespace SyntheticBars {
+    struct WalkOptions {
+        double start_price = 400.0;
+        double volatility = 0.0008;       // per-minute log-return standard deviation
+        double drift = 0.0;               // per-minute mean log return
+        double mean_volume = 50000.0;
+        int64_t first_day = TimeUtils::daysFromCivil(2023, 1, 3);  // first session (skipped if a weekend)
+    };
+
+    // n bars of a geometric random walk laid out as the regular US session
+    // (390 bars from 09:30 New York time, Monday-Friday) with UTC timestamps,
+    // like the SPY_1m.csv files. Each bar opens at the previous close; high
+    // and low extend past the body by a random fraction of the volatility.
+    // The series depends only on n, seed and options.
+    inline std::vector<OHLCV> randomWalk(size_t n, uint64_t seed = 42, const WalkOptions& options = WalkOptions()) {
+        RandomStream rng(seed);
+        std::normal_distribution<double> step(options.drift, options.volatility);
+        std::exponential_distribution<double> wick(2.0 / options.volatility);
+        std::gamma_distribution<double> volume(4.0, options.mean_volume / 4.0);
+
+        std::vector<OHLCV> bars;
+        bars.reserve(n);
+        double close = options.start_price;
+        int64_t day = options.first_day;
+        while (bars.size() < n) {
+            const int dow = TimeUtils::weekday(day * 86400);
+            if (dow != 0 && dow != 6) {
+                // 09:30 local is 14:30 UTC in winter, 13:30 during DST
+                const int64_t noon = day * 86400 + 12 * 3600;
+                const int64_t open_time = day * 86400 + 9 * 3600 + 30 * 60 - TimeUtils::easternUtcOffset(noon);
+                for (int minute = 0; minute < 390 && bars.size() < n; ++minute) {
+                    OHLCV bar;
+                    bar.timestamp = TimeUtils::formatTimestamp(open_time + minute * 60);
+                    bar.open = close;
+                    close *= std::exp(step(rng));
+                    bar.close = close;
+                    bar.high = std::max(bar.open, bar.close) * (1.0 + wick(rng));
+                    bar.low = std::min(bar.open, bar.close) * (1.0 - wick(rng));
+                    bar.volume = std::round(volume(rng));
+                    bars.push_back(std::move(bar));
+                }
+            }
+            ++day;
+        }
+        return bars;
+    }
+
+    // Writes bars in the DataLoader::loadCSV format
+    inline bool writeCSV(const std::string& path, const std::vector<OHLCV>& bars) {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out) return false;
+        out << "timestamp,open,high,low,close,volume\n" << std::fixed << std::setprecision(4);
+        for (const auto& bar : bars) {
+            out << bar.timestamp << ',' << bar.open << ',' << bar.high << ',' << bar.low << ','
+                << bar.close << ',' << std::setprecision(0) << bar.volume << std::setprecision(4) << '\n';
+        }
+        return out.good();
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <cstddef>
+
+// Fixed-size worker pool used for fork/join style loops (parallelFor).
+// Workers stay alive between calls so short parallel sections (e.g. one
+// timestamp slice of a portfolio backtest) do not pay thread start-up cost.
+class ThreadPool {
+public:
+    // threads == 0 uses std::thread::hardware_concurrency()
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers_.size() + 1; } // workers + calling thread
+
+    // Runs fn(i) for every i in [0, n) and blocks until all calls returned.
+    // The calling thread takes part in the work. Loops shorter than
+    // min_parallel run inline on the calling thread. Not reentrant: fn must
+    // not call parallelFor on the same pool.
+    void parallelFor(size_t n, const std::function<void(size_t)>& fn, size_t min_parallel = 2);
+
+private:
+    void workerLoop();
+    void runChunks();
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    std::mutex call_mutex_; // serializes concurrent parallelFor callers
+
+    const std::function<void(size_t)>* job_ = nullptr;
+    size_t job_size_ = 0;
+    std::atomic<size_t> next_index_{0};
+    size_t pending_workers_ = 0;
+    unsigned long long generation_ = 0;
+    bool stopping_ = false;
+};
@@ -0,0 +1,121 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <cstdio>
+
+// Timestamps in the data files are UTC strings "YYYY-MM-DD HH:MM:SS".
+// These helpers convert them to/from epoch seconds without going through
+// std::mktime, which is slow and applies the local time zone.
+namespace TimeUtils {
+    // Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's algorithm)
+    inline int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+        y -= m <= 2;
+        const int64_t era = (y >= 0 ? y : y - 399) / 400;
+        const unsigned yoe = static_cast<unsigned>(y - era * 400);
+        const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<int64_t>(doe) - 719468;
+    }
+
+    inline void civilFromDays(int64_t z, int& y, unsigned& m, unsigned& d) {
+        z += 719468;
+        const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+        const unsigned doe = static_cast<unsigned>(z - era * 146097);
+        const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const unsigned mp = (5 * doy + 2) / 153;
+        d = doy - (153 * mp + 2) / 5 + 1;
+        m = mp < 10 ? mp + 3 : mp - 9;
+        y = static_cast<int>(yoe + era * 400 + (m <= 2));
+    }
+
+    // Parses "YYYY-MM-DD", "YYYY-MM-DD HH:MM" or "YYYY-MM-DD HH:MM:SS" (a 'T'
+    // separator is also accepted). Returns false on malformed input.
+    inline bool tryParseTimestamp(const std::string& ts, int64_t& out) {
+        auto digits = [&](size_t pos, size_t n, int& value) {
+            if (pos + n > ts.size()) return false;
+            value = 0;
+            for (size_t i = pos; i < pos + n; ++i) {
+                char c = ts[i];
+                if (c < '0' || c > '9') return false;
+                value = value * 10 + (c - '0');
+            }
+            return true;
+        };
+        int y, mo, d, h = 0, mi = 0, s = 0;
+        if (!digits(0, 4, y) || ts.size() < 10 || ts[4] != '-' || !digits(5, 2, mo) ||
+            ts[7] != '-' || !digits(8, 2, d)) {
+            return false;
+        }
+        if (mo < 1 || mo > 12 || d < 1 || d > 31) return false;
+        if (ts.size() > 10) {
+            if ((ts[10] != ' ' && ts[10] != 'T') || !digits(11, 2, h) || ts.size() < 16 ||
+                ts[13] != ':' || !digits(14, 2, mi)) {
+                return false;
+            }
+            if (ts.size() >= 19 && (ts[16] != ':' || !digits(17, 2, s))) return false;
+        }
+        out = daysFromCivil(y, static_cast<unsigned>(mo), static_cast<unsigned>(d)) * 86400 +
+              h * 3600 + mi * 60 + s;
+        return true;
+    }
+
+    // Epoch seconds for a timestamp string, or 0 if it cannot be parsed
+    inline int64_t parseTimestamp(const std::string& ts) {
+        int64_t t = 0;
+        return tryParseTimestamp(ts, t) ? t : 0;
+    }
+
+    inline std::string formatTimestamp(int64_t t) {
+        int64_t days = t >= 0 ? t / 86400 : (t - 86399) / 86400;
+        int64_t secs = t - days * 86400;
+        int y; unsigned m, d;
+        civilFromDays(days, y, m, d);
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%04d-%02u-%02u %02d:%02d:%02d", y, m, d,
+                      static_cast<int>(secs / 3600), static_cast<int>((secs / 60) % 60),
+                      static_cast<int>(secs % 60));
+        return buf;
+    }
+
+    // year * 100 + month, e.g. 202403
+    inline int yearMonth(int64_t t) {
+        int64_t days = t >= 0 ? t / 86400 : (t - 86399) / 86400;
+        int y; unsigned m, d;
+        civilFromDays(days, y, m, d);
+        return y * 100 + static_cast<int>(m);
+    }
+
+    // 0 = Sunday ... 6 = Saturday
+    inline int weekday(int64_t t) {
+        int64_t days = t >= 0 ? t / 86400 : (t - 86399) / 86400;
+        return static_cast<int>(((days % 7) + 11) % 7); // 1970-01-01 was a Thursday
+    }
+
+    // Offset of US/Eastern from UTC in seconds (-4h in DST, -5h otherwise).
+    // Uses the post-2007 rule: DST from the second Sunday of March 02:00
+    // local to the first Sunday of November 02:00 local.
+    inline int64_t easternUtcOffset(int64_t t) {
+        int64_t days = t >= 0 ? t / 86400 : (t - 86399) / 86400;
+        int y; unsigned m, d;
+        civilFromDays(days, y, m, d);
+        auto nthSunday = [](int year, unsigned month, int n) {
+            int64_t first = daysFromCivil(year, month, 1);
+            int dow = static_cast<int>(((first % 7) + 11) % 7);
+            return first + (7 - dow) % 7 + 7 * (n - 1);
+        };
+        int64_t dst_start = nthSunday(y, 3, 2) * 86400 + 7 * 3600;  // 02:00 EST
+        int64_t dst_end = nthSunday(y, 11, 1) * 86400 + 6 * 3600;   // 02:00 EDT
+        return (t >= dst_start && t < dst_end) ? -4 * 3600 : -5 * 3600;
+    }
+
+    // US equity regular session, 09:30-16:00 New York time, Monday-Friday.
+    // Exchange holidays are not modelled (there are no bars on them).
+    inline bool isRegularTradingHours(int64_t t) {
+        int64_t local = t + easternUtcOffset(t);
+        int dow = weekday(local);
+        if (dow == 0 || dow == 6) return false;
+        int64_t minute = ((local % 86400) + 86400) % 86400 / 60;
+        return minute >= 9 * 60 + 30 && minute < 16 * 60;
+    }
+}
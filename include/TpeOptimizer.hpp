@@ -0,0 +1,103 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include "RandomStream.hpp"
+
+class ThreadPool;
+
+// One coordinate of a search space. Integer and categorical values are
+// whole numbers stored as doubles; a categorical dimension with `choices`
+// options takes the values 0 .. choices - 1.
+struct SearchDimension {
+    enum class Kind { Real, Integer, Categorical };
+
+    std::string name;
+    Kind kind = Kind::Real;
+    double low = 0.0;   // inclusive bounds of Real and Integer dimensions
+    double high = 1.0;
+    int choices = 0;    // Categorical only
+
+    static SearchDimension real(const std::string& name, double low, double high) {
+        return {name, Kind::Real, low, high, 0};
+    }
+    static SearchDimension integer(const std::string& name, int low, int high) {
+        return {name, Kind::Integer, static_cast<double>(low), static_cast<double>(high), 0};
+    }
+    static SearchDimension categorical(const std::string& name, int choices) {
+        return {name, Kind::Categorical, 0.0, static_cast<double>(choices - 1), choices};
+    }
+};
+
+using SearchPoint = std::vector<double>;  // one value per dimension
+
+struct SearchTrial {
+    SearchPoint point;
+    double score;  // higher is better
+};
+
+struct TpeOptions {
+    size_t startup_trials = 20;  // uniform random proposals before the model is used
+    double gamma = 0.1;          // share of the trials modelled as "good" ...
+    size_t max_good = 25;        // ... up to this many
+    size_t candidates = 32;      // draws from the good density per proposal
+};
+
+// Tree-structured Parzen estimator (Bergstra et al., 2011): the trials are
+// split at the gamma quantile of their scores into good and bad sets, each
+// modelled per dimension by a Parzen density (truncated Gaussians on the unit
+// interval for numeric dimensions, smoothed frequencies for categorical
+// ones). A proposal is the draw from the good density, among `candidates`,
+// with the highest good/bad density ratio. Only score ranks matter, so
+// fitness scores spanning many orders of magnitude need no rescaling.
+//
+// Proposals of one batch are drawn independently from the same model and can
+// be evaluated concurrently; the whole run is reproducible from the seed.
+class TpeOptimizer {
+public:
+    TpeOptimizer(std::vector<SearchDimension> space, uint64_t seed, const TpeOptions& options = TpeOptions());
+
+    // count new points from the current model (uniform while there are fewer
+    // than startup_trials observations)
+    std::vector<SearchPoint> propose(size_t count);
+
+    // Records a scored point; NaN scores count as the worst possible
+    void observe(const SearchPoint& point, double score);
+
+    // Proposes batches of `batch` points, scores each batch in parallel on
+    // pool and observes the scores, until `budget` points were scored.
+    // Returns the best trial.
+    const SearchTrial& optimize(const std::function<double(const SearchPoint&)>& objective,
+                                size_t budget, size_t batch, ThreadPool& pool);
+
+    const std::vector<SearchDimension>& space() const { return space_; }
+    const std::vector<SearchTrial>& trials() const { return trials_; }
+    // Best trial so far; trials() must not be empty
+    const SearchTrial& best() const { return trials_[best_]; }
+
+private:
+    // Parzen density of one dimension over one set of trials
+    struct Density {
+        std::vector<double> centers;  // unit-interval values (numeric) or choice weights (categorical)
+        std::vector<double> widths;
+        std::vector<double> norms;    // width * truncated mass * component count
+    };
+
+    Density fit(size_t dim, const std::vector<size_t>& members) const;
+    double sample(size_t dim, const Density& density);
+    double logPdf(size_t dim, const Density& density, double unit) const;
+    SearchPoint uniformPoint();
+
+    // Unit-interval coordinate of a value and back (rounded for integer and
+    // categorical dimensions)
+    double toUnit(size_t dim, double value) const;
+    double fromUnit(size_t dim, double unit) const;
+
+    std::vector<SearchDimension> space_;
+    TpeOptions options_;
+    RandomStream rng_;
+    std::vector<SearchTrial> trials_;
+    size_t best_ = 0;
+};
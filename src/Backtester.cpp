@@ -3,36 +3,122 @@
 #include <sstream>
 #include <iomanip>
 #include <chrono>
-#include <immintrin.h> // For SIMD optimizations
 #include <algorithm>
+#include <cstdlib>
+#include "../include/TimeUtils.hpp"
+#include "../include/Profiler.hpp"
 
-// Logging macros for extensive tracing
-#define LOG(msg) std::cout << "[LOG] " << msg << std::endl;
-#define DEBUG(msg) std::cout << "[DEBUG] " << msg << std::endl;
+// Logging macros for extensive tracing (off with setLogging(false))
+#define LOG(msg) do { if (logging_) { std::cout << "[LOG] " << msg << std::endl; } } while (0)
+#define DEBUG(msg) do { if (logging_) { std::cout << "[DEBUG] " << msg << std::endl; } } while (0)
 #define ERROR(msg) std::cerr << "[ERROR] " << msg << std::endl;
 
 double equity_ = 100000.0;
 double risk_per_trade = 0.05; //piece of a whole 0.01 = 1%
-bool in_position = false;
-double entry_price = 0.0;
-double stop_loss = 0.0;
-double take_profit = 0.0;
-double position_size = 0.0;
 
-Backtester::Backtester(const std::vector<OHLCV>& data, Strategy* strategy, double initial_equity)
+namespace {
+    const char* exitReasonName(ExitReason reason) {
+        switch (reason) {
+            case ExitReason::Stop:   return "Stop loss";
+            case ExitReason::Target: return "Take profit";
+            case ExitReason::Time:   return "Time";
+            case ExitReason::Signal: return "Signal";
+            default:                 return "Forced";
+        }
+    }
+
+    // Entry decided for one bar by tradeLoop's signal source
+    template <class Real>
+    struct BasicEntry {
+        bool open;
+        Real stop;
+        Real target;
+        BasicExitSpec<Real> exit;
+    };
+
+    // The bar loop of Backtester::run and runSignals over flat close/high/low
+    // arrays of n bars: from bar 1, a flat book enters at the close when
+    // entryAt(i) opens, sized to risk risk_per_trade of equity between entry
+    // and stop; an open position runs the PositionEngine rules, and one still
+    // open at the end closes at the last close. With EveryBar false a
+    // position jumps to its exit bar with findExit instead of stepping, and
+    // hooks only see opens and closes.
+    template <bool EveryBar, class Real, class EntryAt, class Hooks>
+    TradeTotals tradeLoop(const Real* close, const Real* high, const Real* low, size_t n, double equity,
+                          EntryAt&& entryAt, Hooks& hooks) {
+        TradeTotals totals;
+        BasicPosition<Real> position;
+        double position_size = 0.0;
+        auto settle = [&](const ExitFill& fill) {
+            double pnl = (fill.price - position.entryPrice()) * position_size;
+            equity += pnl;
+            totals.trades++;
+            if (pnl > 0) totals.wins++;
+            hooks.closed(position.entryBar(), fill, pnl, equity);
+        };
+
+        for (size_t i = 1; i < n; ++i) {
+            hooks.barStart(i);
+            if (!position.isOpen()) {
+                const BasicEntry<Real> entry = entryAt(i);
+                if (entry.open) {
+                    const Real entry_price = close[i];
+                    position.open(i, entry_price, entry.stop, entry.target, entry.exit);
+
+                    // --- position sizing ---
+                    double risk_amount   = equity * risk_per_trade;      // risk fraction of equity
+                    double risk_per_unit = entry_price - entry.stop;     // $ risk per share
+                    if (risk_per_unit > 0) {
+                        position_size = risk_amount / risk_per_unit;
+                    } else {
+                        position_size = 0; // fail-safe
+                    }
+                    hooks.opened(i, entry_price, entry.stop, entry.target, position_size);
+
+                    if constexpr (!EveryBar) {
+                        const ExitFill fill = findExit(high, low, close, i, n, entry.stop, entry.target, entry.exit);
+                        if (fill.bar >= n) break;  // still open at the end
+                        position.close(fill.bar, static_cast<Real>(fill.price));
+                        settle(fill);
+                        // No new entry on the exit bar
+                        i = fill.bar;
+                        continue;
+                    }
+                }
+            } else {
+                ExitFill fill;
+                if (position.step(i, high[i], low[i], close[i], fill)) {
+                    settle(fill);
+                } else {
+                    hooks.held(i);
+                }
+            }
+            hooks.barEnd(i, equity);
+        }
+
+        if (position.isOpen()) settle(position.close(n - 1, close[n - 1]));
+        totals.final_equity = equity;
+        return totals;
+    }
+
+    // runSignals reports totals only
+    struct NoHooks {
+        void barStart(size_t) {}
+        void opened(size_t, double, double, double, double) {}
+        void held(size_t) {}
+        void closed(size_t, const ExitFill&, double, double) {}
+        void barEnd(size_t, double) {}
+    };
+}
+
+Backtester::Backtester(const BarView& data, Strategy* strategy, double initial_equity)
     : data_(data), strategy_(strategy), initial_equity_(initial_equity), equity_(initial_equity) {}
 
 void Backtester::run() {
+    PROFILE_ZONE("Backtester::run");
     DEBUG("Backtester::run() started");
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    bool in_position = false;
-    double entry_price = 0.0;
-    double stop_loss = 0.0;
-    double take_profit = 0.0;
-    double position_size = 0.0;
-    std::string entry_date;
-
     equity_curve_.reserve(data_.size());
     equity_curve_.push_back(initial_equity_);
 
@@ -46,71 +132,126 @@ void Backtester::run() {
     }
 
     LOG("Starting main backtest loop over " << data_.size() << " bars");
+    if (latency_ && logging_) {
+        std::cout << "[WARNING] Logging is on: the latency histograms include console output" << std::endl;
+    }
 
-    for (size_t i = 1; i < data_.size(); ++i) {
-        if (!in_position) {
-            TradeSignal signal = strategy_->generateSignal(data_, i);
-            DEBUG("Bar " << i << ": Signal type = " << (int)signal.type);
-
-            if (signal.type == SignalType::BUY) {
-                entry_price = close_prices[i];
-                stop_loss   = signal.stop_loss;
-                take_profit = signal.take_profit;
-                entry_date  = data_[i].timestamp;
-
-                // --- position sizing ---
-                double risk_amount   = equity_ * risk_per_trade; // risk fraction of equity
-                double risk_per_unit = entry_price - stop_loss;  // $ risk per share
-                if (risk_per_unit > 0) {
-                    position_size = risk_amount / risk_per_unit;
-                } else {
-                    position_size = 0; // fail-safe
-                }
-
-                LOG("Trade opened at bar " << i << ", price: " << entry_price 
-                    << ", SL: " << stop_loss << ", TP: " << take_profit
-                    << ", Position size: " << position_size);
+    // Tracing, latency timers, the equity curve and yearly P&L of each bar
+    struct Hooks {
+        Backtester& bt;
+        const bool logging_;  // for LOG/DEBUG
+        uint64_t bar_start = 0;
+        uint64_t update_start = 0;
 
-                in_position = true;
+        void barStart(size_t) {
+            bar_start = bt.latency_ ? LatencyHistogram::now() : 0;
+            update_start = bar_start;
+        }
+        void opened(size_t i, double entry_price, double stop, double target, double position_size) {
+            LOG("Trade opened at bar " << i << ", price: " << entry_price 
+                << ", SL: " << stop << ", TP: " << target
+                << ", Position size: " << position_size);
+        }
+        void held(size_t i) {
+            DEBUG("Position held at bar " << i << ", price: " << bt.data_[i].close);
+        }
+        void closed(size_t entry_bar, const ExitFill& fill, double pnl, double equity) {
+            bt.addToYearlyPnL(bt.data_[entry_bar].timestamp, pnl);
+            if (fill.reason == ExitReason::EndOfData) {
+                LOG("Closing remaining position at final bar, price: " 
+                    << fill.price << ", PnL: " << pnl 
+                    << ", Final Equity: " << equity);
             } else {
-                DEBUG("No trade opened at bar " << i);
+                LOG(exitReasonName(fill.reason) << " exit at bar " << fill.bar << ", price: " << fill.price
+                    << ", PnL: " << pnl << ", New Equity: " << equity);
             }
-        } else {
-            double current_low = low_prices[i];
-            double current_high = high_prices[i];
-
-            if (current_low <= stop_loss) {
-                double pnl = (stop_loss - entry_price) * position_size;
-                equity_ += pnl;
-                addToYearlyPnL(entry_date, pnl);
-                LOG("Stop loss hit at bar " << i << ", price: " << stop_loss
-                    << ", PnL: " << pnl << ", New Equity: " << equity_);
-                in_position = false;
-            } else if (current_high >= take_profit) {
-                double pnl = (take_profit - entry_price) * position_size;
-                equity_ += pnl;
-                addToYearlyPnL(entry_date, pnl);
-                LOG("Take profit hit at bar " << i << ", price: " << take_profit
-                    << ", PnL: " << pnl << ", New Equity: " << equity_);
-                in_position = false;
-            } else {
-                DEBUG("Position held at bar " << i << ", price: " << close_prices[i]);
+        }
+        void barEnd(size_t, double equity) {
+            bt.equity_curve_.push_back(equity);
+            if (bt.latency_) {
+                const uint64_t bar_end = LatencyHistogram::now();
+                bt.latency_->update.record(bar_end - update_start);
+                bt.latency_->bar.record(bar_end - bar_start);
             }
         }
+    } hooks{*this, logging_};
 
-        equity_curve_.push_back(equity_);
-    }
-
-    if (in_position) {
-        double pnl = (close_prices.back() - entry_price) * position_size;
-        equity_ += pnl;
-        addToYearlyPnL(entry_date, pnl);
-        LOG("Closing remaining position at final bar, price: " 
-            << close_prices.back() << ", PnL: " << pnl 
-            << ", Final Equity: " << equity_);
-    }
+    const TradeTotals totals = tradeLoop<true>(
+        close_prices.data(), high_prices.data(), low_prices.data(), data_.size(), equity_,
+        [&](size_t i) {
+            TradeSignal signal = strategy_->generateSignal(data_, i);
+            if (latency_) {
+                hooks.update_start = LatencyHistogram::now();
+                latency_->signal.record(hooks.update_start - hooks.bar_start);
+            }
+            DEBUG("Bar " << i << ": Signal type = " << (int)signal.type);
+            if (signal.type != SignalType::BUY) {
+                DEBUG("No trade opened at bar " << i);
+            }
+            return BasicEntry<double>{signal.type == SignalType::BUY, signal.stop_loss, signal.take_profit, signal.exit};
+        },
+        hooks);
+    equity_ = totals.final_equity;
+    total_trades_ += totals.trades;
+    winning_trades_ += totals.wins;
 
     auto end_time = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
     LOG("Backtest completed in " << duration.count() << "ms");
-}
\ No newline at end of file
+}
+
+template <class Real>
+TradeTotals Backtester::runSignals(const Real* close, const Real* high, const Real* low, size_t n,
+                                   const GoldenFoundationSignals<Real>& signals, double initial_equity) {
+    NoHooks hooks;
+    return tradeLoop<false>(close, high, low, n, initial_equity, [&](size_t i) {
+        return BasicEntry<Real>{signals.entry[i] != 0, signals.stop[i], signals.target[i], BasicExitSpec<Real>()};
+    }, hooks);
+}
+
+template TradeTotals Backtester::runSignals<double>(const double*, const double*, const double*, size_t,
+                                                    const GoldenFoundationSignals<double>&, double);
+template TradeTotals Backtester::runSignals<float>(const float*, const float*, const float*, size_t,
+                                                   const GoldenFoundationSignals<float>&, double);
+
+void Backtester::addToYearlyPnL(const std::string& entry_date, double pnl) {
+    int year = std::atoi(entry_date.substr(0, 4).c_str());
+    yearly_pnl_[year] += pnl;
+}
+
+int Backtester::calculateDaysInDataset() const {
+    if (data_.size() < 2) return 0;
+    int64_t start = TimeUtils::parseTimestamp(data_.front().timestamp);
+    int64_t end = TimeUtils::parseTimestamp(data_.back().timestamp);
+    return static_cast<int>((end - start) / 86400);
+}
+
+void Backtester::calculateAdditionalMetrics() const {
+    double peak = initial_equity_;
+    double max_dd = 0.0;
+    for (double equity : equity_curve_) {
+        peak = std::max(peak, equity);
+        if (peak > 0) max_dd = std::max(max_dd, (peak - equity) / peak);
+    }
+    std::cout << "Total trades: " << total_trades_ << "\n"
+              << "Win rate: " << std::fixed << std::setprecision(2) << (getWinRate() * 100.0) << "%\n"
+              << "Max drawdown: " << (max_dd * 100.0) << "%\n";
+}
+
+void Backtester::printYearlyPnL() const {
+    std::cout << "\n=== YEARLY P&L ===\n";
+    for (const auto& kv : yearly_pnl_) {
+        std::cout << kv.first << ": " << std::fixed << std::setprecision(2) << kv.second << "\n";
+    }
+}
+
+void Backtester::printTotalGain() const {
+    double gain = equity_ - initial_equity_;
+    double gain_pct = initial_equity_ != 0.0 ? gain / initial_equity_ * 100.0 : 0.0;
+    std::cout << "\n=== TOTAL ===\n"
+              << "Days in dataset: " << calculateDaysInDataset() << "\n"
+              << "Initial equity: " << std::fixed << std::setprecision(2) << initial_equity_ << "\n"
+              << "Final equity: " << equity_ << "\n"
+              << "Total gain: " << gain << " (" << gain_pct << "%)\n";
+    calculateAdditionalMetrics();
+}
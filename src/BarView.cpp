@@ -0,0 +1,83 @@
+#include "../include/BarView.hpp"
+#include "../include/TimeUtils.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+BarView BarView::slice(size_t begin, size_t end) const {
+    end = std::min(end, size_);
+    begin = std::min(begin, end);
+    BarView view;
+    if (index_) {
+        view.base_ = base_;
+        view.index_ = index_;
+        view.offset_ = offset_ + begin;
+    } else {
+        view.base_ = base_ + begin;
+    }
+    view.size_ = end - begin;
+    return view;
+}
+
+size_t BarView::lowerBound(const std::string& ts) const {
+    size_t lo = 0, hi = size_;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if ((*this)[mid].timestamp < ts) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+size_t BarView::indexOf(const std::string& ts) const {
+    size_t pos = lowerBound(ts);
+    return (pos < size_ && (*this)[pos].timestamp == ts) ? pos : size_;
+}
+
+BarView BarView::dateRange(const std::string& from, const std::string& to) const {
+    return slice(lowerBound(from), lowerBound(to));
+}
+
+BarView BarView::year(int year) const {
+    return dateRange(std::to_string(year), std::to_string(year + 1));
+}
+
+std::map<int, BarView> BarView::years() const {
+    std::map<int, BarView> out;
+    size_t pos = 0;
+    while (pos < size_) {
+        int y = std::atoi((*this)[pos].timestamp.substr(0, 4).c_str());
+        size_t next = lowerBound(std::to_string(y + 1));
+        out[y] = slice(pos, next);
+        pos = std::max(next, pos + 1);
+    }
+    return out;
+}
+
+BarView BarView::regularTradingHours() const {
+    auto index = std::make_shared<std::vector<uint32_t>>();
+    index->reserve(size_);
+    for (size_t i = 0; i < size_; ++i) {
+        int64_t t;
+        if (!TimeUtils::tryParseTimestamp((*this)[i].timestamp, t)) continue;
+        if (TimeUtils::isRegularTradingHours(t)) {
+            size_t source = index_ ? (*index_)[offset_ + i] : i;
+            index->push_back(static_cast<uint32_t>(source));
+        }
+    }
+    BarView view;
+    view.base_ = base_;
+    view.size_ = index->size();
+    view.offset_ = 0;
+    view.index_ = std::move(index);
+    return view;
+}
+
+std::pair<BarView, BarView> BarView::split(double fraction) const {
+    fraction = std::clamp(fraction, 0.0, 1.0);
+    size_t cut = static_cast<size_t>(static_cast<double>(size_) * fraction);
+    return {slice(0, cut), slice(cut, size_)};
+}
+
+std::vector<OHLCV> BarView::toVector() const {
+    return std::vector<OHLCV>(begin(), end());
+}
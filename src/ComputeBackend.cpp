@@ -0,0 +1,165 @@
+#include "../include/ComputeBackend.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+#ifdef COMPUTE_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace {
+    struct Features {
+        bool avx2 = false;    // AVX2 + BMI1/2, YMM state enabled
+        bool avx512 = false;  // AVX-512 F/DQ/VL/BW, ZMM and mask state enabled
+    };
+
+#ifdef COMPUTE_X86
+    void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+#ifdef _MSC_VER
+        int r[4];
+        __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+        for (int k = 0; k < 4; ++k) regs[k] = static_cast<unsigned>(r[k]);
+#else
+        __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    }
+
+    uint64_t xcr0() {
+#ifdef _MSC_VER
+        return _xgetbv(0);
+#else
+        uint32_t eax, edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+    }
+#endif
+
+    Features detect() {
+        Features f;
+#ifdef COMPUTE_X86
+        unsigned r[4];
+        cpuid(0, 0, r);
+        const unsigned max_leaf = r[0];
+        if (max_leaf < 7) return f;
+        cpuid(1, 0, r);
+        const bool osxsave = (r[2] >> 27) & 1;
+        const bool avx = (r[2] >> 28) & 1;
+        if (!osxsave || !avx) return f;
+        // The OS must save XMM/YMM state (bits 1-2) and, for AVX-512, the
+        // opmask and ZMM state (bits 5-7) across context switches
+        const uint64_t xcr = xcr0();
+        const bool ymm_state = (xcr & 0x6) == 0x6;
+        const bool zmm_state = (xcr & 0xe6) == 0xe6;
+        cpuid(7, 0, r);
+        const unsigned ebx = r[1];
+        const bool avx2 = (ebx >> 5) & 1;
+        const bool bmi1 = (ebx >> 3) & 1;
+        const bool bmi2 = (ebx >> 8) & 1;
+        const bool avx512 = ((ebx >> 16) & 1) && ((ebx >> 17) & 1) && ((ebx >> 30) & 1) && ((ebx >> 31) & 1);
+        f.avx2 = ymm_state && avx2 && bmi1 && bmi2;
+        f.avx512 = f.avx2 && zmm_state && avx512;
+#endif
+        return f;
+    }
+
+    const Features& features() {
+        static const Features f = detect();
+        return f;
+    }
+
+    ComputeBackend widest() {
+        if (features().avx512) return ComputeBackend::Avx512;
+        if (features().avx2) return ComputeBackend::Avx2;
+        return ComputeBackend::Scalar;
+    }
+
+    // TRADING_BACKEND, when set to a CPU backend this host can run
+    ComputeBackend initial() {
+        const char* env = std::getenv("TRADING_BACKEND");
+        if (!env || !*env) return widest();
+        ComputeBackend backend;
+        if (!Compute::parse(env, backend) || backend == ComputeBackend::Cuda || !Compute::supported(backend)) {
+            std::cerr << "[WARNING] TRADING_BACKEND=" << env << " is not a CPU backend this host supports ("
+                      << Compute::describe() << "), using " << Compute::name(widest()) << std::endl;
+            return widest();
+        }
+        return backend;
+    }
+
+    // -1 until the first cpu() or select()
+    std::atomic<int> g_selected{-1};
+}
+
+namespace Compute {
+    bool supported(ComputeBackend backend) {
+        switch (backend) {
+            case ComputeBackend::Scalar: return true;
+            case ComputeBackend::Avx2: return features().avx2;
+            case ComputeBackend::Avx512: return features().avx512;
+            case ComputeBackend::Cuda:
+#ifdef USE_CUDA
+                return true;
+#else
+                return false;
+#endif
+        }
+        return false;
+    }
+
+    ComputeBackend cpu() {
+        int value = g_selected.load(std::memory_order_relaxed);
+        if (value < 0) {
+            int expected = -1;
+            g_selected.compare_exchange_strong(expected, static_cast<int>(initial()), std::memory_order_relaxed);
+            value = g_selected.load(std::memory_order_relaxed);
+        }
+        return static_cast<ComputeBackend>(value);
+    }
+
+    bool select(ComputeBackend backend) {
+        if (backend == ComputeBackend::Cuda || !supported(backend)) return false;
+        g_selected.store(static_cast<int>(backend), std::memory_order_relaxed);
+        return true;
+    }
+
+    const char* name(ComputeBackend backend) {
+        switch (backend) {
+            case ComputeBackend::Avx2: return "avx2";
+            case ComputeBackend::Avx512: return "avx512";
+            case ComputeBackend::Cuda: return "cuda";
+            default: return "scalar";
+        }
+    }
+
+    bool parse(const std::string& name, ComputeBackend& out) {
+        for (ComputeBackend backend : {ComputeBackend::Scalar, ComputeBackend::Avx2, ComputeBackend::Avx512,
+                                       ComputeBackend::Cuda}) {
+            if (name == Compute::name(backend)) {
+                out = backend;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const char* name(Precision precision) {
+        return precision == Precision::Float32 ? "float32" : "float64";
+    }
+
+    std::string describe() {
+        std::string out;
+        for (ComputeBackend backend : {ComputeBackend::Scalar, ComputeBackend::Avx2, ComputeBackend::Avx512,
+                                       ComputeBackend::Cuda}) {
+            if (!supported(backend)) continue;
+            if (!out.empty()) out += ' ';
+            out += name(backend);
+        }
+        return out;
+    }
+}
@@ -1,8 +1,11 @@
 #include "../include/DataLoader.hpp"
+#include "../include/Profiler.hpp"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <exception>
+#include <algorithm>
+#include <cctype>
 
 //debug macros
 #define LOG(msg) std::cout << "[LOG] " << msg << std::endl;
@@ -21,6 +24,7 @@ static inline std::string trim(const std::string& s) {
 }
 
 std::vector<OHLCV> DataLoader::loadCSV(const std::string& filename) {
+    PROFILE_ZONE("DataLoader::loadCSV");
     std::vector<OHLCV> data;
     LOG("Attempting to open file: " << filename);
     std::ifstream file(filename);
@@ -0,0 +1,310 @@
+#include "../include/DataStore.hpp"
+#include "../include/TimeUtils.hpp"
+#include "../include/FileUtils.hpp"
+#include "../include/Profiler.hpp"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+#include <map>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define LOG(msg) std::cout << "[LOG] " << msg << std::endl;
+#define ERROR(msg) std::cerr << "[ERROR] " << msg << std::endl;
+
+namespace {
+    const char kShardMagic[8] = {'T', 'A', 'B', 'A', 'R', 'S', '0', '1'};
+    const uint32_t kShardVersion = 1;
+    const char* kIndexFile = "index.csv";
+
+    // Fixed 64-byte shard header; records start right after it
+    struct ShardHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t record_size;
+        uint64_t rows;
+        int64_t first_time;
+        int64_t last_time;
+        unsigned char reserved[24];
+    };
+    static_assert(sizeof(ShardHeader) == 64, "ShardHeader must be 64 bytes");
+
+    std::string monthString(int year_month) {
+        char buf[16];
+        std::snprintf(buf, sizeof(buf), "%04d-%02d", year_month / 100, year_month % 100);
+        return buf;
+    }
+
+    bool writeIndex(const std::string& root, const std::vector<ShardInfo>& shards) {
+        std::ostringstream oss;
+        oss << "symbol,month,file,first_timestamp,last_timestamp,rows,byte_offset,byte_length\n";
+        for (const auto& s : shards) {
+            oss << s.symbol << ',' << monthString(s.year_month) << ',' << s.file << ','
+                << TimeUtils::formatTimestamp(s.first_time) << ','
+                << TimeUtils::formatTimestamp(s.last_time) << ','
+                << s.rows << ',' << s.byte_offset << ',' << s.byte_length << '\n';
+        }
+        return FileUtils::atomicWrite(std::filesystem::path(root) / kIndexFile, oss.str());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// MappedFile
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return;
+    }
+    file_handle_ = file;
+    mapping_handle_ = mapping;
+    data_ = static_cast<const unsigned char*>(view);
+    size_ = static_cast<size_t>(size.QuadPart);
+}
+
+MappedFile::~MappedFile() {
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_handle_) CloseHandle(static_cast<HANDLE>(mapping_handle_));
+    if (file_handle_) CloseHandle(static_cast<HANDLE>(file_handle_));
+}
+#else
+MappedFile::MappedFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return;
+    }
+    void* addr = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        ::close(fd);
+        return;
+    }
+    // Queries binary-search into the middle of a shard; no read-ahead of the whole file
+    ::madvise(addr, static_cast<size_t>(st.st_size), MADV_RANDOM);
+    fd_ = fd;
+    data_ = static_cast<const unsigned char*>(addr);
+    size_ = static_cast<size_t>(st.st_size);
+}
+
+MappedFile::~MappedFile() {
+    if (data_) ::munmap(const_cast<unsigned char*>(data_), size_);
+    if (fd_ >= 0) ::close(fd_);
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// DataStore
+
+DataStore::DataStore(const std::string& root) : root_(root) {
+    readIndex();
+}
+
+bool DataStore::readIndex() {
+    shards_.clear();
+    std::ifstream in(std::filesystem::path(root_) / kIndexFile);
+    if (!in.is_open()) return false;
+
+    std::string line;
+    std::getline(in, line); // header
+    size_t line_num = 1;
+    while (std::getline(in, line)) {
+        ++line_num;
+        if (line.empty()) continue;
+        std::stringstream ss(line);
+        std::string symbol, month, file, first, last, rows, offset, length;
+        if (!std::getline(ss, symbol, ',') || !std::getline(ss, month, ',') ||
+            !std::getline(ss, file, ',') || !std::getline(ss, first, ',') ||
+            !std::getline(ss, last, ',') || !std::getline(ss, rows, ',') ||
+            !std::getline(ss, offset, ',') || !std::getline(ss, length, ',')) {
+            ERROR("Malformed index line " << line_num << " in " << root_);
+            continue;
+        }
+        try {
+            ShardInfo info;
+            info.symbol = symbol;
+            info.year_month = std::stoi(month.substr(0, 4)) * 100 + std::stoi(month.substr(5, 2));
+            info.file = file;
+            info.first_time = TimeUtils::parseTimestamp(first);
+            info.last_time = TimeUtils::parseTimestamp(last);
+            info.rows = std::stoull(rows);
+            info.byte_offset = std::stoull(offset);
+            info.byte_length = std::stoull(length);
+            shards_.push_back(info);
+        } catch (const std::exception& e) {
+            ERROR("Bad index line " << line_num << " in " << root_ << ": " << e.what());
+        }
+    }
+    std::sort(shards_.begin(), shards_.end(), [](const ShardInfo& a, const ShardInfo& b) {
+        return a.symbol != b.symbol ? a.symbol < b.symbol : a.year_month < b.year_month;
+    });
+    return true;
+}
+
+bool DataStore::ingest(const std::string& root, const std::string& symbol, const std::vector<OHLCV>& bars) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::create_directories(fs::path(root) / symbol, ec);
+    if (ec) {
+        ERROR("Could not create store directory " << root << "/" << symbol << ": " << ec.message());
+        return false;
+    }
+
+    // Bucket records by UTC month
+    std::map<int, std::vector<BarRecord>> months;
+    size_t skipped = 0;
+    for (const auto& bar : bars) {
+        int64_t t;
+        if (!TimeUtils::tryParseTimestamp(bar.timestamp, t)) {
+            ++skipped;
+            continue;
+        }
+        months[TimeUtils::yearMonth(t)].push_back({t, bar.open, bar.high, bar.low, bar.close, bar.volume});
+    }
+
+    DataStore existing(root);
+    std::vector<ShardInfo> shards;
+    for (const auto& s : existing.shards()) {
+        if (s.symbol != symbol || months.find(s.year_month) == months.end()) shards.push_back(s);
+    }
+
+    for (auto& kv : months) {
+        auto& records = kv.second;
+        std::stable_sort(records.begin(), records.end(),
+                         [](const BarRecord& a, const BarRecord& b) { return a.time < b.time; });
+
+        ShardHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, kShardMagic, sizeof(kShardMagic));
+        header.version = kShardVersion;
+        header.record_size = sizeof(BarRecord);
+        header.rows = records.size();
+        header.first_time = records.front().time;
+        header.last_time = records.back().time;
+
+        std::string bytes(sizeof(header) + records.size() * sizeof(BarRecord), '\0');
+        std::memcpy(&bytes[0], &header, sizeof(header));
+        std::memcpy(&bytes[sizeof(header)], records.data(), records.size() * sizeof(BarRecord));
+
+        ShardInfo info;
+        info.symbol = symbol;
+        info.year_month = kv.first;
+        info.file = symbol + "/" + monthString(kv.first) + ".bars";
+        info.first_time = header.first_time;
+        info.last_time = header.last_time;
+        info.rows = header.rows;
+        info.byte_offset = sizeof(header);
+        info.byte_length = records.size() * sizeof(BarRecord);
+
+        if (!FileUtils::atomicWrite(fs::path(root) / info.file, bytes)) {
+            ERROR("Could not write shard " << info.file);
+            return false;
+        }
+        shards.push_back(info);
+    }
+
+    std::sort(shards.begin(), shards.end(), [](const ShardInfo& a, const ShardInfo& b) {
+        return a.symbol != b.symbol ? a.symbol < b.symbol : a.year_month < b.year_month;
+    });
+    if (!writeIndex(root, shards)) {
+        ERROR("Could not write index for store " << root);
+        return false;
+    }
+    LOG("Ingested " << (bars.size() - skipped) << " bars of " << symbol << " into "
+        << months.size() << " shards (skipped " << skipped << " unparseable timestamps)");
+    return true;
+}
+
+std::vector<std::string> DataStore::symbols() const {
+    std::vector<std::string> out;
+    for (const auto& s : shards_) {
+        if (out.empty() || out.back() != s.symbol) out.push_back(s.symbol);
+    }
+    return out;
+}
+
+std::vector<ShardInfo> DataStore::shardsFor(const std::string& symbol, int64_t from, int64_t to) const {
+    std::vector<ShardInfo> out;
+    auto it = std::lower_bound(shards_.begin(), shards_.end(), symbol,
+                               [](const ShardInfo& s, const std::string& sym) { return s.symbol < sym; });
+    for (; it != shards_.end() && it->symbol == symbol; ++it) {
+        if (it->last_time >= from && it->first_time <= to) out.push_back(*it);
+    }
+    return out;
+}
+
+std::vector<BarSlice> DataStore::map(const std::string& symbol, int64_t from, int64_t to) const {
+    PROFILE_ZONE("DataStore::map");
+    std::vector<BarSlice> slices;
+    for (const auto& info : shardsFor(symbol, from, to)) {
+        std::string path = (std::filesystem::path(root_) / info.file).string();
+        auto file = std::make_shared<MappedFile>(path);
+        if (!file->isOpen() || file->size() < info.byte_offset + info.byte_length) {
+            ERROR("Could not map shard " << path);
+            continue;
+        }
+        const auto* header = reinterpret_cast<const ShardHeader*>(file->data());
+        if (std::memcmp(header->magic, kShardMagic, sizeof(kShardMagic)) != 0 ||
+            header->record_size != sizeof(BarRecord) || header->rows != info.rows) {
+            ERROR("Shard " << path << " does not match the index, skipping");
+            continue;
+        }
+
+        const auto* first = reinterpret_cast<const BarRecord*>(file->data() + info.byte_offset);
+        const auto* last = first + info.rows;
+        const auto* lo = std::lower_bound(first, last, from,
+                                          [](const BarRecord& r, int64_t t) { return r.time < t; });
+        const auto* hi = std::upper_bound(lo, last, to,
+                                          [](int64_t t, const BarRecord& r) { return t < r.time; });
+        if (lo == hi) continue;
+        slices.push_back({file, lo, static_cast<size_t>(hi - lo)});
+    }
+    return slices;
+}
+
+std::vector<OHLCV> DataStore::load(const std::string& symbol, int64_t from, int64_t to) const {
+    PROFILE_ZONE("DataStore::load");
+    auto slices = map(symbol, from, to);
+    size_t total = 0;
+    for (const auto& s : slices) total += s.count;
+
+    std::vector<OHLCV> bars;
+    bars.reserve(total);
+    for (const auto& s : slices) {
+        for (const auto& r : s) {
+            bars.push_back({TimeUtils::formatTimestamp(r.time), r.open, r.high, r.low, r.close, r.volume});
+        }
+    }
+    LOG("Loaded " << bars.size() << " bars of " << symbol << " from " << slices.size() << " shards");
+    return bars;
+}
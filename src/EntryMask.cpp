@@ -0,0 +1,199 @@
+#include "../include/EntryMask.hpp"
+#include "../include/ComputeBackend.hpp"
+#include <algorithm>
+#ifdef COMPUTE_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+    using Cond = StrategyGene::EntryCondition;
+    using EntryMask::Word;
+
+    // Reference predicate; used for partial words and hosts without AVX2
+    template <Cond C, class T>
+    inline bool entryAt(const T* p, const T* s, size_t i, T pt, T st) {
+        switch (C) {
+            case Cond::CROSS_ABOVE: return i > 0 && p[i] > pt && p[i - 1] <= pt;
+            case Cond::CROSS_BELOW: return i > 0 && p[i] < pt && p[i - 1] >= pt;
+            case Cond::ABOVE:       return p[i] > pt && s[i] > st;
+            case Cond::BELOW:       return p[i] < pt && s[i] < st;
+            default:                return false;
+        }
+    }
+
+    template <Cond C, class T>
+    void buildMaskScalar(const T* p, const T* s, size_t n, T pt, T st, Word* out) {
+        const size_t words = EntryMask::wordsFor(n);
+        for (size_t w = 0; w < words; ++w) {
+            const size_t base = w * 64;
+            const size_t end = std::min(base + 64, n);
+            Word bits = 0;
+            for (size_t i = base; i < end; ++i) {
+                if (entryAt<C>(p, s, i, pt, st)) bits |= Word(1) << (i - base);
+            }
+            out[w] = bits;
+        }
+    }
+
+#ifdef COMPUTE_X86
+    // Entry bits for bars i..i+3 (i >= 1). Ordered compares are false on NaN,
+    // matching the scalar operators.
+    template <Cond C>
+    COMPUTE_TARGET_AVX2 inline unsigned entryLanes(const double* p, const double* s, size_t i, __m256d pt, __m256d st) {
+        __m256d cur = _mm256_loadu_pd(p + i);
+        __m256d m;
+        switch (C) {
+            case Cond::CROSS_ABOVE:
+                m = _mm256_and_pd(_mm256_cmp_pd(cur, pt, _CMP_GT_OQ),
+                                  _mm256_cmp_pd(_mm256_loadu_pd(p + i - 1), pt, _CMP_LE_OQ));
+                break;
+            case Cond::CROSS_BELOW:
+                m = _mm256_and_pd(_mm256_cmp_pd(cur, pt, _CMP_LT_OQ),
+                                  _mm256_cmp_pd(_mm256_loadu_pd(p + i - 1), pt, _CMP_GE_OQ));
+                break;
+            case Cond::ABOVE:
+                m = _mm256_and_pd(_mm256_cmp_pd(cur, pt, _CMP_GT_OQ),
+                                  _mm256_cmp_pd(_mm256_loadu_pd(s + i), st, _CMP_GT_OQ));
+                break;
+            case Cond::BELOW:
+                m = _mm256_and_pd(_mm256_cmp_pd(cur, pt, _CMP_LT_OQ),
+                                  _mm256_cmp_pd(_mm256_loadu_pd(s + i), st, _CMP_LT_OQ));
+                break;
+            default:
+                return 0;
+        }
+        return static_cast<unsigned>(_mm256_movemask_pd(m));
+    }
+
+    template <Cond C>
+    COMPUTE_TARGET_AVX2 void buildMaskAvx2(const double* p, const double* s, size_t n, double pt, double st, Word* out) {
+        const size_t words = EntryMask::wordsFor(n);
+        const __m256d vpt = _mm256_set1_pd(pt);
+        const __m256d vst = _mm256_set1_pd(st);
+        for (size_t w = 0; w < words; ++w) {
+            const size_t base = w * 64;
+            Word bits = 0;
+            // Full words past bar 0 (crosses read p[i - 1])
+            if (base >= 1 && base + 64 <= n) {
+                for (size_t j = 0; j < 64; j += 4) {
+                    bits |= static_cast<Word>(entryLanes<C>(p, s, base + j, vpt, vst)) << j;
+                }
+                out[w] = bits;
+                continue;
+            }
+            const size_t end = std::min(base + 64, n);
+            for (size_t i = base; i < end; ++i) {
+                if (entryAt<C>(p, s, i, pt, st)) bits |= Word(1) << (i - base);
+            }
+            out[w] = bits;
+        }
+    }
+
+    // float32: eight bars per compare
+    template <Cond C>
+    COMPUTE_TARGET_AVX2 inline unsigned entryLanes(const float* p, const float* s, size_t i, __m256 pt, __m256 st) {
+        __m256 cur = _mm256_loadu_ps(p + i);
+        __m256 m;
+        switch (C) {
+            case Cond::CROSS_ABOVE:
+                m = _mm256_and_ps(_mm256_cmp_ps(cur, pt, _CMP_GT_OQ),
+                                  _mm256_cmp_ps(_mm256_loadu_ps(p + i - 1), pt, _CMP_LE_OQ));
+                break;
+            case Cond::CROSS_BELOW:
+                m = _mm256_and_ps(_mm256_cmp_ps(cur, pt, _CMP_LT_OQ),
+                                  _mm256_cmp_ps(_mm256_loadu_ps(p + i - 1), pt, _CMP_GE_OQ));
+                break;
+            case Cond::ABOVE:
+                m = _mm256_and_ps(_mm256_cmp_ps(cur, pt, _CMP_GT_OQ),
+                                  _mm256_cmp_ps(_mm256_loadu_ps(s + i), st, _CMP_GT_OQ));
+                break;
+            case Cond::BELOW:
+                m = _mm256_and_ps(_mm256_cmp_ps(cur, pt, _CMP_LT_OQ),
+                                  _mm256_cmp_ps(_mm256_loadu_ps(s + i), st, _CMP_LT_OQ));
+                break;
+            default:
+                return 0;
+        }
+        return static_cast<unsigned>(_mm256_movemask_ps(m));
+    }
+
+    template <Cond C>
+    COMPUTE_TARGET_AVX2 void buildMaskAvx2(const float* p, const float* s, size_t n, float pt, float st, Word* out) {
+        const size_t words = EntryMask::wordsFor(n);
+        const __m256 vpt = _mm256_set1_ps(pt);
+        const __m256 vst = _mm256_set1_ps(st);
+        for (size_t w = 0; w < words; ++w) {
+            const size_t base = w * 64;
+            Word bits = 0;
+            if (base >= 1 && base + 64 <= n) {
+                for (size_t j = 0; j < 64; j += 8) {
+                    bits |= static_cast<Word>(entryLanes<C>(p, s, base + j, vpt, vst)) << j;
+                }
+                out[w] = bits;
+                continue;
+            }
+            const size_t end = std::min(base + 64, n);
+            for (size_t i = base; i < end; ++i) {
+                if (entryAt<C>(p, s, i, pt, st)) bits |= Word(1) << (i - base);
+            }
+            out[w] = bits;
+        }
+    }
+#endif
+
+    template <Cond C, class T>
+    void buildMask(const T* p, const T* s, size_t n, T pt, T st, Word* out) {
+#ifdef COMPUTE_X86
+        if (Compute::cpu() >= ComputeBackend::Avx2) return buildMaskAvx2<C>(p, s, n, pt, st, out);
+#endif
+        buildMaskScalar<C>(p, s, n, pt, st, out);
+    }
+}
+
+namespace {
+    template <class T>
+    void buildAny(StrategyGene::EntryCondition condition, const T* primary, const T* secondary, size_t n,
+                  T primary_threshold, T secondary_threshold, size_t warmup, Word* out) {
+        const size_t words = EntryMask::wordsFor(n);
+        switch (condition) {
+            case Cond::CROSS_ABOVE:
+                buildMask<Cond::CROSS_ABOVE>(primary, secondary, n, primary_threshold, secondary_threshold, out);
+                break;
+            case Cond::CROSS_BELOW:
+                buildMask<Cond::CROSS_BELOW>(primary, secondary, n, primary_threshold, secondary_threshold, out);
+                break;
+            case Cond::ABOVE:
+                buildMask<Cond::ABOVE>(primary, secondary, n, primary_threshold, secondary_threshold, out);
+                break;
+            case Cond::BELOW:
+                buildMask<Cond::BELOW>(primary, secondary, n, primary_threshold, secondary_threshold, out);
+                break;
+            default:
+                std::fill(out, out + words, Word(0));
+                return;
+        }
+
+        // Clear the warmup bars
+        size_t full = std::min(warmup / 64, words);
+        std::fill(out, out + full, Word(0));
+        if (full < words && warmup % 64) {
+            out[full] &= ~Word(0) << (warmup % 64);
+        }
+    }
+}
+
+namespace EntryMask {
+    void build(StrategyGene::EntryCondition condition,
+               const double* primary, const double* secondary, size_t n,
+               double primary_threshold, double secondary_threshold,
+               size_t warmup, Word* out) {
+        buildAny(condition, primary, secondary, n, primary_threshold, secondary_threshold, warmup, out);
+    }
+
+    void build(StrategyGene::EntryCondition condition,
+               const float* primary, const float* secondary, size_t n,
+               float primary_threshold, float secondary_threshold,
+               size_t warmup, Word* out) {
+        buildAny(condition, primary, secondary, n, primary_threshold, secondary_threshold, warmup, out);
+    }
+}
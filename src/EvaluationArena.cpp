@@ -0,0 +1,41 @@
+#include "../include/EvaluationArena.hpp"
+#include <atomic>
+
+namespace {
+    std::atomic<bool> g_arena_enabled{true};
+}
+
+EvaluationArena& EvaluationArena::forThread(size_t bytes) {
+    thread_local EvaluationArena arena;
+    if (bytes > arena.capacity_) arena.reserve(bytes);
+    return arena;
+}
+
+size_t EvaluationArena::bytesFor(size_t bars) {
+    // two indicator series and one higher-timeframe series, plus headroom
+    return bars * sizeof(double) * 4 + 64 * 1024;
+}
+
+void EvaluationArena::setEnabled(bool enabled) {
+    g_arena_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool EvaluationArena::enabled() {
+    return g_arena_enabled.load(std::memory_order_relaxed);
+}
+
+void EvaluationArena::reserve(size_t bytes) {
+    resource_.reset();
+    buffer_ = std::make_unique<std::byte[]>(bytes);
+    capacity_ = bytes;
+    resource_.emplace(buffer_.get(), capacity_, std::pmr::new_delete_resource());
+}
+
+std::pmr::memory_resource* EvaluationArena::resource() {
+    if (!enabled() || !resource_) return std::pmr::new_delete_resource();
+    return &*resource_;
+}
+
+void EvaluationArena::reset() {
+    if (resource_) resource_->release();
+}
@@ -0,0 +1,85 @@
+#include "../include/EvolutionTelemetry.hpp"
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+#include <sstream>
+#include <vector>
+
+#define ERROR(msg) std::cerr << "[ERROR] " << msg << std::endl;
+
+EvolutionTelemetry::EvolutionTelemetry(const std::string& path, bool append, int keep_through) {
+    // Rows kept from the earlier run; a torn last line is dropped with them
+    std::vector<std::string> kept;
+    if (append) {
+        std::ifstream in(path);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (kept.empty() && line.rfind("generation,", 0) == 0) {
+                kept.push_back(line);
+                continue;
+            }
+            std::istringstream fields(line);
+            int generation = 0;
+            char comma = 0;
+            if (fields >> generation >> comma && comma == ',' && generation <= keep_through) kept.push_back(line);
+        }
+    }
+    const bool has_rows = !kept.empty();
+    out_.open(path, std::ios::out | std::ios::trunc);
+    for (const auto& line : kept) out_ << line << '\n';
+    open_ = static_cast<bool>(out_);
+    if (!open_) {
+        ERROR("Could not open telemetry file " << path);
+        return;
+    }
+    if (!has_rows) {
+        out_ << "generation,best_fitness,mean_fitness,median_fitness,diversity,backtests,"
+                "backtests_per_sec,bars_per_sec,cache_hits,cache_misses,cache_hit_rate,"
+                "pruned,bars_saved,evaluate_ms,select_ms,crossover_ms,mutate_ms\n";
+    }
+    out_.flush();
+    writer_ = std::thread([this] { writerLoop(); });
+}
+
+EvolutionTelemetry::~EvolutionTelemetry() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    if (writer_.joinable()) writer_.join();
+}
+
+void EvolutionTelemetry::record(const GenerationStats& stats) {
+    if (!open_) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(stats);
+    }
+    cv_.notify_one();
+}
+
+void EvolutionTelemetry::writerLoop() {
+    std::deque<GenerationStats> batch;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty() && stopping_) return;
+            batch.swap(queue_);
+        }
+        for (const auto& s : batch) {
+            const size_t lookups = s.cache_hits + s.cache_misses;
+            out_ << s.generation << ',' << std::setprecision(10)
+                 << s.best_fitness << ',' << s.mean_fitness << ',' << s.median_fitness << ','
+                 << s.diversity << ',' << s.backtests << ','
+                 << s.backtests_per_sec << ',' << s.bars_per_sec << ','
+                 << s.cache_hits << ',' << s.cache_misses << ','
+                 << (lookups ? static_cast<double>(s.cache_hits) / lookups : 0.0) << ','
+                 << s.pruned << ',' << s.bars_saved << ','
+                 << s.evaluate_ms << ',' << s.select_ms << ',' << s.crossover_ms << ',' << s.mutate_ms << '\n';
+        }
+        out_.flush();
+        batch.clear();
+    }
+}
@@ -1,12 +1,14 @@
 #include "../include/GPUStrategy.hpp"
 #include "../include/MovingAverage.hpp"
+#include "../include/IndicatorSeries.hpp"
+#include "../include/Profiler.hpp"
 #include <iostream>
 #include <chrono>
 #include <iomanip>
 
 // Declare the new optimized CUDA function
 extern "C" void gpu_calculate_all_indicators_and_signals(
-    const double* prices, int n,
+    const double* prices, const double* highs, const double* lows, int n,
     double* sma, double* rsi, int* signals, double* stops, double* targets,
     int sma_period, int rsi_period, double rsi_oversold, double risk_reward
 );
@@ -18,7 +20,8 @@ GPUGoldenFoundationStrategy::GPUGoldenFoundationStrategy(double risk_reward)
 GPUGoldenFoundationStrategy::~GPUGoldenFoundationStrategy() {
 }
 
-void GPUGoldenFoundationStrategy::precomputeSignals(const std::vector<OHLCV>& data) {
+void GPUGoldenFoundationStrategy::precomputeSignals(const BarView& data) {
+    PROFILE_ZONE("GPUGoldenFoundation::precomputeSignals");
     if (data.empty()) {
         std::cerr << "[ERROR] Data is empty. Aborting GPU signal computation." << std::endl;
         return;
@@ -33,10 +36,12 @@ void GPUGoldenFoundationStrategy::precomputeSignals(const std::vector<OHLCV>& da
     size_t rsi_period = periods.second;
     const double rsi_oversold = 30.0;
     
-    // Extract close prices for better memory locality
-    std::vector<double> prices(n);
+    // Extract prices for better memory locality
+    std::vector<double> prices(n), highs(n), lows(n);
     for (int i = 0; i < n; i++) {
         prices[i] = data[i].close;
+        highs[i] = data[i].high;
+        lows[i] = data[i].low;
     }
     
     // Allocate result arrays
@@ -61,35 +66,39 @@ void GPUGoldenFoundationStrategy::precomputeSignals(const std::vector<OHLCV>& da
         goto cpu_fallback;
     }
     
-    std::cout << "[INFO] Launching fused CUDA kernel..." << std::endl;
-    gpu_calculate_all_indicators_and_signals(
-        prices.data(), n,
-        sma_values_.data(), rsi_values_.data(),
-        signals_.data(), stops_.data(), targets_.data(),
-        static_cast<int>(sma_period), static_cast<int>(rsi_period), rsi_oversold, risk_reward_
-    );
+    {
+        std::cout << "[INFO] Launching fused CUDA kernel..." << std::endl;
+        gpu_calculate_all_indicators_and_signals(
+            prices.data(), highs.data(), lows.data(), n,
+            sma_values_.data(), rsi_values_.data(),
+            signals_.data(), stops_.data(), targets_.data(),
+            static_cast<int>(sma_period), static_cast<int>(rsi_period), rsi_oversold, risk_reward_
+        );
     
-    // Count signals generated
-    int signal_count = 0;
-    for (int i = 0; i < n; i++) {
-        if (signals_[i] == 1) signal_count++;
-    }
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-    std::cout << "[INFO] GPU generated " << signal_count << " signals in " << duration.count() << "ms using dynamic periods" << std::endl;
+        // Count signals generated
+        int signal_count = 0;
+        for (int i = 0; i < n; i++) {
+            if (signals_[i] == 1) signal_count++;
+        }
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+        std::cout << "[INFO] GPU generated " << signal_count << " signals in " << duration.count() << "ms using dynamic periods" << std::endl;
     
-    if (signal_count == 0) {
-        std::cerr << "[WARNING] GPU generated 0 signals. Falling back to CPU calculation." << std::endl;
-        goto cpu_fallback;
+        if (signal_count == 0) {
+            std::cerr << "[WARNING] GPU generated 0 signals. Falling back to CPU calculation." << std::endl;
+            goto cpu_fallback;
+        }
+        precomputed_ = true;
+        std::cout << "[INFO] Signal computation complete!\n" << std::endl;
+        return;
     }
-    precomputed_ = true;
-    std::cout << "[INFO] Signal computation complete!\n" << std::endl;
-    return;
 
 cpu_fallback:
     // --- CPU fallback ---
     std::cout << "[INFO] === CPU Signal Calculation (Fallback) ===" << std::endl;
     Indicators::calculateBatchIndicators(data, sma_values_, rsi_values_, sma_period, rsi_period);
+    std::vector<uint8_t> fvg_values(n);
+    Indicators::Series::fvg(highs.data(), lows.data(), n, fvg_values.data());
     for (int i = 0; i < n; i++) {
         if (i < std::max(sma_period, rsi_period)) {
             signals_[i] = 0;
@@ -99,17 +108,12 @@ cpu_fallback:
         }
         bool uptrend = prices[i] > sma_values_[i];
         bool oversold = rsi_values_[i] < rsi_oversold;
-        bool fvg = false;
-        if (i >= 1) {
-            double gap_threshold = 0.01; // 1% threshold
-            fvg = (prices[i] > prices[i-1] * (1.0 + gap_threshold)) || 
-                  (prices[i] < prices[i-1] * (1.0 - gap_threshold));
-        }
+        bool fvg = fvg_values[i] != 0;
         if (uptrend && oversold && fvg) {
             signals_[i] = 1; // BUY signal
             double entry = prices[i];
             double stop_loss_pct = 0.005 / risk_reward_;
-            stops_[i] = entry * (1.0 - stop_loss_pct);
+            stops_[i] = entry - (entry * stop_loss_pct);
             targets_[i] = entry + (entry - stops_[i]) * risk_reward_;
         } else {
             signals_[i] = 0; // NO signal
@@ -126,12 +130,12 @@ cpu_fallback:
     std::cout << "[INFO] Signal computation complete!\n" << std::endl;
 }
 
-TradeSignal GPUGoldenFoundationStrategy::generateSignal(const std::vector<OHLCV>& data, size_t current_index) {
+TradeSignal GPUGoldenFoundationStrategy::generateSignal(const BarView& data, size_t current_index) {
     if (!precomputed_) {
         precomputeSignals(data);
     }
     if (current_index >= signals_.size()) {
-        return {SignalType::NONE, current_index, 0.0, 0.0, "Index out of range"};
+        return {SignalType::NONE, current_index, 0.0, 0.0, "Index out of range", ExitSpec{}};
     }
     if (signals_[current_index] == 1) {
         return {
@@ -139,10 +143,11 @@ TradeSignal GPUGoldenFoundationStrategy::generateSignal(const std::vector<OHLCV>
             current_index,
             stops_[current_index],
             targets_[current_index],
-            "GPU+CPU: Uptrend, RSI<30, FVG (Dynamic periods)"
+            "GPU+CPU: Uptrend, RSI<30, FVG (Dynamic periods)",
+            ExitSpec{}
         };
     }
-    return {SignalType::NONE, current_index, 0.0, 0.0, "GPU+CPU: No setup"};
+    return {SignalType::NONE, current_index, 0.0, 0.0, "GPU+CPU: No setup", ExitSpec{}};
 }
 
 // Factory function implementation
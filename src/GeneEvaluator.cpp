@@ -0,0 +1,296 @@
+#include "../include/GeneEvaluator.hpp"
+#include "../include/EntryMask.hpp"
+#include "../include/EvaluationArena.hpp"
+#include "../include/IndicatorSeries.hpp"
+#include "../include/PositionEngine.hpp"
+#include "../include/StreamingMetrics.hpp"
+#include "../include/Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
+namespace {
+    using Indicator = StrategyGene::IndicatorType;
+    using Entry = StrategyGene::EntryCondition;
+    using Exit = StrategyGene::ExitCondition;
+
+    template <class Real>
+    using SeriesFn = void (*)(const Real* close, size_t n, size_t period, Real* out);
+
+    // Whole-series indicator kernels; only SMA and RSI have gene semantics,
+    // every other type evaluates to 0 as in EvolvedStrategy
+    template <Indicator T, class Real>
+    void indicatorKernel(const Real* close, size_t n, size_t period, Real* out) {
+        if constexpr (T == Indicator::SMA) {
+            Indicators::Series::sma(close, n, period, out);
+        } else if constexpr (T == Indicator::RSI) {
+            Indicators::Series::rsi(close, n, period, out);
+        } else {
+            std::fill(out, out + n, Real(0));
+        }
+    }
+
+    template <class Real>
+    constexpr SeriesFn<Real> kIndicatorKernels[] = {
+        &indicatorKernel<Indicator::SMA, Real>, &indicatorKernel<Indicator::EMA, Real>,
+        &indicatorKernel<Indicator::RSI, Real>, &indicatorKernel<Indicator::MACD, Real>,
+        &indicatorKernel<Indicator::BB, Real>, &indicatorKernel<Indicator::ATR, Real>,
+        &indicatorKernel<Indicator::STOCH, Real>, &indicatorKernel<Indicator::ADX, Real>,
+    };
+
+    // Caller-computed legs of the evaluator's precision
+    template <class Real>
+    const Real* primaryLeg(const GeneEvaluator::Legs* legs) {
+        if (!legs) return nullptr;
+        if constexpr (std::is_same_v<Real, float>) return legs->primary_f32;
+        else return legs->primary;
+    }
+
+    template <class Real>
+    const Real* secondaryLeg(const GeneEvaluator::Legs* legs) {
+        if (!legs) return nullptr;
+        if constexpr (std::is_same_v<Real, float>) return legs->secondary_f32;
+        else return legs->secondary;
+    }
+
+    template <class Real, class Prices>
+    void fillPrices(const BarView& data, const TimeframePyramid& pyramid, Prices& px) {
+        const size_t n = data.size();
+        px.close.resize(n);
+        px.high.resize(n);
+        px.low.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            px.close[i] = static_cast<Real>(data[i].close);
+            px.high[i] = static_cast<Real>(data[i].high);
+            px.low[i] = static_cast<Real>(data[i].low);
+        }
+        px.later_high.assign(n, Real(-HUGE_VAL));
+        for (size_t i = n; i-- > 1;) px.later_high[i - 1] = std::max(px.later_high[i], px.high[i]);
+        if (!pyramid.built()) return;
+        for (Timeframe tf : kTimeframes) {
+            if (tf == Timeframe::M1) continue;
+            BarView bars = pyramid.view(tf);
+            auto& closes = px.level_close[static_cast<size_t>(tf)];
+            closes.resize(bars.size());
+            for (size_t k = 0; k < bars.size(); ++k) closes[k] = static_cast<Real>(bars[k].close);
+        }
+    }
+
+    // Position-engine mode of each gene exit condition (see GeneExit)
+    template <Exit X>
+    constexpr ExitMode kExitMode = X == Exit::TRAILING_STOP ? ExitMode::TrailingStop
+                                 : X == Exit::TIME_BASED ? ExitMode::TimeBased
+                                 : X == Exit::INDICATOR_SIGNAL ? ExitMode::IndicatorSignal
+                                 : ExitMode::FixedBarrier;
+
+    // Largest fitness score (FitnessResult::fromMetrics) any completion of a
+    // partial run can reach. Equity only moves on entry bars, and an entry
+    // never closes above up = min(target, highest later high) / entry - 1, so
+    // with log_growth = sum of log(1 + size * up) and profit = sum of up over
+    // the entries still to run:
+    //   total return  <= equity * exp(log_growth) / initial - 1
+    //   profit factor <= (gross profit + profit) / gross loss (unbounded with no loss yet)
+    //   win rate      <= 1
+    //   Sharpe        <= sqrt(K / (N - K)) for N per-bar returns of which at
+    //                    most K (the entries) are non-zero (Cauchy-Schwarz)
+    //   max drawdown  >= drawdown so far
+    double fitnessBound(const StreamingMetrics& metrics, double equity, double initial_equity,
+                        double log_growth, double profit, size_t entries, size_t bars) {
+        const double returns = bars > 1 ? static_cast<double>(bars - 1) : 0.0;
+        const double k = static_cast<double>(entries);
+        const double sharpe = k < returns ? std::sqrt(k / (returns - k)) : HUGE_VAL;
+        const double total_return = equity * std::exp(log_growth) / initial_equity - 1.0;
+        const double gross_profit = metrics.grossProfit() + profit;
+        const double profit_factor = gross_profit <= 0 ? 0.0
+                                   : metrics.grossLoss() > 0 ? gross_profit / metrics.grossLoss() : HUGE_VAL;
+        return sharpe * 0.4 + total_return * 0.3 + 1.0 * 0.2 + profit_factor * 0.1 - metrics.maxDrawdown() * 0.5;
+    }
+}
+
+GeneEvaluator::GeneEvaluator(const BarView& data, const TimeframePyramid& pyramid, Precision precision)
+    : pyramid_(pyramid), precision_(precision) {
+    PROFILE_ZONE("GeneEvaluator::prepare");
+    if (precision_ == Precision::Float32) {
+        fillPrices<float>(data, pyramid_, f32_);
+    } else {
+        fillPrices<double>(data, pyramid_, f64_);
+    }
+}
+
+template <>
+const GeneEvaluator::Prices<double>& GeneEvaluator::prices<double>() const { return f64_; }
+
+template <>
+const GeneEvaluator::Prices<float>& GeneEvaluator::prices<float>() const { return f32_; }
+
+template <class Real>
+void GeneEvaluator::series(Indicator type, int period, Timeframe tf, Real* out,
+                           std::pmr::memory_resource* scratch) const {
+    const size_t p = static_cast<size_t>(std::max(period, 1));
+    const size_t t = static_cast<size_t>(type);
+    SeriesFn<Real> kernel = t < std::size(kIndicatorKernels<Real>) ? kIndicatorKernels<Real>[t]
+                                                                   : &indicatorKernel<Indicator::ADX, Real>;
+    const Prices<Real>& px = prices<Real>();
+
+    if (tf == Timeframe::M1) {
+        kernel(px.close.data(), px.close.size(), p, out);
+        return;
+    }
+    const auto& closes = px.level_close[static_cast<size_t>(tf)];
+    std::pmr::vector<Real> values(closes.size(), scratch);
+    kernel(closes.data(), closes.size(), p, values.data());
+    pyramid_.alignToBase(tf, values.data(), values.size(), out);
+}
+
+void GeneEvaluator::indicatorSeries(Indicator type, int period, Timeframe tf, double* out,
+                                    std::pmr::memory_resource* scratch) const {
+    series(type, period, tf, out, scratch);
+}
+
+void GeneEvaluator::indicatorSeries(Indicator type, int period, Timeframe tf, float* out,
+                                    std::pmr::memory_resource* scratch) const {
+    series(type, period, tf, out, scratch);
+}
+
+template <class Real, Entry E, Exit X>
+FitnessResult GeneEvaluator::run(const GeneEvaluator& self, const StrategyGene& gene,
+                                 const RaceLimit* limit, RaceOutcome* outcome, const Legs* legs) {
+    const size_t n = self.size();
+    const double initial_equity = 10000.0;
+    // Equity and metrics accumulate in double in both precisions: they are
+    // scalar running products and sums over the whole run, where float would
+    // lose digits (or overflow) and gain no speed
+    StreamingMetrics metrics(initial_equity);
+    double current_equity = initial_equity;
+    if (outcome) *outcome = {false, n};
+
+    if constexpr (E == Entry::INSIDE_BB || E == Entry::OUTSIDE_BB) {
+        // No band series exists for genes, so these never enter
+        metrics.addEquityRun(current_equity, n);
+        return FitnessResult::fromMetrics(metrics);
+    } else {
+        EvaluationArena& arena = EvaluationArena::forThread(EvaluationArena::bytesFor(n));
+        arena.reset();
+        std::pmr::memory_resource* scratch = arena.resource();
+
+        std::pmr::vector<Real> primary_values(scratch);
+        const Real* primary = primaryLeg<Real>(legs);
+        if (!primary) {
+            primary_values.resize(n);
+            self.indicatorSeries(gene.primary_indicator, gene.primary_period, gene.primary_timeframe,
+                                 primary_values.data(), scratch);
+            primary = primary_values.data();
+        }
+        // Crosses only read the primary leg, unless the exit reads the secondary
+        std::pmr::vector<Real> secondary_values(scratch);
+        const Real* secondary = nullptr;
+        if constexpr (E == Entry::ABOVE || E == Entry::BELOW || X == Exit::INDICATOR_SIGNAL) {
+            secondary = secondaryLeg<Real>(legs);
+            if (!secondary) {
+                secondary_values.resize(n);
+                self.indicatorSeries(gene.secondary_indicator, gene.secondary_period, gene.secondary_timeframe,
+                                     secondary_values.data(), scratch);
+                secondary = secondary_values.data();
+            }
+        }
+
+        std::pmr::vector<EntryMask::Word> mask(EntryMask::wordsFor(n), scratch);
+        EntryMask::build(E, primary, secondary ? secondary : primary, n,
+                         Real(gene.primary_threshold), Real(gene.secondary_threshold),
+                         static_cast<size_t>(std::max(gene.primary_period, gene.secondary_period)),
+                         mask.data());
+
+        const Prices<Real>& px = self.prices<Real>();
+        const Real* close = px.close.data();
+        const Real* high = px.high.data();
+        const Real* low = px.low.data();
+        const Real* signal = secondary;
+        size_t next_bar = 0;
+        auto trade = [&](size_t i) {
+            metrics.addEquityRun(current_equity, i - next_bar);
+            const Real entry_price = close[i];
+            const BasicGeneExit<Real> exit = BasicGeneExit<Real>::forGene(gene, entry_price, signal);
+            const ExitFill fill = findExit<kExitMode<X>>(high, low, close, i, n, exit.stop, exit.target, exit.spec);
+            if (fill.bar < n) {
+                double trade_return = (Real(fill.price) - entry_price) / entry_price;
+                metrics.addTrade(trade_return);
+                current_equity *= (1 + trade_return * gene.position_size_pct);
+            }
+            metrics.addEquity(current_equity);
+            next_bar = i + 1;
+        };
+
+        const size_t words = mask.size();
+        if (limit == nullptr || limit->blocks <= 1 || words == 0) {
+            EntryMask::forEachSetBit(mask.data(), words, trade);
+        } else {
+            // Best case of the entries in each block, summed from the back so
+            // remaining[b] covers blocks b and later
+            const size_t blocks = std::min(limit->blocks, words);
+            auto first_word = [&](size_t b) { return words * b / blocks; };
+            std::pmr::vector<double> log_growth(blocks + 1, 0.0, scratch);
+            std::pmr::vector<double> profit(blocks + 1, 0.0, scratch);
+            size_t entries = 0;
+            for (size_t b = 0; b < blocks; ++b) {
+                const size_t w0 = first_word(b);
+                EntryMask::forEachSetBit(mask.data() + w0, first_word(b + 1) - w0, [&](size_t k) {
+                    const size_t i = w0 * 64 + k;
+                    const Real entry_price = close[i];
+                    const BasicGeneExit<Real> exit = BasicGeneExit<Real>::forGene(gene, entry_price, signal);
+                    const double up = std::max(std::min(exit.target, px.later_high[i]) / entry_price - 1.0, 0.0);
+                    log_growth[b] += std::log1p(up * gene.position_size_pct);
+                    profit[b] += up;
+                    ++entries;
+                });
+            }
+            for (size_t b = blocks; b-- > 0;) {
+                log_growth[b] += log_growth[b + 1];
+                profit[b] += profit[b + 1];
+            }
+
+            for (size_t b = 0; b < blocks; ++b) {
+                const size_t w0 = first_word(b);
+                const double bound = fitnessBound(metrics, current_equity, initial_equity,
+                                                  log_growth[b], profit[b], entries, n);
+                if (bound < limit->threshold) {
+                    if (outcome) *outcome = {true, std::min(w0 * 64, n)};
+                    FitnessResult result = FitnessResult::fromMetrics(metrics);
+                    result.fitness_score = bound;
+                    return result;
+                }
+                EntryMask::forEachSetBit(mask.data() + w0, first_word(b + 1) - w0,
+                                         [&](size_t k) { trade(w0 * 64 + k); });
+            }
+        }
+        metrics.addEquityRun(current_equity, n - next_bar);
+        return FitnessResult::fromMetrics(metrics);
+    }
+}
+
+template <class Real, size_t... I>
+std::array<GeneEvaluator::EvaluateFn, sizeof...(I)> GeneEvaluator::makeTable(std::index_sequence<I...>) {
+    return {{&GeneEvaluator::run<Real, static_cast<Entry>(I / kExitCount), static_cast<Exit>(I % kExitCount)>...}};
+}
+
+bool GeneEvaluator::usesPrimary(const StrategyGene& gene) {
+    return static_cast<size_t>(gene.entry_condition) < kEntryCount && static_cast<size_t>(gene.exit_condition) < kExitCount &&
+           gene.entry_condition != Entry::INSIDE_BB && gene.entry_condition != Entry::OUTSIDE_BB;
+}
+
+bool GeneEvaluator::usesSecondary(const StrategyGene& gene) {
+    return usesPrimary(gene) && (gene.entry_condition == Entry::ABOVE || gene.entry_condition == Entry::BELOW ||
+                                 gene.exit_condition == Exit::INDICATOR_SIGNAL);
+}
+
+GeneEvaluator::EvaluateFn GeneEvaluator::select(const StrategyGene& gene, Precision precision) {
+    static const auto table = makeTable<double>(std::make_index_sequence<kEntryCount * kExitCount>{});
+    static const auto table_f32 = makeTable<float>(std::make_index_sequence<kEntryCount * kExitCount>{});
+    const size_t entry = static_cast<size_t>(gene.entry_condition);
+    const size_t exit = static_cast<size_t>(gene.exit_condition);
+    if (entry >= kEntryCount || exit >= kExitCount) {
+        // Unknown conditions never enter
+        return &GeneEvaluator::run<double, Entry::INSIDE_BB, Exit::FIXED_RR>;
+    }
+    return (precision == Precision::Float32 ? table_f32 : table)[entry * kExitCount + exit];
+}
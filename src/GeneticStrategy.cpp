@@ -1,5 +1,13 @@
 #include "../include/GeneticStrategy.hpp"
 #include "../include/MovingAverage.hpp"
+#include "../include/EvaluationArena.hpp"
+#include "../include/StreamingMetrics.hpp"
+#include "../include/EntryMask.hpp"
+#include "../include/GeneEvaluator.hpp"
+#include "../include/ThreadPool.hpp"
+#include "../include/FileUtils.hpp"
+#include "../include/EvolutionTelemetry.hpp"
+#include "../include/Profiler.hpp"
 #include <algorithm>
 #include <iostream>
 #include <iomanip>
@@ -8,11 +16,13 @@
 #include <numeric>
 #include <limits>
 #include <random>
-
-#ifdef USE_CUDA
-#include <cuda_runtime.h>
-extern "C" void evaluate_population_gpu(const void* h_genes, int population_size, const void* h_data, int data_size, void* h_results);
-#endif
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <chrono>
+#include <unordered_set>
+#include <functional>
+#include <filesystem>
 
 // Logging macros for extensive tracing
 #define LOG(msg)     std::cout << "[LOG] " << msg << std::endl;
@@ -47,17 +57,156 @@ enum class ExitCondition {
     COUNT  // Always last
 };
 
-StrategyGene StrategyGene::random(std::mt19937& rng) {
+namespace {
+    const char kCheckpointMagic[8] = {'G', 'A', 'C', 'K', 'P', 'T', '0', '1'};
+    const uint32_t kCheckpointVersion = 4;
+
+    // Fixed 80-byte checkpoint header (native byte order, like the bar
+    // store shards), followed by population_size gene records, the best
+    // gene, its FitnessRecord and the finalist_count screening finalists as
+    // gene records. The fitness cache is the first cache_entries
+    // CacheRecords of the log <path>.cache.<cache_epoch>: every insert in
+    // order, appended at each snapshot and compacted when evictions have
+    // doubled it, so a snapshot writes only the entries added since the last
+    struct CheckpointHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t gene_record_size;
+        uint64_t seed;
+        uint64_t data_bars;
+        uint64_t data_hash;
+        int32_t population_size;
+        int32_t next_generation;
+        uint64_t cache_entries;
+        double race_threshold;
+        int32_t precision;       // Precision of the screening generations
+        int32_t finalist_count;
+        uint64_t cache_epoch;
+    };
+    static_assert(sizeof(CheckpointHeader) == 80, "CheckpointHeader must be 80 bytes");
+
+    std::string cacheLogPath(const std::string& checkpoint, uint64_t epoch) {
+        return checkpoint + ".cache." + std::to_string(epoch);
+    }
+
+    // Fixed-width gene; with fitness zeroed it is also the fitness cache key input
+    struct GeneRecord {
+        int32_t primary_indicator;
+        int32_t secondary_indicator;
+        int32_t primary_period;
+        int32_t secondary_period;
+        double primary_threshold;
+        double secondary_threshold;
+        int32_t entry_condition;
+        int32_t exit_condition;
+        double risk_reward_ratio;
+        double stop_loss_pct;
+        double take_profit_pct;
+        int32_t max_hold_time;
+        int32_t primary_timeframe;
+        double position_size_pct;
+        int32_t secondary_timeframe;
+        int32_t reserved;
+        double fitness;
+    };
+    static_assert(sizeof(GeneRecord) == 96, "GeneRecord must be 96 bytes");
+
+    struct FitnessRecord {
+        double total_return;
+        double sharpe_ratio;
+        double max_drawdown;
+        double win_rate;
+        double profit_factor;
+        double calmar_ratio;
+        double fitness_score;
+        int64_t total_trades;
+    };
+
+    struct CacheRecord {
+        uint64_t key;
+        double fitness;
+    };
+
+    GeneRecord toRecord(const StrategyGene& g) {
+        GeneRecord r;
+        std::memset(&r, 0, sizeof(r));
+        r.primary_indicator = static_cast<int32_t>(g.primary_indicator);
+        r.secondary_indicator = static_cast<int32_t>(g.secondary_indicator);
+        r.primary_period = g.primary_period;
+        r.secondary_period = g.secondary_period;
+        r.primary_threshold = g.primary_threshold;
+        r.secondary_threshold = g.secondary_threshold;
+        r.entry_condition = static_cast<int32_t>(g.entry_condition);
+        r.exit_condition = static_cast<int32_t>(g.exit_condition);
+        r.risk_reward_ratio = g.risk_reward_ratio;
+        r.stop_loss_pct = g.stop_loss_pct;
+        r.take_profit_pct = g.take_profit_pct;
+        r.max_hold_time = g.max_hold_time;
+        r.primary_timeframe = static_cast<int32_t>(g.primary_timeframe);
+        r.position_size_pct = g.position_size_pct;
+        r.secondary_timeframe = static_cast<int32_t>(g.secondary_timeframe);
+        r.fitness = g.fitness;
+        return r;
+    }
+
+    StrategyGene fromRecord(const GeneRecord& r) {
+        StrategyGene g;
+        g.primary_indicator = static_cast<StrategyGene::IndicatorType>(r.primary_indicator);
+        g.secondary_indicator = static_cast<StrategyGene::IndicatorType>(r.secondary_indicator);
+        g.primary_period = r.primary_period;
+        g.secondary_period = r.secondary_period;
+        g.primary_threshold = r.primary_threshold;
+        g.secondary_threshold = r.secondary_threshold;
+        g.entry_condition = static_cast<StrategyGene::EntryCondition>(r.entry_condition);
+        g.exit_condition = static_cast<StrategyGene::ExitCondition>(r.exit_condition);
+        g.risk_reward_ratio = r.risk_reward_ratio;
+        g.stop_loss_pct = r.stop_loss_pct;
+        g.take_profit_pct = r.take_profit_pct;
+        g.max_hold_time = r.max_hold_time;
+        g.primary_timeframe = static_cast<Timeframe>(r.primary_timeframe);
+        g.position_size_pct = r.position_size_pct;
+        g.secondary_timeframe = static_cast<Timeframe>(r.secondary_timeframe);
+        g.fitness = r.fitness;
+        return g;
+    }
+
+    uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 1469598103934665603ULL) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    // 64-bit hash of the gene's parameters (not its fitness)
+    uint64_t geneKey(const StrategyGene& g) {
+        GeneRecord r = toRecord(g);
+        r.fitness = 0.0;
+        return fnv1a(&r, sizeof(r));
+    }
+
+    // Finalists compared in the screening report's top-k overlap
+    constexpr size_t kScreeningTopK = 10;
+
+    template <class T>
+    void append(std::string& out, const T& value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+}
+
+StrategyGene StrategyGene::random(RandomStream& rng) {
     StrategyGene g;
-    std::uniform_int_distribution<int> indicator_dist(0, static_cast<int>(IndicatorType::COUNT) - 1);
-    std::uniform_int_distribution<int> entry_dist(0, static_cast<int>(EntryCondition::COUNT) - 1);
-    std::uniform_int_distribution<int> exit_dist(0, static_cast<int>(ExitCondition::COUNT) - 1);
+    std::uniform_int_distribution<int> indicator_dist(0, static_cast<int>(::IndicatorType::COUNT) - 1);
+    std::uniform_int_distribution<int> entry_dist(0, static_cast<int>(::EntryCondition::COUNT) - 1);
+    std::uniform_int_distribution<int> exit_dist(0, static_cast<int>(::ExitCondition::COUNT) - 1);
     std::uniform_int_distribution<int> period_dist(5, 50);
     std::uniform_real_distribution<double> thr_dist(-30.0, 30.0);
     std::uniform_real_distribution<double> rr_dist(1.0, 5.0);
     std::uniform_real_distribution<double> pct_dist(0.005, 0.10);
     std::uniform_int_distribution<int> hold_dist(1, 48);
     std::uniform_real_distribution<double> size_dist(0.01, 0.3);
+    std::uniform_int_distribution<int> tf_dist(0, static_cast<int>(kTimeframeCount) - 1);
 
     g.primary_indicator   = static_cast<IndicatorType>(indicator_dist(rng));
     g.secondary_indicator = static_cast<IndicatorType>(indicator_dist(rng));
@@ -72,14 +221,16 @@ StrategyGene StrategyGene::random(std::mt19937& rng) {
     g.take_profit_pct     = pct_dist(rng);
     g.max_hold_time       = hold_dist(rng);
     g.position_size_pct   = std::clamp(size_dist(rng), 0.0001, 1.0);
+    g.primary_timeframe   = kTimeframes[tf_dist(rng)];
+    g.secondary_timeframe = kTimeframes[tf_dist(rng)];
 
     return g;
 }
 
-void StrategyGene::mutate(std::mt19937& rng, double mutation_rate) {
+void StrategyGene::mutate(RandomStream& rng, double mutation_rate) {
     std::uniform_real_distribution<double> dist(0.0, 1.0);
     std::uniform_int_distribution<int> indicator_dist(0, 7);
-    std::uniform_int_distribution<int> entry_dist(0, static_cast<int>(EntryCondition::COUNT) - 1);
+    std::uniform_int_distribution<int> entry_dist(0, static_cast<int>(::EntryCondition::COUNT) - 1);
     std::uniform_int_distribution<int> exit_dist(0, 3);
     std::uniform_int_distribution<int> period_dist(5, 20);
     std::uniform_real_distribution<double> threshold_dist(-20.0, 20.0);
@@ -87,6 +238,7 @@ void StrategyGene::mutate(std::mt19937& rng, double mutation_rate) {
     std::uniform_real_distribution<double> pct_dist(0.005, 0.05);
     std::uniform_int_distribution<int> time_dist(1, 24);
     std::uniform_real_distribution<double> size_dist(0.01, 0.3);
+    std::uniform_int_distribution<int> tf_dist(0, static_cast<int>(kTimeframeCount) - 1);
     
     if (dist(rng) < mutation_rate) primary_indicator = static_cast<IndicatorType>(indicator_dist(rng));
     if (dist(rng) < mutation_rate) secondary_indicator = static_cast<IndicatorType>(indicator_dist(rng));
@@ -101,9 +253,11 @@ void StrategyGene::mutate(std::mt19937& rng, double mutation_rate) {
     if (dist(rng) < mutation_rate) take_profit_pct = pct_dist(rng);
     if (dist(rng) < mutation_rate) max_hold_time = time_dist(rng);
     if (dist(rng) < mutation_rate) position_size_pct = size_dist(rng);
+    if (dist(rng) < mutation_rate) primary_timeframe = kTimeframes[tf_dist(rng)];
+    if (dist(rng) < mutation_rate) secondary_timeframe = kTimeframes[tf_dist(rng)];
 }
 
-StrategyGene StrategyGene::crossover(const StrategyGene& other, std::mt19937& rng) const {
+StrategyGene StrategyGene::crossover(const StrategyGene& other, RandomStream& rng) const {
     StrategyGene child;
     std::uniform_real_distribution<double> dist(0.0, 1.0);
     
@@ -120,14 +274,18 @@ StrategyGene StrategyGene::crossover(const StrategyGene& other, std::mt19937& rn
     child.take_profit_pct = (dist(rng) < 0.5) ? take_profit_pct : other.take_profit_pct;
     child.max_hold_time = (dist(rng) < 0.5) ? max_hold_time : other.max_hold_time;
     child.position_size_pct = (dist(rng) < 0.5) ? position_size_pct : other.position_size_pct;
+    child.primary_timeframe = (dist(rng) < 0.5) ? primary_timeframe : other.primary_timeframe;
+    child.secondary_timeframe = (dist(rng) < 0.5) ? secondary_timeframe : other.secondary_timeframe;
     
     return child;
 }
 
 std::string StrategyGene::toString() const {
     std::ostringstream oss;
-    oss << "Primary: " << static_cast<int>(primary_indicator) << "(" << primary_period << ") @ " << primary_threshold
-        << " | Secondary: " << static_cast<int>(secondary_indicator) << "(" << secondary_period << ") @ " << secondary_threshold
+    oss << "Primary: " << static_cast<int>(primary_indicator) << "(" << primary_period << ")/"
+        << Resampler::timeframeName(primary_timeframe) << " @ " << primary_threshold
+        << " | Secondary: " << static_cast<int>(secondary_indicator) << "(" << secondary_period << ")/"
+        << Resampler::timeframeName(secondary_timeframe) << " @ " << secondary_threshold
         << " | Entry: " << static_cast<int>(entry_condition) << " | Exit: " << static_cast<int>(exit_condition)
         << " | RR: " << risk_reward_ratio << " | SL: " << stop_loss_pct << " | TP: " << take_profit_pct
         << " | Hold: " << max_hold_time << "h | Size: " << position_size_pct;
@@ -140,62 +298,88 @@ std::string StrategyGene::toPineScript() const {
     oss << "//@version=5\n";
     oss << "strategy(\"Evolved Strategy\", overlay=true, default_qty_type=strategy.percent_of_equity, default_qty_value=" << (position_size_pct * 100) << ")\n\n";
     
+    // Pine timeframe strings for request.security
+    auto pineTimeframe = [](Timeframe tf) -> const char* {
+        switch (tf) {
+            case Timeframe::M5:  return "5";
+            case Timeframe::M15: return "15";
+            case Timeframe::H1:  return "60";
+            case Timeframe::D1:  return "D";
+            default:             return "";
+        }
+    };
+
+    // Higher-timeframe indicators are computed under a *_tf name and pulled in
+    // from the last completed bar of that timeframe
+    const std::string primary_var = primary_timeframe == Timeframe::M1 ? "primary" : "primary_tf";
+    const std::string secondary_var = secondary_timeframe == Timeframe::M1 ? "secondary" : "secondary_tf";
+    
     oss << "// Primary indicator\n";
     switch (primary_indicator) {
         case IndicatorType::SMA:
-            oss << "primary = ta.sma(close, " << primary_period << ")\n";
+            oss << primary_var << " = ta.sma(close, " << primary_period << ")\n";
             break;
         case IndicatorType::EMA:
-            oss << "primary = ta.ema(close, " << primary_period << ")\n";
+            oss << primary_var << " = ta.ema(close, " << primary_period << ")\n";
             break;
         case IndicatorType::RSI:
-            oss << "primary = ta.rsi(close, " << primary_period << ")\n";
+            oss << primary_var << " = ta.rsi(close, " << primary_period << ")\n";
             break;
         case IndicatorType::MACD:
-            oss << "primary = ta.macd(close, 12, 26, 9)\n";
+            oss << primary_var << " = ta.macd(close, 12, 26, 9)\n";
             break;
         case IndicatorType::BB:
-            oss << "primary = ta.bb(close, " << primary_period << ", 2)\n";
+            oss << primary_var << " = ta.bb(close, " << primary_period << ", 2)\n";
             break;
         case IndicatorType::ATR:
-            oss << "primary = ta.atr(" << primary_period << ")\n";
+            oss << primary_var << " = ta.atr(" << primary_period << ")\n";
             break;
         case IndicatorType::STOCH:
-            oss << "primary = ta.stoch(close, high, low, " << primary_period << ")\n";
+            oss << primary_var << " = ta.stoch(close, high, low, " << primary_period << ")\n";
             break;
         case IndicatorType::ADX:
-            oss << "primary = ta.adx(high, low, close, " << primary_period << ")\n";
+            oss << primary_var << " = ta.adx(high, low, close, " << primary_period << ")\n";
             break;
     }
     
+    if (primary_timeframe != Timeframe::M1) {
+        oss << "primary = request.security(syminfo.tickerid, \"" << pineTimeframe(primary_timeframe)
+            << "\", primary_tf[1], lookahead=barmerge.lookahead_on)\n";
+    }
+    
     oss << "\n// Secondary indicator\n";
     switch (secondary_indicator) {
         case IndicatorType::SMA:
-            oss << "secondary = ta.sma(close, " << secondary_period << ")\n";
+            oss << secondary_var << " = ta.sma(close, " << secondary_period << ")\n";
             break;
         case IndicatorType::EMA:
-            oss << "secondary = ta.ema(close, " << secondary_period << ")\n";
+            oss << secondary_var << " = ta.ema(close, " << secondary_period << ")\n";
             break;
         case IndicatorType::RSI:
-            oss << "secondary = ta.rsi(close, " << secondary_period << ")\n";
+            oss << secondary_var << " = ta.rsi(close, " << secondary_period << ")\n";
             break;
         case IndicatorType::MACD:
-            oss << "secondary = ta.macd(close, 12, 26, 9)\n";
+            oss << secondary_var << " = ta.macd(close, 12, 26, 9)\n";
             break;
         case IndicatorType::BB:
-            oss << "secondary = ta.bb(close, " << secondary_period << ", 2)\n";
+            oss << secondary_var << " = ta.bb(close, " << secondary_period << ", 2)\n";
             break;
         case IndicatorType::ATR:
-            oss << "secondary = ta.atr(" << secondary_period << ")\n";
+            oss << secondary_var << " = ta.atr(" << secondary_period << ")\n";
             break;
         case IndicatorType::STOCH:
-            oss << "secondary = ta.stoch(close, high, low, " << secondary_period << ")\n";
+            oss << secondary_var << " = ta.stoch(close, high, low, " << secondary_period << ")\n";
             break;
         case IndicatorType::ADX:
-            oss << "secondary = ta.adx(high, low, close, " << secondary_period << ")\n";
+            oss << secondary_var << " = ta.adx(high, low, close, " << secondary_period << ")\n";
             break;
     }
     
+    if (secondary_timeframe != Timeframe::M1) {
+        oss << "secondary = request.security(syminfo.tickerid, \"" << pineTimeframe(secondary_timeframe)
+            << "\", secondary_tf[1], lookahead=barmerge.lookahead_on)\n";
+    }
+    
     oss << "\n// Entry conditions\n";
     switch (entry_condition) {
         case EntryCondition::CROSS_ABOVE:
@@ -222,18 +406,20 @@ std::string StrategyGene::toPineScript() const {
     switch (exit_condition) {
         case ExitCondition::FIXED_RR:
             oss << "strategy.entry(\"Long\", strategy.long, when=longCondition)\n";
-            oss << "strategy.exit(\"Exit\", \"Long\", stop=strategy.position_avg_price * (1 - " << stop_loss_pct << "), limit=strategy.position_avg_price * (1 + " << take_profit_pct << "))\n";
+            oss << "strategy.exit(\"Exit\", \"Long\", stop=strategy.position_avg_price * (1 - " << stop_loss_pct << "), limit=strategy.position_avg_price * (1 + " << risk_reward_ratio << " * " << stop_loss_pct << "))\n";
             break;
         case ExitCondition::TRAILING_STOP:
             oss << "strategy.entry(\"Long\", strategy.long, when=longCondition)\n";
-            oss << "strategy.exit(\"Exit\", \"Long\", trail_points=close * " << stop_loss_pct << " * 10000)\n";
+            oss << "strategy.exit(\"Exit\", \"Long\", stop=strategy.position_avg_price * (1 - " << stop_loss_pct << "), trail_points=0, trail_offset=strategy.position_avg_price * " << stop_loss_pct << " / syminfo.mintick)\n";
             break;
         case ExitCondition::TIME_BASED:
             oss << "strategy.entry(\"Long\", strategy.long, when=longCondition)\n";
-            oss << "strategy.close(\"Long\", when=time - strategy.opentrades.entry_time(0) > " << max_hold_time << " * 60 * 60 * 1000)\n";
+            oss << "strategy.exit(\"Exit\", \"Long\", stop=strategy.position_avg_price * (1 - " << stop_loss_pct << "), limit=strategy.position_avg_price * (1 + " << take_profit_pct << "))\n";
+            oss << "strategy.close(\"Long\", when=bar_index - strategy.opentrades.entry_bar_index(0) >= " << max_hold_time * static_cast<int>(GeneExit::kBarsPerHour) << ")\n";
             break;
         case ExitCondition::INDICATOR_SIGNAL:
             oss << "strategy.entry(\"Long\", strategy.long, when=longCondition)\n";
+            oss << "strategy.exit(\"Exit\", \"Long\", stop=strategy.position_avg_price * (1 - " << stop_loss_pct << "), limit=strategy.position_avg_price * (1 + " << take_profit_pct << "))\n";
             oss << "strategy.close(\"Long\", when=secondary < " << secondary_threshold << ")\n";
             break;
     }
@@ -251,27 +437,84 @@ std::string FitnessResult::toString() const {
     return oss.str();
 }
 
-GeneticAlgorithm::GeneticAlgorithm(const std::vector<OHLCV>& data, int population_size, int generations, double mutation_rate, double crossover_rate)
-    : data_(data), population_size_(population_size), generations_(generations), 
-      mutation_rate_(mutation_rate), crossover_rate_(crossover_rate) {
+FitnessResult FitnessResult::fromMetrics(const StreamingMetrics& metrics) {
+    FitnessResult result;
+    result.total_return = metrics.totalReturn();
+    result.sharpe_ratio = metrics.sharpeRatio();
+    result.max_drawdown = metrics.maxDrawdown();
+    result.win_rate = metrics.winRate();
+    result.total_trades = metrics.trades();
+    result.profit_factor = metrics.profitFactor();
+    result.calmar_ratio = (result.max_drawdown > 0) ? result.total_return / result.max_drawdown : 0.0;
     
-    std::random_device rd;
-    rng_.seed(rd());
+    result.fitness_score = result.sharpe_ratio * 0.4 + result.total_return * 0.3 + 
+                          result.win_rate * 0.2 + result.profit_factor * 0.1 - 
+                          result.max_drawdown * 0.5;
+    
+    return result;
+}
+
+GeneticAlgorithm::GeneticAlgorithm(const BarView& data, int population_size, int generations, double mutation_rate, double crossover_rate,
+                                   uint64_t seed, size_t threads)
+    : data_(data), pyramid_(TimeframePyramid::build(data)),
+      evaluator_(std::make_unique<GeneEvaluator>(data_, pyramid_)), population_size_(population_size), generations_(generations), 
+      mutation_rate_(mutation_rate), crossover_rate_(crossover_rate), seed_(seed),
+      pool_(std::make_unique<ThreadPool>(threads)) {
     
-    std::cout << "[INFO] Genetic Algorithm initialized with " << data_.size() << " bars, population: " << population_size_ << ", generations: " << generations_ << std::endl;
+    // Identifies the bars in checkpoints
+    data_hash_ = fnv1a(nullptr, 0);
+    for (size_t i = 0; i < data_.size(); ++i) {
+        data_hash_ = fnv1a(&data_[i].close, sizeof(double), data_hash_);
+    }
+    
+    std::cout << "[INFO] Genetic Algorithm initialized with " << data_.size() << " bars, population: " << population_size_ << ", generations: " << generations_
+              << ", seed: " << seed_ << ", threads: " << pool_->size() << std::endl;
+}
+
+uint64_t GeneticAlgorithm::randomSeed() {
+    std::random_device rd;
+    return (static_cast<uint64_t>(rd()) << 32) | rd();
 }
 
 std::vector<StrategyGene> GeneticAlgorithm::evolve() {
     std::cout << "[INFO] Starting genetic algorithm evolution..." << std::endl;
     
-    initializePopulation();
+    if (resumed_) {
+        std::cout << "[INFO] Resuming at generation " << (generation_ + 1) << std::endl;
+        resumed_ = false;
+    } else {
+        generation_ = 0;
+        race_threshold_ = -std::numeric_limits<double>::infinity();
+        initializePopulation();
+    }
     
-    for (int generation = 0; generation < generations_; ++generation) {
-        if (generation % 10 == 0) {
-            std::cout << "[INFO] Generation " << (generation + 1) << "/" << generations_ << " (" << ((generation + 1) * 100 / generations_) << "%)" << std::endl;
+    using Clock = std::chrono::high_resolution_clock;
+    auto elapsed_ms = [](Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+
+    for (; generation_ < generations_; ++generation_) {
+        if (generation_ % 10 == 0) {
+            std::cout << "[INFO] Generation " << (generation_ + 1) << "/" << generations_ << " (" << ((generation_ + 1) * 100 / generations_) << "%)" << std::endl;
         }
         
+        PROFILE_ZONE_ARG("GA::generation", generation_ + 1);
+        GenerationStats stats;
+        stats.generation = generation_ + 1;
+        const size_t hits_before = cache_hits_, misses_before = cache_misses_, backtests_before = backtests_;
+        const size_t pruned_before = pruned_, bars_run_before = bars_run_, bars_total_before = bars_total_;
+        auto phase = Clock::now();
         evaluatePopulation();
+        stats.evaluate_ms = elapsed_ms(phase);
+        stats.cache_hits = cache_hits_ - hits_before;
+        stats.cache_misses = cache_misses_ - misses_before;
+        stats.backtests = backtests_ - backtests_before;
+        stats.pruned = pruned_ - pruned_before;
+        stats.bars_run = bars_run_ - bars_run_before;
+        if (bars_total_ > bars_total_before) {
+            stats.bars_saved = 1.0 - static_cast<double>(stats.bars_run) / (bars_total_ - bars_total_before);
+        }
+        if (telemetry_) populationStats(stats);
         
         auto best_in_gen = std::max_element(population_.begin(), population_.end(), 
             [](const StrategyGene& a, const StrategyGene& b) { return a.fitness < b.fitness; });
@@ -279,131 +522,541 @@ std::vector<StrategyGene> GeneticAlgorithm::evolve() {
         if (best_in_gen->fitness > best_strategy_.fitness) {
             best_strategy_ = *best_in_gen;
             best_fitness_ = evaluateFitness(best_strategy_);
-            std::cout << "[INFO] Generation " << (generation + 1) << " - New best strategy found!" << std::endl;
+            std::cout << "[INFO] Generation " << (generation_ + 1) << " - New best strategy found!" << std::endl;
             std::cout << "[INFO] Fitness: " << best_strategy_.fitness << std::endl;
             std::cout << "[INFO] " << best_fitness_.toString() << std::endl;
         }
         
+        phase = Clock::now();
         selectParents();
+        stats.select_ms = elapsed_ms(phase);
+        phase = Clock::now();
         crossover();
+        stats.crossover_ms = elapsed_ms(phase);
+        phase = Clock::now();
         mutate();
+        stats.mutate_ms = elapsed_ms(phase);
         elitism();
+
+        if (telemetry_) {
+            const double eval_seconds = stats.evaluate_ms / 1000.0;
+            if (eval_seconds > 0) {
+                stats.backtests_per_sec = stats.backtests / eval_seconds;
+                stats.bars_per_sec = stats.bars_run / eval_seconds;
+            }
+            telemetry_->record(stats);
+        }
+
+        // The last generation is always saved, whatever the interval
+        if (!checkpoint_path_.empty() &&
+            ((generation_ + 1) % checkpoint_every_ == 0 || generation_ + 1 == generations_)) {
+            writeCheckpoint(checkpoint_path_, generation_ + 1);
+        }
     }
     
     std::cout << "[INFO] Evolution complete! Best fitness: " << best_strategy_.fitness << std::endl;
+    if (screen_evaluator_) rescoreFinalists();
+    if (racing_) {
+        std::ostringstream saved;
+        saved << std::fixed << std::setprecision(1) << barsSavedFraction() * 100.0;
+        std::cout << "[INFO] Racing pruned " << pruned_ << " of " << backtests_ << " backtests, "
+                  << saved.str() << "% of bars saved" << std::endl;
+    }
     return population_;
 }
 
 void GeneticAlgorithm::initializePopulation() {
-    population_.clear();
-    for (int i = 0; i < population_size_; ++i) {
-        population_.push_back(StrategyGene::random(rng_));
-    }
+    PROFILE_ZONE("GA::initialize");
+    population_.assign(population_size_, StrategyGene());
+    pool_->parallelFor(population_.size(), [&](size_t i) {
+        RandomStream rng = stream(i, RandomStream::Op::Init);
+        population_[i] = StrategyGene::random(rng);
+    });
 }
 
 void GeneticAlgorithm::evaluatePopulation() {
-#ifdef USE_CUDA
-    std::vector<FitnessResult> results;
-    evaluatePopulationGPU(population_, data_, results);
-#else
-    for (auto& gene : population_) {
-        FitnessResult result = evaluateFitness(gene);
-        gene.fitness = result.fitness_score;
+    PROFILE_ZONE("GA::evaluate");
+    // Cache lookups and inserts stay on this thread; only misses are
+    // evaluated, in parallel
+    std::vector<uint64_t> keys(population_.size());
+    std::vector<size_t> misses;
+    for (size_t i = 0; i < population_.size(); ++i) {
+        keys[i] = geneKey(population_[i]);
+        auto it = fitness_cache_.find(keys[i]);
+        if (it != fitness_cache_.end()) {
+            population_[i].fitness = it->second;
+            ++cache_hits_;
+            PROFILE_EVENT("GA::cache_hit", i);
+        } else {
+            misses.push_back(i);
+        }
+    }
+    std::vector<GeneEvaluator::RaceOutcome> outcomes(misses.size());
+    if (batched_) {
+        std::vector<CudaStrategyGene> genes(misses.size());
+        std::vector<CudaFitnessResult> results(misses.size());
+        for (size_t k = 0; k < misses.size(); ++k) genes[k] = PopulationEvaluator::pack(population_[misses[k]]);
+        batch_evaluator_->evaluate(genes.data(), genes.size(), results.data(), batch_backend_);
+        for (size_t k = 0; k < misses.size(); ++k) {
+            population_[misses[k]].fitness = results[k].fitness_score;
+            outcomes[k].bars = data_.size();
+        }
+    } else {
+        // The threshold is fixed for the whole generation, so pruning does not
+        // depend on which backtests finish first
+        GeneEvaluator::RaceLimit limit;
+        limit.threshold = race_threshold_;
+        limit.blocks = race_blocks_;
+        pool_->parallelFor(misses.size(), [&](size_t k) {
+            PROFILE_ZONE_ARG("GA::backtest", misses[k]);
+            StrategyGene& gene = population_[misses[k]];
+            gene.fitness = generationEvaluator().evaluate(gene, racing_ ? &limit : nullptr, &outcomes[k]).fitness_score;
+        });
+    }
+    pruned_genes_.assign(population_.size(), false);
+    for (size_t k = 0; k < misses.size(); ++k) {
+        bars_run_ += outcomes[k].bars;
+        if (outcomes[k].pruned) {
+            // The evaluator returns an optimistic bound, which can beat
+            // evaluated genes below the top rank; rank the gene last instead
+            ++pruned_;
+            pruned_genes_[misses[k]] = true;
+            population_[misses[k]].fitness = -std::numeric_limits<double>::infinity();
+        } else {
+            cacheFitness(keys[misses[k]], population_[misses[k]].fitness);
+        }
+    }
+    bars_total_ += misses.size() * data_.size();
+    cache_misses_ += misses.size();
+    backtests_ += misses.size();
+    if (screen_evaluator_) trackFinalists(keys, pruned_genes_);
+
+    if (racing_) {
+        std::vector<double> fitness;
+        for (size_t i = 0; i < population_.size(); ++i) {
+            if (!pruned_genes_[i]) fitness.push_back(population_[i].fitness);
+        }
+        if (fitness.empty()) return;
+        const size_t rank = std::min(std::max<size_t>(race_rank_, 1), fitness.size());
+        std::nth_element(fitness.begin(), fitness.begin() + (rank - 1), fitness.end(), std::greater<double>());
+        race_threshold_ = fitness[rank - 1];
+    }
+}
+
+void GeneticAlgorithm::setRacing(bool enabled, size_t blocks, size_t rank) {
+    racing_ = enabled;
+    race_blocks_ = std::max<size_t>(blocks, 1);
+    race_rank_ = std::max<size_t>(rank, 1);
+    if (racing_ && batched_) {
+        std::cout << "[WARNING] Racing does not apply to batched evaluation; batches run every backtest in full" << std::endl;
+    }
+}
+
+bool GeneticAlgorithm::setBatchEvaluation(bool enabled, PopulationBackend backend) {
+    if (enabled && backend == PopulationBackend::Cuda) {
+        // evaluate_population_gpu still enters on its placeholder rule, so
+        // its fitness has nothing to do with the gene
+        ERROR("The CUDA population kernel does not implement gene semantics; batch evaluation stays off");
+        batched_ = false;
+        return false;
+    }
+    batched_ = enabled;
+    batch_backend_ = backend;
+    if (enabled && !batch_evaluator_) {
+        batch_evaluator_ = std::make_unique<PopulationEvaluator>(data_, generationEvaluator(), *pool_);
+    }
+    if (racing_ && batched_) {
+        std::cout << "[WARNING] Racing does not apply to batched evaluation; batches run every backtest in full" << std::endl;
+    }
+    return true;
+}
+
+void GeneticAlgorithm::setScreening(Precision precision, size_t finalists) {
+    finalist_count_ = std::max<size_t>(finalists, 1);
+    finalists_.clear();
+    screening_report_ = ScreeningReport();
+    if (precision == Precision::Float32) {
+        if (!screen_evaluator_) screen_evaluator_ = std::make_unique<GeneEvaluator>(data_, pyramid_, Precision::Float32);
+    } else {
+        screen_evaluator_.reset();
+    }
+    // Batches run on the generation evaluator
+    if (batch_evaluator_) batch_evaluator_ = std::make_unique<PopulationEvaluator>(data_, generationEvaluator(), *pool_);
+}
+
+const GeneEvaluator& GeneticAlgorithm::generationEvaluator() const {
+    return screen_evaluator_ ? *screen_evaluator_ : *evaluator_;
+}
+
+void GeneticAlgorithm::trackFinalists(const std::vector<uint64_t>& keys, const std::vector<bool>& skip) {
+    auto better = [](const std::pair<uint64_t, StrategyGene>& a, const std::pair<uint64_t, StrategyGene>& b) {
+        return a.second.fitness > b.second.fitness;
+    };
+    for (size_t i = 0; i < population_.size(); ++i) {
+        const StrategyGene& gene = population_[i];
+        if (skip[i] || std::isnan(gene.fitness)) continue;
+        if (finalists_.size() >= finalist_count_ && gene.fitness <= finalists_.back().second.fitness) continue;
+        auto seen = std::find_if(finalists_.begin(), finalists_.end(),
+                                 [&](const auto& f) { return f.first == keys[i]; });
+        if (seen != finalists_.end()) continue;
+        finalists_.emplace(std::upper_bound(finalists_.begin(), finalists_.end(), std::make_pair(keys[i], gene), better),
+                           keys[i], gene);
+        if (finalists_.size() > finalist_count_) finalists_.pop_back();
+    }
+}
+
+void GeneticAlgorithm::rescoreFinalists() {
+    PROFILE_ZONE("GA::rescore_finalists");
+    if (finalists_.empty()) return;
+    const size_t n = finalists_.size();
+    std::vector<FitnessResult> results(n);
+    pool_->parallelFor(n, [&](size_t k) { results[k] = evaluator_->evaluate(finalists_[k].second); });
+
+    std::vector<double> screened(n), reference(n);
+    size_t best = 0;
+    for (size_t k = 0; k < n; ++k) {
+        screened[k] = finalists_[k].second.fitness;
+        reference[k] = results[k].fitness_score;
+        if (reference[k] > reference[best]) best = k;
+    }
+    screening_report_ = ScreeningReport::compare(screened, reference, kScreeningTopK);
+    best_strategy_ = finalists_[best].second;
+    best_strategy_.fitness = reference[best];
+    best_fitness_ = results[best];
+
+    std::cout << "[INFO] Re-scored " << n << " float32 finalists in float64, best fitness: "
+              << best_strategy_.fitness << " (screened " << screened[best] << ")" << std::endl;
+    std::cout << "[INFO] " << screening_report_.toString() << std::endl;
+    if (!screening_report_.within()) {
+        std::cout << "[WARNING] Float32 screening disagrees with float64 beyond the bounds; "
+                     "the best strategy comes from the float64 scores" << std::endl;
+    }
+}
+
+double GeneticAlgorithm::barsSavedFraction() const {
+    return bars_total_ ? 1.0 - static_cast<double>(bars_run_) / bars_total_ : 0.0;
+}
+
+void GeneticAlgorithm::populationStats(GenerationStats& stats) const {
+    if (population_.empty()) return;
+    // Fitness statistics over evaluated genes only: pruned ones have none
+    std::vector<double> fitness;
+    std::unordered_set<uint64_t> distinct;
+    double sum = 0.0;
+    for (size_t i = 0; i < population_.size(); ++i) {
+        distinct.insert(geneKey(population_[i]));
+        if (i < pruned_genes_.size() && pruned_genes_[i]) continue;
+        fitness.push_back(population_[i].fitness);
+        sum += population_[i].fitness;
+    }
+    stats.diversity = static_cast<double>(distinct.size()) / population_.size();
+    if (fitness.empty()) return;
+    std::sort(fitness.begin(), fitness.end());
+    const size_t n = fitness.size();
+    stats.best_fitness = fitness.back();
+    stats.mean_fitness = sum / n;
+    stats.median_fitness = (n % 2) ? fitness[n / 2] : 0.5 * (fitness[n / 2 - 1] + fitness[n / 2]);
+}
+
+void GeneticAlgorithm::cacheFitness(uint64_t key, double fitness) {
+    // A gene can appear twice among one generation's misses
+    if (!fitness_cache_.emplace(key, fitness).second) return;
+    cache_order_.push_back(key);
+    ++cache_unlogged_;
+    while (cache_order_.size() > cache_limit_) {
+        fitness_cache_.erase(cache_order_.front());
+        cache_order_.pop_front();
+    }
+}
+
+void GeneticAlgorithm::setFitnessCacheLimit(size_t entries) {
+    cache_limit_ = std::max<size_t>(entries, 1);
+    while (cache_order_.size() > cache_limit_) {
+        fitness_cache_.erase(cache_order_.front());
+        cache_order_.pop_front();
+    }
+}
+
+void GeneticAlgorithm::setTelemetry(const std::string& path, bool append) {
+    // Rows are 1-based: generation_ rows precede the next one to run
+    telemetry_ = std::make_unique<EvolutionTelemetry>(path, append, generation_);
+    if (!telemetry_->isOpen()) telemetry_.reset();
+}
+
+void GeneticAlgorithm::setCheckpoint(const std::string& path, int every) {
+    checkpoint_path_ = path;
+    checkpoint_every_ = std::max(every, 1);
+}
+
+bool GeneticAlgorithm::saveCheckpoint(const std::string& path) {
+    return writeCheckpoint(path, generation_);
+}
+
+bool GeneticAlgorithm::writeCheckpoint(const std::string& path, int next_generation) {
+    PROFILE_ZONE("GA::checkpoint");
+    // Inserts since the last snapshot are the newest cache_unlogged_ entries
+    // of cache_order_ unless some were already evicted; then, or when the
+    // log is another checkpoint's or twice the cache, start a compact log
+    const size_t logged = cache_logged_ + cache_unlogged_;
+    const bool compact = path != cache_log_path_ || cache_unlogged_ > cache_order_.size() ||
+                         logged > 2 * cache_order_.size();
+    const uint64_t epoch = compact ? cache_log_epoch_ + 1 : cache_log_epoch_;
+    const size_t first = compact ? 0 : cache_order_.size() - cache_unlogged_;
+    std::string log;
+    log.reserve((cache_order_.size() - first) * sizeof(CacheRecord));
+    for (size_t i = first; i < cache_order_.size(); ++i) {
+        append(log, CacheRecord{cache_order_[i], fitness_cache_.at(cache_order_[i])});
     }
-#endif
+    const bool log_ok = compact ? FileUtils::atomicWrite(cacheLogPath(path, epoch), log)
+                                : FileUtils::durableAppend(cacheLogPath(path, epoch), log);
+    if (!log_ok) {
+        ERROR("Could not write checkpoint cache log " << cacheLogPath(path, epoch));
+        // A partial append leaves the log out of step: compact next time
+        cache_log_path_.clear();
+        return false;
+    }
+
+    CheckpointHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kCheckpointMagic, sizeof(kCheckpointMagic));
+    header.version = kCheckpointVersion;
+    header.gene_record_size = sizeof(GeneRecord);
+    header.seed = seed_;
+    header.data_bars = data_.size();
+    header.data_hash = data_hash_;
+    header.population_size = static_cast<int32_t>(population_.size());
+    header.next_generation = next_generation;
+    header.cache_entries = compact ? cache_order_.size() : logged;
+    header.cache_epoch = epoch;
+    header.race_threshold = race_threshold_;
+    header.precision = static_cast<int32_t>(screen_evaluator_ ? Precision::Float32 : Precision::Float64);
+    header.finalist_count = static_cast<int32_t>(finalists_.size());
+
+    std::string bytes;
+    bytes.reserve(sizeof(header) + (population_.size() + 1 + finalists_.size()) * sizeof(GeneRecord) +
+                  sizeof(FitnessRecord));
+    append(bytes, header);
+    for (const auto& gene : population_) append(bytes, toRecord(gene));
+    append(bytes, toRecord(best_strategy_));
+    append(bytes, FitnessRecord{best_fitness_.total_return, best_fitness_.sharpe_ratio, best_fitness_.max_drawdown,
+                                best_fitness_.win_rate, best_fitness_.profit_factor, best_fitness_.calmar_ratio,
+                                best_fitness_.fitness_score, best_fitness_.total_trades});
+    for (const auto& finalist : finalists_) append(bytes, toRecord(finalist.second));
+
+    if (!FileUtils::atomicWrite(path, bytes)) {
+        ERROR("Could not write checkpoint " << path);
+        cache_log_path_.clear();
+        return false;
+    }
+    if (compact && path == cache_log_path_) {
+        std::error_code ec;
+        std::filesystem::remove(cacheLogPath(path, cache_log_epoch_), ec);
+    }
+    cache_log_path_ = path;
+    cache_log_epoch_ = epoch;
+    cache_logged_ = header.cache_entries;
+    cache_unlogged_ = 0;
+    return true;
 }
 
+bool GeneticAlgorithm::resume(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        ERROR("Could not open checkpoint " << path);
+        return false;
+    }
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    CheckpointHeader header;
+    if (bytes.size() < sizeof(header)) {
+        ERROR("Checkpoint " << path << " is truncated");
+        return false;
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, kCheckpointMagic, sizeof(kCheckpointMagic)) != 0 ||
+        header.version != kCheckpointVersion || header.gene_record_size != sizeof(GeneRecord)) {
+        ERROR("Checkpoint " << path << " has an unsupported format");
+        return false;
+    }
+    if (header.data_bars != data_.size() || header.data_hash != data_hash_) {
+        ERROR("Checkpoint " << path << " was taken over different bars");
+        return false;
+    }
+    const Precision precision = screen_evaluator_ ? Precision::Float32 : Precision::Float64;
+    if (header.precision != static_cast<int32_t>(precision)) {
+        ERROR("Checkpoint " << path << " was screened in "
+              << (header.precision == static_cast<int32_t>(Precision::Float32) ? "float32" : "float64")
+              << ", this run in " << (precision == Precision::Float32 ? "float32" : "float64"));
+        return false;
+    }
+    if (header.population_size != population_size_) {
+        ERROR("Checkpoint " << path << " has population " << header.population_size
+              << ", expected " << population_size_);
+        return false;
+    }
+    const size_t expected = sizeof(header) +
+                            (header.population_size + 1 + static_cast<size_t>(header.finalist_count)) * sizeof(GeneRecord) +
+                            sizeof(FitnessRecord);
+    if (bytes.size() != expected) {
+        ERROR("Checkpoint " << path << " is " << bytes.size() << " bytes, expected " << expected);
+        return false;
+    }
+    // Entries past cache_entries were appended by a snapshot that never
+    // completed; they are cut off below
+    const std::string log_path = cacheLogPath(path, header.cache_epoch);
+    std::ifstream log_in(log_path, std::ios::binary);
+    std::string log((std::istreambuf_iterator<char>(log_in)), std::istreambuf_iterator<char>());
+    const size_t log_bytes = header.cache_entries * sizeof(CacheRecord);
+    if (log.size() < log_bytes) {
+        ERROR("Checkpoint cache log " << log_path << " is " << log.size() << " bytes, expected at least " << log_bytes);
+        return false;
+    }
+
+    const char* p = bytes.data() + sizeof(header);
+    auto read = [&p](auto& value) {
+        std::memcpy(&value, p, sizeof(value));
+        p += sizeof(value);
+    };
+    GeneRecord record;
+    population_.clear();
+    for (int32_t i = 0; i < header.population_size; ++i) {
+        read(record);
+        population_.push_back(fromRecord(record));
+    }
+    read(record);
+    best_strategy_ = fromRecord(record);
+    FitnessRecord fitness;
+    read(fitness);
+    best_fitness_ = FitnessResult();
+    best_fitness_.total_return = fitness.total_return;
+    best_fitness_.sharpe_ratio = fitness.sharpe_ratio;
+    best_fitness_.max_drawdown = fitness.max_drawdown;
+    best_fitness_.win_rate = fitness.win_rate;
+    best_fitness_.profit_factor = fitness.profit_factor;
+    best_fitness_.calmar_ratio = fitness.calmar_ratio;
+    best_fitness_.fitness_score = fitness.fitness_score;
+    best_fitness_.total_trades = static_cast<int>(fitness.total_trades);
+    fitness_cache_.clear();
+    cache_order_.clear();
+    fitness_cache_.reserve(header.cache_entries);
+    // Replaying the inserts through the same limit rebuilds the same cache
+    for (uint64_t i = 0; i < header.cache_entries; ++i) {
+        CacheRecord entry;
+        std::memcpy(&entry, log.data() + i * sizeof(CacheRecord), sizeof(entry));
+        cacheFitness(entry.key, entry.fitness);
+    }
+    std::error_code ec;
+    if (log.size() > log_bytes) std::filesystem::resize_file(log_path, log_bytes, ec);
+    cache_log_path_ = ec ? std::string() : path;
+    cache_log_epoch_ = header.cache_epoch;
+    cache_logged_ = header.cache_entries;
+    cache_unlogged_ = 0;
+    // Best first; a smaller finalist count than the saved run keeps the top
+    finalists_.clear();
+    for (int32_t i = 0; i < header.finalist_count; ++i) {
+        read(record);
+        StrategyGene gene = fromRecord(record);
+        if (finalists_.size() < finalist_count_) finalists_.emplace_back(geneKey(gene), gene);
+    }
+
+    seed_ = header.seed;
+    generation_ = header.next_generation;
+    race_threshold_ = header.race_threshold;
+    resumed_ = true;
+    INFO("Resumed checkpoint " << path << ": generation " << generation_ << ", seed " << seed_
+         << ", " << fitness_cache_.size() << " cached fitness values");
+    return true;
+}
+
+GeneticAlgorithm::~GeneticAlgorithm() = default;
+
 FitnessResult GeneticAlgorithm::evaluateFitness(const StrategyGene& gene) {
-    EvolvedStrategy strategy(gene);
-    DEBUG("Evaluating fitness for strategy gene");
-    std::vector<double> equity_curve;
-    std::vector<double> returns;
-    std::vector<double> profits, losses;
+    return evaluator_->evaluate(gene);
+}
+
+FitnessResult GeneticAlgorithm::evaluateFitnessGeneric(const StrategyGene& gene) {
+    // Indicator series come from this thread's arena, released on the next
+    // evaluation
+    EvaluationArena& arena = EvaluationArena::forThread(EvaluationArena::bytesFor(data_.size()));
+    arena.reset();
+    std::pmr::memory_resource* scratch = arena.resource();
+
+    EvolvedStrategy strategy(gene, &pyramid_, scratch);
+    // Metrics are accumulated bar by bar instead of storing the equity curve
+    StreamingMetrics metrics(10000.0);
     double current_equity = 10000.0;
-    int winning_trades = 0;
-    int total_trades = 0;
-    for (size_t i = 0; i < data_.size(); ++i) {
+    // Only bars set in the entry mask can trade; equity is flat in between
+    const size_t n = data_.size();
+    const auto& mask = strategy.entryMask(data_);
+    size_t next_bar = 0;
+    EntryMask::forEachSetBit(mask.data(), mask.size(), [&](size_t i) {
+        metrics.addEquityRun(current_equity, i - next_bar);
         TradeSignal signal = strategy.generateSignal(data_, i);
         if (signal.type == SignalType::BUY) {
             double entry_price = data_[i].close;
-            double stop_loss = signal.stop_loss;
-            double take_profit = signal.take_profit;
-            LOG("Trade signal at bar " << i << ": entry=" << entry_price << ", SL=" << stop_loss << ", TP=" << take_profit);
-            for (size_t j = i + 1; j < data_.size(); ++j) {
-                if (data_[j].low <= stop_loss || data_[j].high >= take_profit) {
-                    double exit_price = (data_[j].low <= stop_loss) ? stop_loss : take_profit;
-                    double trade_return = (exit_price - entry_price) / entry_price;
-                    if (trade_return > 0) {
-                        LOG("Winning trade: entry=" << entry_price << ", exit=" << exit_price << ", return=" << trade_return);
-                        winning_trades++;
-                        profits.push_back(trade_return);
-                    } else {
-                        LOG("Losing trade: entry=" << entry_price << ", exit=" << exit_price << ", return=" << trade_return);
-                        losses.push_back(-trade_return);
-                    }
-                    total_trades++;
+            Position position;
+            position.open(i, entry_price, signal.stop_loss, signal.take_profit, signal.exit);
+            ExitFill fill;
+            for (size_t j = i + 1; j < n; ++j) {
+                if (position.step(j, data_[j].high, data_[j].low, data_[j].close, fill)) {
+                    double trade_return = (fill.price - entry_price) / entry_price;
+                    metrics.addTrade(trade_return);
                     current_equity *= (1 + trade_return * gene.position_size_pct);
                     break;
                 }
             }
         }
-        equity_curve.push_back(current_equity);
-        if (i > 0) {
-            returns.push_back((current_equity - equity_curve[i-1]) / equity_curve[i-1]);
-        }
-    }
-    
-    FitnessResult result;
-    result.total_return = (current_equity - 10000.0) / 10000.0;
-    result.sharpe_ratio = calculateSharpeRatio(returns);
-    result.max_drawdown = calculateMaxDrawdown(equity_curve);
-    result.win_rate = (total_trades > 0) ? static_cast<double>(winning_trades) / total_trades : 0.0;
-    result.total_trades = total_trades;
-    result.profit_factor = calculateProfitFactor(profits, losses);
-    result.calmar_ratio = (result.max_drawdown > 0) ? result.total_return / result.max_drawdown : 0.0;
-    
-    result.fitness_score = result.sharpe_ratio * 0.4 + result.total_return * 0.3 + 
-                          result.win_rate * 0.2 + result.profit_factor * 0.1 - 
-                          result.max_drawdown * 0.5;
-    
-    return result;
+        metrics.addEquity(current_equity);
+        next_bar = i + 1;
+    });
+    metrics.addEquityRun(current_equity, n - next_bar);
+    return FitnessResult::fromMetrics(metrics);
 }
 
+// Each slot of the next population draws from its own stream, so the
+// steps below can run in any order on any number of threads
 void GeneticAlgorithm::selectParents() {
-    std::vector<StrategyGene> new_population;
-    std::uniform_int_distribution<int> dist(0, population_size_ - 1);
+    PROFILE_ZONE("GA::select");
+    std::vector<StrategyGene> new_population(population_.size());
     
-    for (int i = 0; i < population_size_; ++i) {
-        int best_idx = dist(rng_);
+    pool_->parallelFor(new_population.size(), [&](size_t i) {
+        RandomStream rng = stream(i, RandomStream::Op::Select);
+        std::uniform_int_distribution<int> dist(0, population_size_ - 1);
+        int best_idx = dist(rng);
         for (int j = 0; j < 2; ++j) {
-            int candidate = dist(rng_);
+            int candidate = dist(rng);
             if (population_[candidate].fitness > population_[best_idx].fitness) {
                 best_idx = candidate;
             }
         }
-        new_population.push_back(population_[best_idx]);
-    }
+        new_population[i] = population_[best_idx];
+    });
     
-    population_ = new_population;
+    population_ = std::move(new_population);
 }
 
 void GeneticAlgorithm::crossover() {
-    std::uniform_real_distribution<double> dist(0.0, 1.0);
-    
-    for (int i = 0; i < population_size_ - 1; i += 2) {
-        if (dist(rng_) < crossover_rate_) {
-            StrategyGene child1 = population_[i].crossover(population_[i + 1], rng_);
-            StrategyGene child2 = population_[i + 1].crossover(population_[i], rng_);
+    PROFILE_ZONE("GA::crossover");
+    // One stream per pair (i, i + 1)
+    pool_->parallelFor(population_.size() / 2, [&](size_t pair) {
+        const size_t i = pair * 2;
+        RandomStream rng = stream(pair, RandomStream::Op::Crossover);
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        if (dist(rng) < crossover_rate_) {
+            StrategyGene child1 = population_[i].crossover(population_[i + 1], rng);
+            StrategyGene child2 = population_[i + 1].crossover(population_[i], rng);
             population_[i] = child1;
             population_[i + 1] = child2;
         }
-    }
+    });
 }
 
 void GeneticAlgorithm::mutate() {
-    for (auto& gene : population_) {
-        gene.mutate(rng_, mutation_rate_);
-    }
+    PROFILE_ZONE("GA::mutate");
+    pool_->parallelFor(population_.size(), [&](size_t i) {
+        RandomStream rng = stream(i, RandomStream::Op::Mutate);
+        population_[i].mutate(rng, mutation_rate_);
+    });
 }
 
 void GeneticAlgorithm::elitism() {
@@ -423,88 +1076,73 @@ std::string GeneticAlgorithm::exportBestToPineScript() const {
     return best_strategy_.toPineScript();
 }
 
-double GeneticAlgorithm::calculateSharpeRatio(const std::vector<double>& returns) {
-    if (returns.empty()) return 0.0;
-    
-    double mean = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
-    double variance = 0.0;
-    for (double ret : returns) {
-        variance += (ret - mean) * (ret - mean);
-    }
-    variance /= returns.size();
-    
-    double std_dev = std::sqrt(variance);
-    return (std_dev > 0) ? mean / std_dev : 0.0;
-}
-
-double GeneticAlgorithm::calculateMaxDrawdown(const std::vector<double>& equity_curve) {
-    if (equity_curve.empty()) return 0.0;
-    
-    double max_dd = 0.0;
-    double peak = equity_curve[0];
-    
-    for (double equity : equity_curve) {
-        if (equity > peak) {
-            peak = equity;
-        }
-        double dd = (peak - equity) / peak;
-        if (dd > max_dd) {
-            max_dd = dd;
-        }
-    }
-    
-    return max_dd;
-}
-
-double GeneticAlgorithm::calculateProfitFactor(const std::vector<double>& profits, const std::vector<double>& losses) {
-    double total_profit = std::accumulate(profits.begin(), profits.end(), 0.0);
-    double total_loss = std::accumulate(losses.begin(), losses.end(), 0.0);
-    
-    return (total_loss > 0) ? total_profit / total_loss : (total_profit > 0) ? 1000.0 : 0.0;
-}
+EvolvedStrategy::EvolvedStrategy(const StrategyGene& gene, const TimeframePyramid* pyramid,
+                                 std::pmr::memory_resource* resource)
+    : gene_(gene), pyramid_(pyramid), primary_values_(resource), secondary_values_(resource),
+      entry_mask_(resource) {}
 
-EvolvedStrategy::EvolvedStrategy(const StrategyGene& gene) : gene_(gene) {}
-
-TradeSignal EvolvedStrategy::generateSignal(const std::vector<OHLCV>& data, size_t current_index) {
-    DEBUG("generateSignal called for index " << current_index);
+TradeSignal EvolvedStrategy::generateSignal(const BarView& data, size_t current_index) {
     if (!precomputed_) {
-        DEBUG("Precomputing indicators");
         precomputeIndicators(data);
     }
-    if (current_index < std::max(gene_.primary_period, gene_.secondary_period)) {
-        DEBUG("Not enough data for index " << current_index << ", required: " << std::max(gene_.primary_period, gene_.secondary_period));
-        return {SignalType::NONE, current_index, 0.0, 0.0, "Not enough data"};
+    if (current_index < static_cast<size_t>(std::max(gene_.primary_period, gene_.secondary_period))) {
+        return {SignalType::NONE, current_index, 0.0, 0.0, "Not enough data", ExitSpec{}};
     }
-    if (checkEntryCondition(data, current_index)) {
-        double stop_loss = calculateStopLoss(data, current_index);
-        double take_profit = calculateTakeProfit(data, current_index);
-        DEBUG("Signal generated: BUY at index " << current_index << ", SL: " << stop_loss << ", TP: " << take_profit);
+    if (current_index < data.size() && EntryMask::test(entry_mask_.data(), current_index)) {
+        GeneExit exit = GeneExit::forGene(gene_, data[current_index].close, secondary_values_.data());
         return {
             SignalType::BUY,
             current_index,
-            stop_loss,
-            take_profit,
-            "Evolved Strategy Signal"
+            exit.stop,
+            exit.target,
+            "Evolved Strategy Signal",
+            exit.spec
         };
-    } else {
-        DEBUG("No entry condition met at index " << current_index);
     }
-    return {SignalType::NONE, current_index, 0.0, 0.0, "No signal"};
+    return {SignalType::NONE, current_index, 0.0, 0.0, "No signal", ExitSpec{}};
 }
 
-void EvolvedStrategy::precomputeIndicators(const std::vector<OHLCV>& data) {
+void EvolvedStrategy::precomputeIndicators(const BarView& data) {
     primary_values_.resize(data.size());
     secondary_values_.resize(data.size());
-    
+    indicatorSeries(data, gene_.primary_indicator, gene_.primary_period, gene_.primary_timeframe, primary_values_.data());
+    indicatorSeries(data, gene_.secondary_indicator, gene_.secondary_period, gene_.secondary_timeframe, secondary_values_.data());
+
+    entry_mask_.resize(EntryMask::wordsFor(data.size()));
+    EntryMask::build(gene_.entry_condition, primary_values_.data(), secondary_values_.data(), data.size(),
+                     gene_.primary_threshold, gene_.secondary_threshold,
+                     static_cast<size_t>(std::max(gene_.primary_period, gene_.secondary_period)),
+                     entry_mask_.data());
+    precomputed_ = true;
+}
+
+const std::pmr::vector<uint64_t>& EvolvedStrategy::entryMask(const BarView& data) {
+    if (!precomputed_) {
+        precomputeIndicators(data);
+    }
+    return entry_mask_;
+}
+
+void EvolvedStrategy::indicatorSeries(const BarView& data, StrategyGene::IndicatorType type, int period, Timeframe tf, double* out) {
+    if (tf != Timeframe::M1) {
+        if (!pyramid_ || !pyramid_->builtFrom(data)) {
+            own_pyramid_ = std::make_unique<TimeframePyramid>(TimeframePyramid::build(data));
+            pyramid_ = own_pyramid_.get();
+        }
+        BarView bars = pyramid_->view(tf);
+        std::pmr::vector<double> values(bars.size(), primary_values_.get_allocator());
+        for (size_t k = 0; k < bars.size(); ++k) {
+            values[k] = calculateIndicator(bars, k, type, period);
+        }
+        pyramid_->alignToBase(tf, values.data(), values.size(), out);
+        return;
+    }
     for (size_t i = 0; i < data.size(); ++i) {
-        primary_values_[i] = calculateIndicator(data, i, gene_.primary_indicator, gene_.primary_period);
-        secondary_values_[i] = calculateIndicator(data, i, gene_.secondary_indicator, gene_.secondary_period);
+        out[i] = calculateIndicator(data, i, type, period);
     }
-    
-    precomputed_ = true;
 }
 
-double EvolvedStrategy::calculateIndicator(const std::vector<OHLCV>& data, size_t index, StrategyGene::IndicatorType type, int period) {
+double EvolvedStrategy::calculateIndicator(const BarView& data, size_t index, StrategyGene::IndicatorType type, int period) {
     switch (type) {
         case StrategyGene::IndicatorType::SMA:
             return Indicators::SMA(data, index, period);
@@ -514,108 +1152,3 @@ double EvolvedStrategy::calculateIndicator(const std::vector<OHLCV>& data, size_
             return 0.0;
     }
 }
-
-bool EvolvedStrategy::checkEntryCondition(const std::vector<OHLCV>& data, size_t index) {
-    double primary_val = primary_values_[index];
-    double secondary_val = secondary_values_[index];
-    double close = data[index].close;
-    DEBUG("checkEntryCondition: index=" << index << ", primary_val=" << primary_val << ", secondary_val=" << secondary_val << ", close=" << close);
-    switch (gene_.entry_condition) {
-        case StrategyGene::EntryCondition::CROSS_ABOVE:
-            if (primary_val > gene_.primary_threshold && primary_values_[index-1] <= gene_.primary_threshold) {
-                DEBUG("CROSS_ABOVE condition met");
-                return true;
-            }
-            break;
-        case StrategyGene::EntryCondition::CROSS_BELOW:
-            if (primary_val < gene_.primary_threshold && primary_values_[index-1] >= gene_.primary_threshold) {
-                DEBUG("CROSS_BELOW condition met");
-                return true;
-            }
-            break;
-        case StrategyGene::EntryCondition::ABOVE:
-            if (primary_val > gene_.primary_threshold && secondary_val > gene_.secondary_threshold) {
-                DEBUG("ABOVE condition met");
-                return true;
-            }
-            break;
-        case StrategyGene::EntryCondition::BELOW:
-            if (primary_val < gene_.primary_threshold && secondary_val < gene_.secondary_threshold) {
-                DEBUG("BELOW condition met");
-                return true;
-            }
-            break;
-        default:
-            DEBUG("No entry condition met for index " << index);
-            break;
-    }
-    return false;
-}
-
-double EvolvedStrategy::calculateStopLoss(const std::vector<OHLCV>& data, size_t index) {
-    return data[index].close * (1.0 - gene_.stop_loss_pct);
-}
-
-double EvolvedStrategy::calculateTakeProfit(const std::vector<OHLCV>& data, size_t index) {
-    return data[index].close * (1.0 + gene_.take_profit_pct);
-}
-
-#ifdef USE_CUDA
-#include <cstring>
-struct CudaOHLCV {
-    double open, high, low, close, volume;
-};
-struct CudaStrategyGene {
-    int primary_indicator;
-    int secondary_indicator;
-    int primary_period;
-    int secondary_period;
-    double primary_threshold;
-    double secondary_threshold;
-    int entry_condition;
-    int exit_condition;
-    double risk_reward_ratio;
-    double stop_loss_pct;
-    double take_profit_pct;
-    int max_hold_time;
-    double position_size_pct;
-};
-struct CudaFitnessResult {
-    double total_return;
-    double sharpe_ratio;
-    double max_drawdown;
-    double win_rate;
-    int total_trades;
-    double profit_factor;
-    double calmar_ratio;
-    double fitness_score;
-};
-void evaluatePopulationGPU(std::vector<StrategyGene>& population, const std::vector<OHLCV>& data, std::vector<FitnessResult>& results) {
-    int pop_size = population.size();
-    int data_size = data.size();
-    std::vector<CudaStrategyGene> cuda_genes(pop_size);
-    std::vector<CudaOHLCV> cuda_data(data_size);
-    for (int i = 0; i < pop_size; ++i) {
-        const auto& g = population[i];
-        cuda_genes[i] = { (int)g.primary_indicator, (int)g.secondary_indicator, g.primary_period, g.secondary_period, g.primary_threshold, g.secondary_threshold, (int)g.entry_condition, (int)g.exit_condition, g.risk_reward_ratio, g.stop_loss_pct, g.take_profit_pct, g.max_hold_time, g.position_size_pct };
-    }
-    for (int i = 0; i < data_size; ++i) {
-        const auto& d = data[i];
-        cuda_data[i] = { d.open, d.high, d.low, d.close, d.volume };
-    }
-    std::vector<CudaFitnessResult> cuda_results(pop_size);
-    evaluate_population_gpu(cuda_genes.data(), pop_size, cuda_data.data(), data_size, cuda_results.data());
-    results.resize(pop_size);
-    for (int i = 0; i < pop_size; ++i) {
-        results[i].total_return = cuda_results[i].total_return;
-        results[i].sharpe_ratio = cuda_results[i].sharpe_ratio;
-        results[i].max_drawdown = cuda_results[i].max_drawdown;
-        results[i].win_rate = cuda_results[i].win_rate;
-        results[i].total_trades = cuda_results[i].total_trades;
-        results[i].profit_factor = cuda_results[i].profit_factor;
-        results[i].calmar_ratio = cuda_results[i].calmar_ratio;
-        results[i].fitness_score = cuda_results[i].fitness_score;
-        population[i].fitness = cuda_results[i].fitness_score;
-    }
-}
-#endif
\ No newline at end of file
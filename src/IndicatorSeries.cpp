@@ -0,0 +1,692 @@
+#include "../include/IndicatorSeries.hpp"
+#include "../include/IndicatorKernels.hpp"
+#include "../include/MovingAverage.hpp"
+#ifdef USE_CUDA
+#include "../include/GPUStrategy.hpp"
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#ifdef COMPUTE_X86
+#include <immintrin.h>
+#endif
+
+namespace Indicators {
+namespace Series {
+
+namespace {
+    using Kernels::ArrayClose;
+    using Kernels::kSumLanes;
+
+    template <class T>
+    void smaScalar(const T* close, size_t n, size_t period, T* out) {
+        for (size_t i = 0; i < n; ++i) out[i] = Kernels::sma(ArrayClose{close}, i, period);
+    }
+
+    template <class T>
+    void rsiScalar(const T* close, size_t n, size_t period, T* out) {
+        for (size_t i = 0; i < n; ++i) out[i] = Kernels::rsi(ArrayClose{close}, i, period);
+    }
+
+    template <class T>
+    void fvgScalar(const T* high, const T* low, size_t n, uint8_t* out) {
+        if (n) out[0] = 0;
+        for (size_t i = 1; i < n; ++i) out[i] = Kernels::fvg(high[i - 1], low[i - 1], high[i], low[i]);
+    }
+
+#ifdef COMPUTE_X86
+    static_assert(kSumLanes == 4, "the AVX2 sums are written out for four lanes");
+
+    // Vector lane j holds bar first + j. The window sums follow the
+    // reference laneSum: accumulator k takes window elements k, k + 4, ...,
+    // then the four are folded left to right and the remainder added.
+    COMPUTE_TARGET_AVX2 inline __m256d laneSum4(const double* window, size_t count) {
+        __m256d s0 = _mm256_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+        const size_t body = count & ~size_t(3);
+        for (size_t k = 0; k < body; k += 4) {
+            s0 = _mm256_add_pd(s0, _mm256_loadu_pd(window + k));
+            s1 = _mm256_add_pd(s1, _mm256_loadu_pd(window + k + 1));
+            s2 = _mm256_add_pd(s2, _mm256_loadu_pd(window + k + 2));
+            s3 = _mm256_add_pd(s3, _mm256_loadu_pd(window + k + 3));
+        }
+        __m256d total = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(s0, s1), s2), s3);
+        for (size_t k = body; k < count; ++k) total = _mm256_add_pd(total, _mm256_loadu_pd(window + k));
+        return total;
+    }
+
+    COMPUTE_TARGET_AVX2 void smaAvx2(const double* close, size_t n, size_t period, double* out) {
+        if (period == 0) return smaScalar(close, n, period, out);
+        size_t i = 0;
+        for (; i < n && i + 1 < period; ++i) out[i] = 0.0;
+        const __m256d divisor = _mm256_set1_pd(static_cast<double>(period));
+        for (; i + 4 <= n; i += 4) {
+            const double* window = close + (i + 1 - period);
+            __m256d sum;
+            if (period >= 8) {
+                sum = laneSum4(window, period);
+            } else {
+                sum = _mm256_setzero_pd();
+                for (size_t k = 0; k < period; ++k) sum = _mm256_add_pd(sum, _mm256_loadu_pd(window + k));
+            }
+            _mm256_storeu_pd(out + i, _mm256_div_pd(sum, divisor));
+        }
+        for (; i < n; ++i) out[i] = Kernels::sma(ArrayClose{close}, i, period);
+    }
+
+    COMPUTE_TARGET_AVX2 void rsiAvx2(const double* close, size_t n, size_t period, double* out) {
+        if (period == 0) return rsiScalar(close, n, period, out);
+        size_t i = 0;
+        for (; i < n && i < period; ++i) out[i] = 50.0;
+        const __m256d zero = _mm256_setzero_pd();
+        alignas(32) double gains[4], losses[4];
+        const size_t body = period & ~size_t(3);
+        for (; i + 4 <= n; i += 4) {
+            const double* window = close + (i + 1 - period);
+            // Gains and losses in one pass; max(x, 0) is 0 for x = 0 and
+            // NaN, like the scalar ternaries
+            __m256d g[4] = {zero, zero, zero, zero}, l[4] = {zero, zero, zero, zero};
+            __m256d prev = _mm256_loadu_pd(window - 1);
+            for (size_t k = 0; k < body; k += 4) {
+                for (size_t lane = 0; lane < 4; ++lane) {
+                    const __m256d curr = _mm256_loadu_pd(window + k + lane);
+                    const __m256d change = _mm256_sub_pd(curr, prev);
+                    g[lane] = _mm256_add_pd(g[lane], _mm256_max_pd(change, zero));
+                    l[lane] = _mm256_add_pd(l[lane], _mm256_max_pd(_mm256_sub_pd(zero, change), zero));
+                    prev = curr;
+                }
+            }
+            __m256d gain = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(g[0], g[1]), g[2]), g[3]);
+            __m256d loss = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(l[0], l[1]), l[2]), l[3]);
+            for (size_t k = body; k < period; ++k) {
+                const __m256d curr = _mm256_loadu_pd(window + k);
+                const __m256d change = _mm256_sub_pd(curr, prev);
+                gain = _mm256_add_pd(gain, _mm256_max_pd(change, zero));
+                loss = _mm256_add_pd(loss, _mm256_max_pd(_mm256_sub_pd(zero, change), zero));
+                prev = curr;
+            }
+            _mm256_store_pd(gains, gain);
+            _mm256_store_pd(losses, loss);
+            for (size_t j = 0; j < 4; ++j) out[i + j] = Kernels::rsiFromSums(gains[j], losses[j], period);
+        }
+        for (; i < n; ++i) out[i] = Kernels::rsi(ArrayClose{close}, i, period);
+    }
+
+    COMPUTE_TARGET_AVX2 void fvgAvx2(const double* high, const double* low, size_t n, uint8_t* out) {
+        if (n == 0) return;
+        out[0] = 0;
+        const __m256d up = _mm256_set1_pd(1.0 + Kernels::kFvgGap);
+        const __m256d down = _mm256_set1_pd(1.0 - Kernels::kFvgGap);
+        size_t i = 1;
+        for (; i + 4 <= n; i += 4) {
+            const __m256d bullish = _mm256_cmp_pd(_mm256_loadu_pd(low + i),
+                                                  _mm256_mul_pd(_mm256_loadu_pd(high + i - 1), up), _CMP_GT_OQ);
+            const __m256d bearish = _mm256_cmp_pd(_mm256_loadu_pd(high + i),
+                                                  _mm256_mul_pd(_mm256_loadu_pd(low + i - 1), down), _CMP_LT_OQ);
+            const int mask = _mm256_movemask_pd(_mm256_or_pd(bullish, bearish));
+            for (size_t j = 0; j < 4; ++j) out[i + j] = static_cast<uint8_t>((mask >> j) & 1);
+        }
+        for (; i < n; ++i) out[i] = Kernels::fvg(high[i - 1], low[i - 1], high[i], low[i]);
+    }
+
+    // AVX-512: eight bars per step, same lane layout as AVX2. The last step
+    // covers the remaining bars with a lane mask instead of a scalar tail;
+    // masked-off lanes neither load nor store.
+    COMPUTE_TARGET_AVX512 inline __mmask8 tailLanes(size_t remaining) {
+        return remaining >= 8 ? __mmask8(0xff) : static_cast<__mmask8>((1u << remaining) - 1);
+    }
+
+    COMPUTE_TARGET_AVX512 inline __m512d laneSum8(const double* window, size_t count, __mmask8 lanes) {
+        __m512d s0 = _mm512_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+        const size_t body = count & ~size_t(3);
+        for (size_t k = 0; k < body; k += 4) {
+            s0 = _mm512_add_pd(s0, _mm512_maskz_loadu_pd(lanes, window + k));
+            s1 = _mm512_add_pd(s1, _mm512_maskz_loadu_pd(lanes, window + k + 1));
+            s2 = _mm512_add_pd(s2, _mm512_maskz_loadu_pd(lanes, window + k + 2));
+            s3 = _mm512_add_pd(s3, _mm512_maskz_loadu_pd(lanes, window + k + 3));
+        }
+        __m512d total = _mm512_add_pd(_mm512_add_pd(_mm512_add_pd(s0, s1), s2), s3);
+        for (size_t k = body; k < count; ++k) total = _mm512_add_pd(total, _mm512_maskz_loadu_pd(lanes, window + k));
+        return total;
+    }
+
+    // laneSum8 for sixteen bars at once: two independent sets of
+    // accumulators, as one set is bound by the latency of the adds
+    COMPUTE_TARGET_AVX512 inline void laneSum8x2(const double* window, size_t count, __m512d& lo, __m512d& hi) {
+        __m512d s0 = _mm512_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+        __m512d t0 = s0, t1 = s0, t2 = s0, t3 = s0;
+        const size_t body = count & ~size_t(3);
+        for (size_t k = 0; k < body; k += 4) {
+            s0 = _mm512_add_pd(s0, _mm512_loadu_pd(window + k));
+            s1 = _mm512_add_pd(s1, _mm512_loadu_pd(window + k + 1));
+            s2 = _mm512_add_pd(s2, _mm512_loadu_pd(window + k + 2));
+            s3 = _mm512_add_pd(s3, _mm512_loadu_pd(window + k + 3));
+            t0 = _mm512_add_pd(t0, _mm512_loadu_pd(window + k + 8));
+            t1 = _mm512_add_pd(t1, _mm512_loadu_pd(window + k + 9));
+            t2 = _mm512_add_pd(t2, _mm512_loadu_pd(window + k + 10));
+            t3 = _mm512_add_pd(t3, _mm512_loadu_pd(window + k + 11));
+        }
+        lo = _mm512_add_pd(_mm512_add_pd(_mm512_add_pd(s0, s1), s2), s3);
+        hi = _mm512_add_pd(_mm512_add_pd(_mm512_add_pd(t0, t1), t2), t3);
+        for (size_t k = body; k < count; ++k) {
+            lo = _mm512_add_pd(lo, _mm512_loadu_pd(window + k));
+            hi = _mm512_add_pd(hi, _mm512_loadu_pd(window + k + 8));
+        }
+    }
+
+    COMPUTE_TARGET_AVX512 void smaAvx512(const double* close, size_t n, size_t period, double* out) {
+        if (period == 0) return smaScalar(close, n, period, out);
+        size_t i = 0;
+        for (; i < n && i + 1 < period; ++i) out[i] = 0.0;
+        const __m512d divisor = _mm512_set1_pd(static_cast<double>(period));
+        for (; period >= 8 && i + 16 <= n; i += 16) {
+            __m512d lo, hi;
+            laneSum8x2(close + (i + 1 - period), period, lo, hi);
+            _mm512_storeu_pd(out + i, _mm512_div_pd(lo, divisor));
+            _mm512_storeu_pd(out + i + 8, _mm512_div_pd(hi, divisor));
+        }
+        for (; i < n; i += 8) {
+            const __mmask8 lanes = tailLanes(n - i);
+            const double* window = close + (i + 1 - period);
+            __m512d sum;
+            if (period >= 8) {
+                sum = laneSum8(window, period, lanes);
+            } else {
+                sum = _mm512_setzero_pd();
+                for (size_t k = 0; k < period; ++k) sum = _mm512_add_pd(sum, _mm512_maskz_loadu_pd(lanes, window + k));
+            }
+            _mm512_mask_storeu_pd(out + i, lanes, _mm512_div_pd(sum, divisor));
+        }
+    }
+
+    COMPUTE_TARGET_AVX512 void rsiAvx512(const double* close, size_t n, size_t period, double* out) {
+        if (period == 0) return rsiScalar(close, n, period, out);
+        size_t i = 0;
+        for (; i < n && i < period; ++i) out[i] = 50.0;
+        const __m512d zero = _mm512_setzero_pd();
+        const __m512d divisor = _mm512_set1_pd(static_cast<double>(period));
+        const __m512d epsilon = _mm512_set1_pd(1e-10);
+        const __m512d hundred = _mm512_set1_pd(100.0);
+        const __m512d one = _mm512_set1_pd(1.0);
+        const size_t body = period & ~size_t(3);
+        for (; i < n; i += 8) {
+            const __mmask8 lanes = tailLanes(n - i);
+            const double* window = close + (i + 1 - period);
+            // prev - curr is exactly -change (and +0 for no change), one
+            // subtraction less than negating it
+            __m512d g[4] = {zero, zero, zero, zero}, l[4] = {zero, zero, zero, zero};
+            __m512d prev = _mm512_maskz_loadu_pd(lanes, window - 1);
+            for (size_t k = 0; k < body; k += 4) {
+                for (size_t lane = 0; lane < 4; ++lane) {
+                    const __m512d curr = _mm512_maskz_loadu_pd(lanes, window + k + lane);
+                    const __m512d change = _mm512_sub_pd(curr, prev);
+                    g[lane] = _mm512_add_pd(g[lane], _mm512_maskz_max_pd(lanes, change, zero));
+                    l[lane] = _mm512_add_pd(l[lane], _mm512_maskz_max_pd(lanes, _mm512_sub_pd(prev, curr), zero));
+                    prev = curr;
+                }
+            }
+            __m512d gain = _mm512_add_pd(_mm512_add_pd(_mm512_add_pd(g[0], g[1]), g[2]), g[3]);
+            __m512d loss = _mm512_add_pd(_mm512_add_pd(_mm512_add_pd(l[0], l[1]), l[2]), l[3]);
+            for (size_t k = body; k < period; ++k) {
+                const __m512d curr = _mm512_maskz_loadu_pd(lanes, window + k);
+                const __m512d change = _mm512_sub_pd(curr, prev);
+                gain = _mm512_add_pd(gain, _mm512_maskz_max_pd(lanes, change, zero));
+                loss = _mm512_add_pd(loss, _mm512_maskz_max_pd(lanes, _mm512_sub_pd(prev, curr), zero));
+                prev = curr;
+            }
+            // Kernels::rsiFromSums on all lanes; the flat and no-loss cases
+            // are blended in afterwards, the flat case last as it is tested
+            // first there
+            const __m512d avg_gain = _mm512_div_pd(gain, divisor);
+            const __m512d avg_loss = _mm512_div_pd(loss, divisor);
+            const __m512d rs = _mm512_div_pd(avg_gain, avg_loss);
+            __m512d rsi = _mm512_sub_pd(hundred, _mm512_div_pd(hundred, _mm512_add_pd(one, rs)));
+            rsi = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(avg_loss, epsilon, _CMP_LT_OQ), rsi, hundred);
+            rsi = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(_mm512_add_pd(gain, loss), epsilon, _CMP_LT_OQ), rsi,
+                                       _mm512_set1_pd(50.0));
+            _mm512_mask_storeu_pd(out + i, lanes, rsi);
+        }
+    }
+
+    COMPUTE_TARGET_AVX512 void fvgAvx512(const double* high, const double* low, size_t n, uint8_t* out) {
+        if (n == 0) return;
+        out[0] = 0;
+        const __m512d up = _mm512_set1_pd(1.0 + Kernels::kFvgGap);
+        const __m512d down = _mm512_set1_pd(1.0 - Kernels::kFvgGap);
+        const __m128i ones = _mm_set1_epi8(1);
+        for (size_t i = 1; i < n; i += 8) {
+            const __mmask8 lanes = tailLanes(n - i);
+            const __mmask8 bullish = _mm512_mask_cmp_pd_mask(
+                lanes, _mm512_maskz_loadu_pd(lanes, low + i),
+                _mm512_mul_pd(_mm512_maskz_loadu_pd(lanes, high + i - 1), up), _CMP_GT_OQ);
+            const __mmask8 bearish = _mm512_mask_cmp_pd_mask(
+                lanes, _mm512_maskz_loadu_pd(lanes, high + i),
+                _mm512_mul_pd(_mm512_maskz_loadu_pd(lanes, low + i - 1), down), _CMP_LT_OQ);
+            _mm_mask_storeu_epi8(out + i, lanes, _mm_maskz_mov_epi8(bullish | bearish, ones));
+        }
+    }
+
+    // float32 kernels: the same lane layout with twice the bars per vector,
+    // eight for AVX2 and sixteen for AVX-512
+    COMPUTE_TARGET_AVX2 inline __m256 laneSum4(const float* window, size_t count) {
+        __m256 s0 = _mm256_setzero_ps(), s1 = s0, s2 = s0, s3 = s0;
+        const size_t body = count & ~size_t(3);
+        for (size_t k = 0; k < body; k += 4) {
+            s0 = _mm256_add_ps(s0, _mm256_loadu_ps(window + k));
+            s1 = _mm256_add_ps(s1, _mm256_loadu_ps(window + k + 1));
+            s2 = _mm256_add_ps(s2, _mm256_loadu_ps(window + k + 2));
+            s3 = _mm256_add_ps(s3, _mm256_loadu_ps(window + k + 3));
+        }
+        __m256 total = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(s0, s1), s2), s3);
+        for (size_t k = body; k < count; ++k) total = _mm256_add_ps(total, _mm256_loadu_ps(window + k));
+        return total;
+    }
+
+    COMPUTE_TARGET_AVX2 void smaAvx2(const float* close, size_t n, size_t period, float* out) {
+        if (period == 0) return smaScalar(close, n, period, out);
+        size_t i = 0;
+        for (; i < n && i + 1 < period; ++i) out[i] = 0.0f;
+        const __m256 divisor = _mm256_set1_ps(static_cast<float>(period));
+        for (; i + 8 <= n; i += 8) {
+            const float* window = close + (i + 1 - period);
+            __m256 sum;
+            if (period >= 8) {
+                sum = laneSum4(window, period);
+            } else {
+                sum = _mm256_setzero_ps();
+                for (size_t k = 0; k < period; ++k) sum = _mm256_add_ps(sum, _mm256_loadu_ps(window + k));
+            }
+            _mm256_storeu_ps(out + i, _mm256_div_ps(sum, divisor));
+        }
+        for (; i < n; ++i) out[i] = Kernels::sma(ArrayClose{close}, i, period);
+    }
+
+    COMPUTE_TARGET_AVX2 void rsiAvx2(const float* close, size_t n, size_t period, float* out) {
+        if (period == 0) return rsiScalar(close, n, period, out);
+        size_t i = 0;
+        for (; i < n && i < period; ++i) out[i] = 50.0f;
+        const __m256 zero = _mm256_setzero_ps();
+        alignas(32) float gains[8], losses[8];
+        const size_t body = period & ~size_t(3);
+        for (; i + 8 <= n; i += 8) {
+            const float* window = close + (i + 1 - period);
+            __m256 g[4] = {zero, zero, zero, zero}, l[4] = {zero, zero, zero, zero};
+            __m256 prev = _mm256_loadu_ps(window - 1);
+            for (size_t k = 0; k < body; k += 4) {
+                for (size_t lane = 0; lane < 4; ++lane) {
+                    const __m256 curr = _mm256_loadu_ps(window + k + lane);
+                    g[lane] = _mm256_add_ps(g[lane], _mm256_max_ps(_mm256_sub_ps(curr, prev), zero));
+                    l[lane] = _mm256_add_ps(l[lane], _mm256_max_ps(_mm256_sub_ps(prev, curr), zero));
+                    prev = curr;
+                }
+            }
+            __m256 gain = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(g[0], g[1]), g[2]), g[3]);
+            __m256 loss = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(l[0], l[1]), l[2]), l[3]);
+            for (size_t k = body; k < period; ++k) {
+                const __m256 curr = _mm256_loadu_ps(window + k);
+                gain = _mm256_add_ps(gain, _mm256_max_ps(_mm256_sub_ps(curr, prev), zero));
+                loss = _mm256_add_ps(loss, _mm256_max_ps(_mm256_sub_ps(prev, curr), zero));
+                prev = curr;
+            }
+            _mm256_store_ps(gains, gain);
+            _mm256_store_ps(losses, loss);
+            for (size_t j = 0; j < 8; ++j) out[i + j] = Kernels::rsiFromSums(gains[j], losses[j], period);
+        }
+        for (; i < n; ++i) out[i] = Kernels::rsi(ArrayClose{close}, i, period);
+    }
+
+    COMPUTE_TARGET_AVX2 void fvgAvx2(const float* high, const float* low, size_t n, uint8_t* out) {
+        if (n == 0) return;
+        out[0] = 0;
+        const __m256 up = _mm256_set1_ps(static_cast<float>(1.0 + Kernels::kFvgGap));
+        const __m256 down = _mm256_set1_ps(static_cast<float>(1.0 - Kernels::kFvgGap));
+        size_t i = 1;
+        for (; i + 8 <= n; i += 8) {
+            const __m256 bullish = _mm256_cmp_ps(_mm256_loadu_ps(low + i),
+                                                 _mm256_mul_ps(_mm256_loadu_ps(high + i - 1), up), _CMP_GT_OQ);
+            const __m256 bearish = _mm256_cmp_ps(_mm256_loadu_ps(high + i),
+                                                 _mm256_mul_ps(_mm256_loadu_ps(low + i - 1), down), _CMP_LT_OQ);
+            const int mask = _mm256_movemask_ps(_mm256_or_ps(bullish, bearish));
+            for (size_t j = 0; j < 8; ++j) out[i + j] = static_cast<uint8_t>((mask >> j) & 1);
+        }
+        for (; i < n; ++i) out[i] = Kernels::fvg(high[i - 1], low[i - 1], high[i], low[i]);
+    }
+
+    COMPUTE_TARGET_AVX512 inline __mmask16 tailLanes16(size_t remaining) {
+        return remaining >= 16 ? __mmask16(0xffff) : static_cast<__mmask16>((1u << remaining) - 1);
+    }
+
+    COMPUTE_TARGET_AVX512 inline __m512 laneSum16(const float* window, size_t count, __mmask16 lanes) {
+        __m512 s0 = _mm512_setzero_ps(), s1 = s0, s2 = s0, s3 = s0;
+        const size_t body = count & ~size_t(3);
+        for (size_t k = 0; k < body; k += 4) {
+            s0 = _mm512_add_ps(s0, _mm512_maskz_loadu_ps(lanes, window + k));
+            s1 = _mm512_add_ps(s1, _mm512_maskz_loadu_ps(lanes, window + k + 1));
+            s2 = _mm512_add_ps(s2, _mm512_maskz_loadu_ps(lanes, window + k + 2));
+            s3 = _mm512_add_ps(s3, _mm512_maskz_loadu_ps(lanes, window + k + 3));
+        }
+        __m512 total = _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(s0, s1), s2), s3);
+        for (size_t k = body; k < count; ++k) total = _mm512_add_ps(total, _mm512_maskz_loadu_ps(lanes, window + k));
+        return total;
+    }
+
+    COMPUTE_TARGET_AVX512 inline void laneSum16x2(const float* window, size_t count, __m512& lo, __m512& hi) {
+        __m512 s0 = _mm512_setzero_ps(), s1 = s0, s2 = s0, s3 = s0;
+        __m512 t0 = s0, t1 = s0, t2 = s0, t3 = s0;
+        const size_t body = count & ~size_t(3);
+        for (size_t k = 0; k < body; k += 4) {
+            s0 = _mm512_add_ps(s0, _mm512_loadu_ps(window + k));
+            s1 = _mm512_add_ps(s1, _mm512_loadu_ps(window + k + 1));
+            s2 = _mm512_add_ps(s2, _mm512_loadu_ps(window + k + 2));
+            s3 = _mm512_add_ps(s3, _mm512_loadu_ps(window + k + 3));
+            t0 = _mm512_add_ps(t0, _mm512_loadu_ps(window + k + 16));
+            t1 = _mm512_add_ps(t1, _mm512_loadu_ps(window + k + 17));
+            t2 = _mm512_add_ps(t2, _mm512_loadu_ps(window + k + 18));
+            t3 = _mm512_add_ps(t3, _mm512_loadu_ps(window + k + 19));
+        }
+        lo = _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(s0, s1), s2), s3);
+        hi = _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(t0, t1), t2), t3);
+        for (size_t k = body; k < count; ++k) {
+            lo = _mm512_add_ps(lo, _mm512_loadu_ps(window + k));
+            hi = _mm512_add_ps(hi, _mm512_loadu_ps(window + k + 16));
+        }
+    }
+
+    COMPUTE_TARGET_AVX512 void smaAvx512(const float* close, size_t n, size_t period, float* out) {
+        if (period == 0) return smaScalar(close, n, period, out);
+        size_t i = 0;
+        for (; i < n && i + 1 < period; ++i) out[i] = 0.0f;
+        const __m512 divisor = _mm512_set1_ps(static_cast<float>(period));
+        for (; period >= 8 && i + 32 <= n; i += 32) {
+            __m512 lo, hi;
+            laneSum16x2(close + (i + 1 - period), period, lo, hi);
+            _mm512_storeu_ps(out + i, _mm512_div_ps(lo, divisor));
+            _mm512_storeu_ps(out + i + 16, _mm512_div_ps(hi, divisor));
+        }
+        for (; i < n; i += 16) {
+            const __mmask16 lanes = tailLanes16(n - i);
+            const float* window = close + (i + 1 - period);
+            __m512 sum;
+            if (period >= 8) {
+                sum = laneSum16(window, period, lanes);
+            } else {
+                sum = _mm512_setzero_ps();
+                for (size_t k = 0; k < period; ++k) sum = _mm512_add_ps(sum, _mm512_maskz_loadu_ps(lanes, window + k));
+            }
+            _mm512_mask_storeu_ps(out + i, lanes, _mm512_div_ps(sum, divisor));
+        }
+    }
+
+    COMPUTE_TARGET_AVX512 void rsiAvx512(const float* close, size_t n, size_t period, float* out) {
+        if (period == 0) return rsiScalar(close, n, period, out);
+        size_t i = 0;
+        for (; i < n && i < period; ++i) out[i] = 50.0f;
+        const __m512 zero = _mm512_setzero_ps();
+        const __m512 divisor = _mm512_set1_ps(static_cast<float>(period));
+        const __m512 epsilon = _mm512_set1_ps(1e-10f);
+        const __m512 hundred = _mm512_set1_ps(100.0f);
+        const __m512 one = _mm512_set1_ps(1.0f);
+        const size_t body = period & ~size_t(3);
+        for (; i < n; i += 16) {
+            const __mmask16 lanes = tailLanes16(n - i);
+            const float* window = close + (i + 1 - period);
+            __m512 g[4] = {zero, zero, zero, zero}, l[4] = {zero, zero, zero, zero};
+            __m512 prev = _mm512_maskz_loadu_ps(lanes, window - 1);
+            for (size_t k = 0; k < body; k += 4) {
+                for (size_t lane = 0; lane < 4; ++lane) {
+                    const __m512 curr = _mm512_maskz_loadu_ps(lanes, window + k + lane);
+                    g[lane] = _mm512_add_ps(g[lane], _mm512_maskz_max_ps(lanes, _mm512_sub_ps(curr, prev), zero));
+                    l[lane] = _mm512_add_ps(l[lane], _mm512_maskz_max_ps(lanes, _mm512_sub_ps(prev, curr), zero));
+                    prev = curr;
+                }
+            }
+            __m512 gain = _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(g[0], g[1]), g[2]), g[3]);
+            __m512 loss = _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(l[0], l[1]), l[2]), l[3]);
+            for (size_t k = body; k < period; ++k) {
+                const __m512 curr = _mm512_maskz_loadu_ps(lanes, window + k);
+                gain = _mm512_add_ps(gain, _mm512_maskz_max_ps(lanes, _mm512_sub_ps(curr, prev), zero));
+                loss = _mm512_add_ps(loss, _mm512_maskz_max_ps(lanes, _mm512_sub_ps(prev, curr), zero));
+                prev = curr;
+            }
+            const __m512 avg_gain = _mm512_div_ps(gain, divisor);
+            const __m512 avg_loss = _mm512_div_ps(loss, divisor);
+            const __m512 rs = _mm512_div_ps(avg_gain, avg_loss);
+            __m512 rsi = _mm512_sub_ps(hundred, _mm512_div_ps(hundred, _mm512_add_ps(one, rs)));
+            rsi = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(avg_loss, epsilon, _CMP_LT_OQ), rsi, hundred);
+            rsi = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(_mm512_add_ps(gain, loss), epsilon, _CMP_LT_OQ), rsi,
+                                       _mm512_set1_ps(50.0f));
+            _mm512_mask_storeu_ps(out + i, lanes, rsi);
+        }
+    }
+
+    COMPUTE_TARGET_AVX512 void fvgAvx512(const float* high, const float* low, size_t n, uint8_t* out) {
+        if (n == 0) return;
+        out[0] = 0;
+        const __m512 up = _mm512_set1_ps(static_cast<float>(1.0 + Kernels::kFvgGap));
+        const __m512 down = _mm512_set1_ps(static_cast<float>(1.0 - Kernels::kFvgGap));
+        const __m128i ones = _mm_set1_epi8(1);
+        for (size_t i = 1; i < n; i += 16) {
+            const __mmask16 lanes = tailLanes16(n - i);
+            const __mmask16 bullish = _mm512_mask_cmp_ps_mask(
+                lanes, _mm512_maskz_loadu_ps(lanes, low + i),
+                _mm512_mul_ps(_mm512_maskz_loadu_ps(lanes, high + i - 1), up), _CMP_GT_OQ);
+            const __mmask16 bearish = _mm512_mask_cmp_ps_mask(
+                lanes, _mm512_maskz_loadu_ps(lanes, high + i),
+                _mm512_mul_ps(_mm512_maskz_loadu_ps(lanes, low + i - 1), down), _CMP_LT_OQ);
+            _mm_mask_storeu_epi8(out + i, lanes, _mm_maskz_mov_epi8(bullish | bearish, ones));
+        }
+    }
+#endif
+}
+
+ComputeBackend resolve(ComputeBackend requested) {
+#ifdef COMPUTE_X86
+    if (requested >= ComputeBackend::Avx512 && Compute::supported(ComputeBackend::Avx512)) {
+        return ComputeBackend::Avx512;
+    }
+    if (requested >= ComputeBackend::Avx2 && Compute::supported(ComputeBackend::Avx2)) return ComputeBackend::Avx2;
+#endif
+    (void)requested;
+    return ComputeBackend::Scalar;
+}
+
+bool available(ComputeBackend backend) {
+    return Compute::supported(backend) && resolve(backend) == backend;
+}
+
+namespace {
+    template <class T>
+    void smaDispatch(const T* close, size_t n, size_t period, T* out, ComputeBackend backend) {
+#ifdef COMPUTE_X86
+        switch (resolve(backend)) {
+            case ComputeBackend::Avx512: return smaAvx512(close, n, period, out);
+            case ComputeBackend::Avx2: return smaAvx2(close, n, period, out);
+            default: break;
+        }
+#endif
+        (void)backend;
+        smaScalar(close, n, period, out);
+    }
+
+    template <class T>
+    void rsiDispatch(const T* close, size_t n, size_t period, T* out, ComputeBackend backend) {
+#ifdef COMPUTE_X86
+        switch (resolve(backend)) {
+            case ComputeBackend::Avx512: return rsiAvx512(close, n, period, out);
+            case ComputeBackend::Avx2: return rsiAvx2(close, n, period, out);
+            default: break;
+        }
+#endif
+        (void)backend;
+        rsiScalar(close, n, period, out);
+    }
+
+    template <class T>
+    void fvgDispatch(const T* high, const T* low, size_t n, uint8_t* out, ComputeBackend backend) {
+#ifdef COMPUTE_X86
+        switch (resolve(backend)) {
+            case ComputeBackend::Avx512: return fvgAvx512(high, low, n, out);
+            case ComputeBackend::Avx2: return fvgAvx2(high, low, n, out);
+            default: break;
+        }
+#endif
+        (void)backend;
+        fvgScalar(high, low, n, out);
+    }
+}
+
+void sma(const double* close, size_t n, size_t period, double* out, ComputeBackend backend) {
+    smaDispatch(close, n, period, out, backend);
+}
+
+void rsi(const double* close, size_t n, size_t period, double* out, ComputeBackend backend) {
+    rsiDispatch(close, n, period, out, backend);
+}
+
+void fvg(const double* high, const double* low, size_t n, uint8_t* out, ComputeBackend backend) {
+    fvgDispatch(high, low, n, out, backend);
+}
+
+void sma(const float* close, size_t n, size_t period, float* out, ComputeBackend backend) {
+    smaDispatch(close, n, period, out, backend);
+}
+
+void rsi(const float* close, size_t n, size_t period, float* out, ComputeBackend backend) {
+    rsiDispatch(close, n, period, out, backend);
+}
+
+void fvg(const float* high, const float* low, size_t n, uint8_t* out, ComputeBackend backend) {
+    fvgDispatch(high, low, n, out, backend);
+}
+
+bool validate(const BarView& data, std::ostream& out) {
+    const size_t n = data.size();
+    std::vector<double> close(n), high(n), low(n);
+    for (size_t i = 0; i < n; ++i) {
+        close[i] = data[i].close;
+        high[i] = data[i].high;
+        low[i] = data[i].low;
+    }
+
+    bool ok = true;
+    auto check = [&](const char* what, const std::vector<double>& expected, const std::vector<double>& got) {
+        size_t mismatches = 0, first = n;
+        for (size_t i = 0; i < n; ++i) {
+            if (std::memcmp(&expected[i], &got[i], sizeof(double)) != 0) {
+                if (!mismatches) first = i;
+                ++mismatches;
+            }
+        }
+        out << "  " << what << ": ";
+        if (mismatches) {
+            out << mismatches << " of " << n << " bars differ (first at " << first << ": " << expected[first]
+                << " vs " << got[first] << ")\n";
+            ok = false;
+        } else {
+            out << "identical\n";
+        }
+    };
+
+    const ComputeBackend backends[] = {ComputeBackend::Scalar, ComputeBackend::Avx2, ComputeBackend::Avx512};
+    const size_t periods[] = {1, 2, 3, 7, 8, 14, 20, 50, 200};
+    std::vector<double> reference(n), got(n);
+    for (size_t period : periods) {
+        if (period > n) continue;
+        std::string label = "period " + std::to_string(period);
+
+        // Per-bar functions against the scalar backend
+        smaScalar(close.data(), n, period, reference.data());
+        for (size_t i = 0; i < n; ++i) got[i] = Indicators::SMA(data, i, period);
+        check(("SMA " + label + " Indicators::SMA").c_str(), reference, got);
+        for (ComputeBackend b : backends) {
+            if (b == ComputeBackend::Scalar || !available(b)) continue;
+            sma(close.data(), n, period, got.data(), b);
+            check(("SMA " + label + " " + Compute::name(b)).c_str(), reference, got);
+        }
+
+        rsiScalar(close.data(), n, period, reference.data());
+        for (size_t i = 0; i < n; ++i) got[i] = Indicators::RSI(data, i, period);
+        check(("RSI " + label + " Indicators::RSI").c_str(), reference, got);
+        for (ComputeBackend b : backends) {
+            if (b == ComputeBackend::Scalar || !available(b)) continue;
+            rsi(close.data(), n, period, got.data(), b);
+            check(("RSI " + label + " " + Compute::name(b)).c_str(), reference, got);
+        }
+
+#ifdef USE_CUDA
+        // The fused CUDA kernel runs the same reference kernels per thread
+        std::vector<double> gpu_sma(n), gpu_rsi(n), cpu_sma(n);
+        gpu_calculate_indicators(close.data(), static_cast<int>(n), gpu_sma.data(), gpu_rsi.data(),
+                                 static_cast<int>(period), static_cast<int>(period));
+        smaScalar(close.data(), n, period, cpu_sma.data());
+        check(("SMA " + label + " cuda").c_str(), cpu_sma, gpu_sma);
+        check(("RSI " + label + " cuda").c_str(), reference, gpu_rsi);
+#endif
+    }
+
+    std::vector<uint8_t> gaps(n);
+    fvgScalar(high.data(), low.data(), n, gaps.data());
+    for (size_t i = 0; i < n; ++i) reference[i] = gaps[i];
+    for (size_t i = 0; i < n; ++i) got[i] = Indicators::detectFVG(data, i);
+    check("FVG Indicators::detectFVG", reference, got);
+    for (ComputeBackend b : backends) {
+        if (b == ComputeBackend::Scalar || !available(b)) continue;
+        fvg(high.data(), low.data(), n, gaps.data(), b);
+        for (size_t i = 0; i < n; ++i) got[i] = gaps[i];
+        check((std::string("FVG ") + Compute::name(b)).c_str(), reference, got);
+    }
+
+    // float32 backends against the float32 scalar kernels, bit for bit; the
+    // distance of float32 from double is reported, not checked
+    std::vector<float> close_f(close.begin(), close.end()), high_f(high.begin(), high.end()),
+        low_f(low.begin(), low.end()), values_f(n);
+    auto widen = [&](std::vector<double>& to) { std::copy(values_f.begin(), values_f.end(), to.begin()); };
+    auto drift = [&](const char* what, const std::vector<double>& exact, const std::vector<double>& approx) {
+        double worst = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            const double scale = std::max(std::fabs(exact[i]), 1e-12);
+            worst = std::max(worst, std::fabs(approx[i] - exact[i]) / scale);
+        }
+        out << "  " << what << " float32 vs double: max relative error " << worst << "\n";
+    };
+    for (size_t period : periods) {
+        if (period > n) continue;
+        std::string label = "period " + std::to_string(period) + " float32";
+
+        smaScalar(close_f.data(), n, period, values_f.data());
+        widen(reference);
+        for (ComputeBackend b : backends) {
+            if (b == ComputeBackend::Scalar || !available(b)) continue;
+            sma(close_f.data(), n, period, values_f.data(), b);
+            widen(got);
+            check(("SMA " + label + " " + Compute::name(b)).c_str(), reference, got);
+        }
+        smaScalar(close.data(), n, period, got.data());
+        drift(("SMA period " + std::to_string(period)).c_str(), got, reference);
+
+        rsiScalar(close_f.data(), n, period, values_f.data());
+        widen(reference);
+        for (ComputeBackend b : backends) {
+            if (b == ComputeBackend::Scalar || !available(b)) continue;
+            rsi(close_f.data(), n, period, values_f.data(), b);
+            widen(got);
+            check(("RSI " + label + " " + Compute::name(b)).c_str(), reference, got);
+        }
+        rsiScalar(close.data(), n, period, got.data());
+        drift(("RSI period " + std::to_string(period)).c_str(), got, reference);
+    }
+    fvgScalar(high_f.data(), low_f.data(), n, gaps.data());
+    for (size_t i = 0; i < n; ++i) reference[i] = gaps[i];
+    for (ComputeBackend b : backends) {
+        if (b == ComputeBackend::Scalar || !available(b)) continue;
+        fvg(high_f.data(), low_f.data(), n, gaps.data(), b);
+        for (size_t i = 0; i < n; ++i) got[i] = gaps[i];
+        check((std::string("FVG float32 ") + Compute::name(b)).c_str(), reference, got);
+    }
+    return ok;
+}
+
+}
+}
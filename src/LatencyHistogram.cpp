@@ -0,0 +1,182 @@
+#include "../include/LatencyHistogram.hpp"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+
+LatencyHistogram::LatencyHistogram(uint64_t highest, int significant_digits)
+    : highest_(std::max<uint64_t>(highest, 2)),
+      significant_digits_(std::min(std::max(significant_digits, 1), 5)) {
+    // Enough sub-buckets that every value up to 2 * 10^digits is exact
+    const uint64_t single_unit_limit = 2 * static_cast<uint64_t>(std::pow(10.0, significant_digits_));
+    int magnitude = 0;
+    while ((uint64_t(1) << magnitude) < single_unit_limit) ++magnitude;
+    sub_bucket_half_count_magnitude_ = magnitude - 1;
+    sub_bucket_count_ = uint64_t(1) << magnitude;
+    sub_bucket_half_count_ = sub_bucket_count_ / 2;
+    sub_bucket_mask_ = sub_bucket_count_ - 1;
+
+    // Each further bucket doubles the covered range at the same precision
+    bucket_count_ = 1;
+    for (uint64_t limit = sub_bucket_count_; limit <= highest_; limit <<= 1) {
+        ++bucket_count_;
+        if (limit > (UINT64_MAX >> 1)) break;
+    }
+    counts_length_ = static_cast<size_t>(bucket_count_ + 1) * sub_bucket_half_count_;
+    counts_.reset(new std::atomic<uint64_t>[counts_length_]);
+    reset();
+}
+
+void LatencyHistogram::reset() {
+    for (size_t i = 0; i < counts_length_; ++i) counts_[i].store(0, std::memory_order_relaxed);
+    total_.store(0, std::memory_order_relaxed);
+    clamped_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::valueFromIndex(size_t index) const {
+    int bucket = static_cast<int>(index >> sub_bucket_half_count_magnitude_) - 1;
+    uint64_t sub_bucket = (index & (sub_bucket_half_count_ - 1)) + sub_bucket_half_count_;
+    if (bucket < 0) {
+        sub_bucket -= sub_bucket_half_count_;
+        bucket = 0;
+    }
+    return sub_bucket << bucket;
+}
+
+uint64_t LatencyHistogram::equivalentRange(uint64_t value) const {
+    const int pow2_ceiling = 64 - leadingZeros(value | sub_bucket_mask_);
+    const int bucket = pow2_ceiling - (sub_bucket_half_count_magnitude_ + 1);
+    const uint64_t sub_bucket = value >> bucket;
+    return uint64_t(1) << (sub_bucket >= sub_bucket_count_ ? bucket + 1 : bucket);
+}
+
+uint64_t LatencyHistogram::highestEquivalent(uint64_t value) const {
+    const uint64_t range = equivalentRange(value);
+    return (value & ~(range - 1)) + range - 1;
+}
+
+uint64_t LatencyHistogram::medianEquivalent(uint64_t value) const {
+    const uint64_t range = equivalentRange(value);
+    return (value & ~(range - 1)) + range / 2;
+}
+
+double LatencyHistogram::mean() const {
+    double sum = 0.0, n = 0.0;
+    for (size_t i = 0; i < counts_length_; ++i) {
+        const uint64_t c = counts_[i].load(std::memory_order_relaxed);
+        if (!c) continue;
+        sum += static_cast<double>(c) * static_cast<double>(medianEquivalent(valueFromIndex(i)));
+        n += static_cast<double>(c);
+    }
+    return n > 0 ? sum / n : 0.0;
+}
+
+double LatencyHistogram::stddev() const {
+    const double mu = mean();
+    double sum = 0.0, n = 0.0;
+    for (size_t i = 0; i < counts_length_; ++i) {
+        const uint64_t c = counts_[i].load(std::memory_order_relaxed);
+        if (!c) continue;
+        const double d = static_cast<double>(medianEquivalent(valueFromIndex(i))) - mu;
+        sum += static_cast<double>(c) * d * d;
+        n += static_cast<double>(c);
+    }
+    return n > 0 ? std::sqrt(sum / n) : 0.0;
+}
+
+uint64_t LatencyHistogram::valueAtPercentile(double percentile) const {
+    const uint64_t total = count();
+    if (total == 0) return 0;
+    const double p = std::min(std::max(percentile, 0.0), 100.0);
+    const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(p / 100.0 * static_cast<double>(total) + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_length_; ++i) {
+        seen += counts_[i].load(std::memory_order_relaxed);
+        if (seen >= target) return std::min(highestEquivalent(valueFromIndex(i)), max());
+    }
+    return max();
+}
+
+// Same iteration as HdrHistogram's outputPercentileDistribution: report
+// points get denser towards 100%, ticks_per_half_distance per halving of
+// the remaining distance, followed by a final 100% line
+void LatencyHistogram::writePercentiles(std::ostream& out, double unit_scale, int ticks_per_half_distance) const {
+    const uint64_t total = count();
+    char line[128];
+    std::snprintf(line, sizeof(line), "%12s %14s %10s %14s\n\n", "Value", "Percentile", "TotalCount", "1/(1-Percentile)");
+    out << line;
+
+    uint64_t seen = 0;
+    double next_percentile = 0.0;
+    for (size_t i = 0; i < counts_length_ && seen < total; ++i) {
+        const uint64_t c = counts_[i].load(std::memory_order_relaxed);
+        if (!c) continue;
+        seen += c;
+        const double reached = 100.0 * static_cast<double>(seen) / static_cast<double>(total);
+        const double value = static_cast<double>(highestEquivalent(valueFromIndex(i))) / unit_scale;
+        while (next_percentile <= reached && next_percentile < 100.0) {
+            std::snprintf(line, sizeof(line), "%12.3f %2.12f %10llu %14.2f\n", value, next_percentile / 100.0,
+                          static_cast<unsigned long long>(seen), 1.0 / (1.0 - next_percentile / 100.0));
+            out << line;
+            const double half_distance = std::pow(2.0, std::floor(std::log2(100.0 / (100.0 - next_percentile))) + 1);
+            next_percentile += 100.0 / (ticks_per_half_distance * half_distance);
+            if (seen >= total) break;  // one line for the last bucket, then 100%
+        }
+        if (seen >= total) {
+            std::snprintf(line, sizeof(line), "%12.3f %2.12f %10llu\n", value, 1.0, static_cast<unsigned long long>(seen));
+            out << line;
+        }
+    }
+
+    std::snprintf(line, sizeof(line), "#[Mean    = %12.3f, StdDeviation   = %12.3f]\n", mean() / unit_scale,
+                  stddev() / unit_scale);
+    out << line;
+    std::snprintf(line, sizeof(line), "#[Max     = %12.3f, Total count    = %12llu]\n",
+                  static_cast<double>(max()) / unit_scale, static_cast<unsigned long long>(total));
+    out << line;
+    std::snprintf(line, sizeof(line), "#[Buckets = %12d, SubBuckets     = %12llu]\n", bucket_count_,
+                  static_cast<unsigned long long>(sub_bucket_count_));
+    out << line;
+}
+
+bool LatencyHistogram::writeHgrm(const std::string& path, double unit_scale) const {
+    std::ofstream out(path);
+    if (!out) return false;
+    writePercentiles(out, unit_scale);
+    return static_cast<bool>(out);
+}
+
+void BarLatency::report(std::ostream& out) const {
+    const struct {
+        const char* name;
+        const LatencyHistogram& h;
+    } rows[] = {{"signal", signal}, {"update", update}, {"bar", bar}};
+
+    std::ostringstream oss;
+    oss << "\n=== PER-BAR LATENCY (us) ===\n"
+        << std::left << std::setw(10) << "Stage" << std::right << std::setw(12) << "Count"
+        << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99"
+        << std::setw(10) << "p99.9" << std::setw(12) << "max" << "\n"
+        << std::string(74, '-') << "\n";
+    oss << std::fixed << std::setprecision(3);
+    for (const auto& row : rows) {
+        if (row.h.count() == 0) continue;
+        auto us = [](uint64_t ns) { return static_cast<double>(ns) / 1e3; };
+        oss << std::left << std::setw(10) << row.name << std::right << std::setw(12) << row.h.count()
+            << std::setw(10) << us(row.h.valueAtPercentile(50.0)) << std::setw(10) << us(row.h.valueAtPercentile(90.0))
+            << std::setw(10) << us(row.h.valueAtPercentile(99.0)) << std::setw(10) << us(row.h.valueAtPercentile(99.9))
+            << std::setw(12) << us(row.h.max());
+        if (row.h.clamped()) oss << "  (" << row.h.clamped() << " above range)";
+        oss << "\n";
+    }
+    out << oss.str() << std::flush;
+}
+
+bool BarLatency::writeHgrm(const std::string& prefix) const {
+    return signal.writeHgrm(prefix + "_signal.hgrm") && update.writeHgrm(prefix + "_update.hgrm") &&
+           bar.writeHgrm(prefix + "_bar.hgrm");
+}
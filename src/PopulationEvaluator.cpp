@@ -0,0 +1,209 @@
+#include "../include/PopulationEvaluator.hpp"
+#include "../include/GeneEvaluator.hpp"
+#include "../include/EvaluationArena.hpp"
+#include "../include/ThreadPool.hpp"
+#include "../include/Profiler.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+    using Indicator = StrategyGene::IndicatorType;
+
+    // One indicator series: type, period (as indicatorSeries clamps it) and
+    // timeframe
+    uint64_t legKey(Indicator type, int period, Timeframe tf) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(type)) << 40) |
+               (static_cast<uint64_t>(static_cast<uint32_t>(tf)) << 32) |
+               static_cast<uint32_t>(std::max(period, 1));
+    }
+
+    Timeframe toTimeframe(int value) {
+        return value >= 0 && static_cast<size_t>(value) < kTimeframeCount ? static_cast<Timeframe>(value)
+                                                                          : Timeframe::M1;
+    }
+
+    void setLegs(GeneEvaluator::Legs& legs, const double* primary, const double* secondary) {
+        legs.primary = primary;
+        legs.secondary = secondary;
+    }
+
+    void setLegs(GeneEvaluator::Legs& legs, const float* primary, const float* secondary) {
+        legs.primary_f32 = primary;
+        legs.secondary_f32 = secondary;
+    }
+}
+
+PopulationEvaluator::PopulationEvaluator(const BarView& data, const GeneEvaluator& evaluator, ThreadPool& pool)
+    : evaluator_(evaluator), pool_(pool) {
+    (void)data;
+}
+
+bool PopulationEvaluator::available(PopulationBackend backend) {
+    // evaluate_population_gpu scores its placeholder entry rule, whatever
+    // the gene, even in USE_CUDA builds
+    return backend == PopulationBackend::Cpu;
+}
+
+const char* PopulationEvaluator::name(PopulationBackend backend) {
+    return backend == PopulationBackend::Cuda ? "cuda" : "cpu";
+}
+
+bool PopulationEvaluator::parse(const std::string& name, PopulationBackend& out) {
+    if (name == "cpu") {
+        out = PopulationBackend::Cpu;
+    } else if (name == "cuda") {
+        out = PopulationBackend::Cuda;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+CudaStrategyGene PopulationEvaluator::pack(const StrategyGene& g) {
+    return {static_cast<int>(g.primary_indicator), static_cast<int>(g.secondary_indicator),
+            g.primary_period, g.secondary_period, g.primary_threshold, g.secondary_threshold,
+            static_cast<int>(g.entry_condition), static_cast<int>(g.exit_condition),
+            g.risk_reward_ratio, g.stop_loss_pct, g.take_profit_pct, g.max_hold_time, g.position_size_pct,
+            static_cast<int>(g.primary_timeframe), static_cast<int>(g.secondary_timeframe)};
+}
+
+StrategyGene PopulationEvaluator::unpack(const CudaStrategyGene& c) {
+    StrategyGene g;
+    g.primary_indicator = static_cast<StrategyGene::IndicatorType>(c.primary_indicator);
+    g.secondary_indicator = static_cast<StrategyGene::IndicatorType>(c.secondary_indicator);
+    g.primary_period = c.primary_period;
+    g.secondary_period = c.secondary_period;
+    g.primary_threshold = c.primary_threshold;
+    g.secondary_threshold = c.secondary_threshold;
+    g.entry_condition = static_cast<StrategyGene::EntryCondition>(c.entry_condition);
+    g.exit_condition = static_cast<StrategyGene::ExitCondition>(c.exit_condition);
+    g.risk_reward_ratio = c.risk_reward_ratio;
+    g.stop_loss_pct = c.stop_loss_pct;
+    g.take_profit_pct = c.take_profit_pct;
+    g.max_hold_time = c.max_hold_time;
+    g.position_size_pct = c.position_size_pct;
+    g.primary_timeframe = toTimeframe(c.primary_timeframe);
+    g.secondary_timeframe = toTimeframe(c.secondary_timeframe);
+    return g;
+}
+
+CudaFitnessResult PopulationEvaluator::pack(const FitnessResult& r) {
+    return {r.total_return, r.sharpe_ratio, r.max_drawdown, r.win_rate,
+            r.total_trades, r.profit_factor, r.calmar_ratio, r.fitness_score};
+}
+
+FitnessResult PopulationEvaluator::unpack(const CudaFitnessResult& c) {
+    FitnessResult r;
+    r.total_return = c.total_return;
+    r.sharpe_ratio = c.sharpe_ratio;
+    r.max_drawdown = c.max_drawdown;
+    r.win_rate = c.win_rate;
+    r.total_trades = c.total_trades;
+    r.profit_factor = c.profit_factor;
+    r.calmar_ratio = c.calmar_ratio;
+    r.fitness_score = c.fitness_score;
+    return r;
+}
+
+bool PopulationEvaluator::evaluate(const CudaStrategyGene* genes, size_t count, CudaFitnessResult* results,
+                                   PopulationBackend backend) const {
+    PROFILE_ZONE_ARG("PopulationEvaluator::evaluate", static_cast<int64_t>(count));
+    if (!available(backend)) {
+        std::cerr << "[ERROR] The " << name(backend) << " population backend is not available: "
+                  << "its kernel does not implement the gene rules" << std::endl;
+        return false;
+    }
+    if (count > 0) evaluateCpu(genes, count, results);
+    return true;
+}
+
+void PopulationEvaluator::evaluateCpu(const CudaStrategyGene* genes, size_t count, CudaFitnessResult* results) const {
+    if (evaluator_.precision() == Precision::Float32) {
+        evaluateCpuAs<float>(genes, count, results);
+    } else {
+        evaluateCpuAs<double>(genes, count, results);
+    }
+}
+
+template <class Real>
+void PopulationEvaluator::evaluateCpuAs(const CudaStrategyGene* genes, size_t count, CudaFitnessResult* results) const {
+    const size_t n = evaluator_.size();
+    std::vector<StrategyGene> batch(count);
+    for (size_t i = 0; i < count; ++i) batch[i] = unpack(genes[i]);
+
+    // Legs read by more than one gene, most shared first, up to the budget
+    std::unordered_map<uint64_t, size_t> uses;
+    for (const StrategyGene& g : batch) {
+        if (GeneEvaluator::usesPrimary(g)) ++uses[legKey(g.primary_indicator, g.primary_period, g.primary_timeframe)];
+        if (GeneEvaluator::usesSecondary(g)) {
+            ++uses[legKey(g.secondary_indicator, g.secondary_period, g.secondary_timeframe)];
+        }
+    }
+    std::vector<std::pair<size_t, uint64_t>> shared;
+    for (const auto& [key, count_of_key] : uses) {
+        if (count_of_key > 1) shared.emplace_back(count_of_key, key);
+    }
+    std::sort(shared.begin(), shared.end(), [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+    const size_t series_bytes = std::max<size_t>(n, 1) * sizeof(Real);
+    shared.resize(std::min(shared.size(), shared_budget_ / series_bytes));
+
+    std::unordered_map<uint64_t, const Real*> legs;
+    std::vector<Real> series(shared.size() * n);
+    {
+        PROFILE_ZONE("PopulationEvaluator::shared_series");
+        pool_.parallelFor(shared.size(), [&](size_t s) {
+            const uint64_t key = shared[s].second;
+            EvaluationArena& arena = EvaluationArena::forThread(EvaluationArena::bytesFor(n));
+            arena.reset();
+            evaluator_.indicatorSeries(static_cast<Indicator>(key >> 40), static_cast<int>(key & 0xffffffffu),
+                                       static_cast<Timeframe>((key >> 32) & 0xff), series.data() + s * n,
+                                       arena.resource());
+        });
+    }
+    for (size_t s = 0; s < shared.size(); ++s) legs.emplace(shared[s].second, series.data() + s * n);
+    auto find = [&](Indicator type, int period, Timeframe tf) -> const Real* {
+        auto it = legs.find(legKey(type, period, tf));
+        return it != legs.end() ? it->second : nullptr;
+    };
+
+    pool_.parallelFor(count, [&](size_t i) {
+        const StrategyGene& g = batch[i];
+        const Real* primary = nullptr;
+        const Real* secondary = nullptr;
+        if (GeneEvaluator::usesPrimary(g)) primary = find(g.primary_indicator, g.primary_period, g.primary_timeframe);
+        if (GeneEvaluator::usesSecondary(g)) {
+            secondary = find(g.secondary_indicator, g.secondary_period, g.secondary_timeframe);
+        }
+        GeneEvaluator::Legs gene_legs;
+        setLegs(gene_legs, primary, secondary);
+        results[i] = pack(evaluator_.evaluate(g, nullptr, nullptr, &gene_legs));
+    });
+}
+
+void evaluate_population_cpu(const CudaStrategyGene* genes, int population_size,
+                             const CudaOHLCV* data, int data_size, CudaFitnessResult* results) {
+    if (population_size <= 0) return;
+    std::vector<OHLCV> bars(static_cast<size_t>(std::max(data_size, 0)));
+    for (size_t i = 0; i < bars.size(); ++i) {
+        bars[i] = {std::string(), data[i].open, data[i].high, data[i].low, data[i].close, data[i].volume};
+    }
+    // No timestamps, so every leg runs on the base bars and the pyramid
+    // stays unbuilt
+    BarView view(bars);
+    TimeframePyramid pyramid;
+    GeneEvaluator evaluator(view, pyramid);
+    ThreadPool pool;
+    PopulationEvaluator batch(view, evaluator, pool);
+
+    std::vector<CudaStrategyGene> base(genes, genes + population_size);
+    for (CudaStrategyGene& g : base) {
+        g.primary_timeframe = static_cast<int>(Timeframe::M1);
+        g.secondary_timeframe = static_cast<int>(Timeframe::M1);
+    }
+    batch.evaluate(base.data(), base.size(), results, PopulationBackend::Cpu);
+}
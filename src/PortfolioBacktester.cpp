@@ -0,0 +1,242 @@
+#include "../include/PortfolioBacktester.hpp"
+#include "../include/Profiler.hpp"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <queue>
+#include <cmath>
+#include <algorithm>
+
+#define LOG(msg) std::cout << "[LOG] " << msg << std::endl;
+
+std::string PortfolioMetrics::toString() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(4);
+    oss << "Equity: " << std::setprecision(2) << final_equity << std::setprecision(4)
+        << " | Return: " << (total_return * 100) << "% | Sharpe: " << sharpe_ratio
+        << " | MaxDD: " << (max_drawdown * 100) << "% | WinRate: " << (win_rate * 100) << "%"
+        << " | Trades: " << total_trades << " | PF: " << profit_factor
+        << " | Rejected: " << rejected_signals << " | MaxOpen: " << max_concurrent_positions;
+    return oss.str();
+}
+
+PortfolioBacktester::PortfolioBacktester(const std::vector<SymbolSeries>& universe,
+                                         StrategyFactory factory,
+                                         const PortfolioConfig& config)
+    : universe_(universe), factory_(std::move(factory)), config_(config), pool_(config.threads) {}
+
+double PortfolioBacktester::markToMarket() const {
+    return cash_equity_ + unrealized_pnl_;
+}
+
+void PortfolioBacktester::closePosition(size_t symbol, double exit_price) {
+    PositionState& pos = positions_[symbol];
+    const double entry_price = pos.position.entryPrice();
+    double pnl = (exit_price - entry_price) * pos.size;
+    cash_equity_ += pnl;
+    unrealized_pnl_ -= (pos.last_close - entry_price) * pos.size;
+    open_notional_ -= entry_price * pos.size;
+    --open_positions_;
+
+    SymbolStats& stats = metrics_.per_symbol[universe_[symbol].symbol];
+    stats.trades++;
+    stats.pnl += pnl;
+    metrics_.total_trades++;
+    if (pnl > 0) {
+        stats.winning_trades++;
+        metrics_.winning_trades++;
+        gross_profit_ += pnl;
+    } else {
+        gross_loss_ -= pnl;
+    }
+    pos.size = 0.0;
+}
+
+void PortfolioBacktester::processSlice(const std::vector<SliceEntry>& slice) {
+    const uint64_t slice_start = latency_ ? LatencyHistogram::now() : 0;
+
+    // 1) Exits for open positions, evaluated against this bar's range. A
+    //    symbol that exits on this bar does not re-enter on the same bar.
+    for (size_t k = 0; k < slice.size(); ++k) {
+        const SliceEntry& e = slice[k];
+        const OHLCV& bar = universe_[e.symbol].bars[e.bar];
+        PositionState& pos = positions_[e.symbol];
+        if (!pos.position.isOpen()) {
+            pos.last_close = bar.close;
+            continue;
+        }
+        unrealized_pnl_ += (bar.close - pos.last_close) * pos.size;
+        pos.last_close = bar.close;
+        ExitFill fill;
+        if (pos.position.step(e.bar, bar.high, bar.low, bar.close, fill)) {
+            closePosition(e.symbol, fill.price);
+            pending_signals_[k].type = SignalType::SELL;
+        }
+    }
+
+    const uint64_t signals_start = latency_ ? LatencyHistogram::now() : 0;
+
+    // 2) Signals for flat symbols, in parallel. Each symbol owns its strategy
+    //    instance and its slot in pending_signals_, so no locking is needed.
+    pool_.parallelFor(slice.size(), [&](size_t k) {
+        const SliceEntry& e = slice[k];
+        if (positions_[e.symbol].position.isOpen() || pending_signals_[k].type == SignalType::SELL || e.bar == 0) {
+            pending_signals_[k].type = SignalType::NONE;
+            return;
+        }
+        if (latency_) {
+            const uint64_t start = LatencyHistogram::now();
+            pending_signals_[k] = strategies_[e.symbol]->generateSignal(universe_[e.symbol].bars, e.bar);
+            latency_->signal.recordSince(start);
+        } else {
+            pending_signals_[k] = strategies_[e.symbol]->generateSignal(universe_[e.symbol].bars, e.bar);
+        }
+    }, config_.min_parallel_symbols);
+
+    // 3) Entries in symbol order against shared equity and limits
+    const uint64_t entries_start = latency_ ? LatencyHistogram::now() : 0;
+    double equity = markToMarket();
+    for (size_t k = 0; k < slice.size(); ++k) {
+        const TradeSignal& signal = pending_signals_[k];
+        if (signal.type != SignalType::BUY) continue;
+
+        const SliceEntry& e = slice[k];
+        PositionState& pos = positions_[e.symbol];
+        double entry_price = universe_[e.symbol].bars[e.bar].close;
+        double risk_per_unit = entry_price - signal.stop_loss;
+
+        double size = 0.0;
+        if (risk_per_unit > 0 && entry_price > 0 && open_positions_ < config_.max_open_positions) {
+            double notional = (equity * config_.risk_per_trade / risk_per_unit) * entry_price;
+            notional = std::min(notional, equity * config_.max_position_pct);
+            notional = std::min(notional, equity * config_.max_gross_exposure - open_notional_);
+            if (notional > 0) size = notional / entry_price;
+        }
+        if (size <= 0) {
+            metrics_.rejected_signals++;
+            continue;
+        }
+
+        pos.position.open(e.bar, entry_price, signal.stop_loss, signal.take_profit, signal.exit);
+        pos.size = size;
+        open_notional_ += entry_price * size;
+        ++open_positions_;
+        metrics_.max_concurrent_positions = std::max(metrics_.max_concurrent_positions, open_positions_);
+    }
+
+    equity_curve_.push_back(markToMarket());
+    if (latency_) {
+        // Exits and entries; the parallel signal phase is excluded
+        const uint64_t slice_end = LatencyHistogram::now();
+        latency_->update.record((signals_start - slice_start) + (slice_end - entries_start));
+        latency_->bar.record(slice_end - slice_start);
+    }
+}
+
+void PortfolioBacktester::run() {
+    PROFILE_ZONE("PortfolioBacktester::run");
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    const size_t n_symbols = universe_.size();
+    strategies_.clear();
+    strategies_.reserve(n_symbols);
+    for (const auto& series : universe_) {
+        strategies_.push_back(factory_(series.symbol));
+    }
+    positions_.assign(n_symbols, PositionState());
+    equity_curve_.clear();
+    metrics_ = PortfolioMetrics();
+    cash_equity_ = config_.initial_equity;
+    unrealized_pnl_ = 0.0;
+    open_notional_ = 0.0;
+    open_positions_ = 0;
+    gross_profit_ = 0.0;
+    gross_loss_ = 0.0;
+    equity_curve_.push_back(cash_equity_);
+
+    size_t total_bars = 0;
+    for (const auto& series : universe_) total_bars += series.bars.size();
+    LOG("Portfolio backtest over " << n_symbols << " symbols, " << total_bars << " bars, "
+        << pool_.size() << " threads");
+
+    // k-way merge: min-heap keyed on (timestamp, symbol index)
+    auto later = [this](const SliceEntry& a, const SliceEntry& b) {
+        const std::string& ta = universe_[a.symbol].bars[a.bar].timestamp;
+        const std::string& tb = universe_[b.symbol].bars[b.bar].timestamp;
+        int cmp = ta.compare(tb);
+        return cmp != 0 ? cmp > 0 : a.symbol > b.symbol;
+    };
+    std::priority_queue<SliceEntry, std::vector<SliceEntry>, decltype(later)> heap(later);
+    for (size_t s = 0; s < n_symbols; ++s) {
+        if (!universe_[s].bars.empty()) heap.push({s, 0});
+    }
+
+    std::vector<SliceEntry> slice;
+    slice.reserve(n_symbols);
+    while (!heap.empty()) {
+        slice.clear();
+        const std::string slice_ts = universe_[heap.top().symbol].bars[heap.top().bar].timestamp;
+        while (!heap.empty()) {
+            SliceEntry top = heap.top();
+            if (universe_[top.symbol].bars[top.bar].timestamp != slice_ts) break;
+            heap.pop();
+            slice.push_back(top);
+            if (top.bar + 1 < universe_[top.symbol].bars.size()) {
+                heap.push({top.symbol, top.bar + 1});
+            }
+        }
+        pending_signals_.assign(slice.size(), TradeSignal{SignalType::NONE, 0, 0.0, 0.0, "", ExitSpec{}});
+        processSlice(slice);
+        metrics_.slices++;
+    }
+
+    // Close anything still open at its last close
+    for (size_t s = 0; s < n_symbols; ++s) {
+        PositionState& pos = positions_[s];
+        if (pos.position.isOpen()) {
+            ExitFill fill = pos.position.close(universe_[s].bars.size() - 1, pos.last_close);
+            closePosition(s, fill.price);
+        }
+    }
+    equity_curve_.push_back(cash_equity_);
+
+    // Portfolio-level metrics from the mark-to-market curve
+    metrics_.final_equity = cash_equity_;
+    metrics_.total_return = (cash_equity_ - config_.initial_equity) / config_.initial_equity;
+    metrics_.win_rate = metrics_.total_trades > 0
+        ? static_cast<double>(metrics_.winning_trades) / metrics_.total_trades : 0.0;
+    metrics_.profit_factor = (gross_loss_ > 0) ? gross_profit_ / gross_loss_ : (gross_profit_ > 0) ? 1000.0 : 0.0;
+
+    double mean = 0.0, m2 = 0.0, peak = equity_curve_.front(), max_dd = 0.0;
+    size_t n_returns = 0;
+    for (size_t i = 1; i < equity_curve_.size(); ++i) {
+        double r = (equity_curve_[i] - equity_curve_[i - 1]) / equity_curve_[i - 1];
+        ++n_returns;
+        double delta = r - mean;
+        mean += delta / n_returns;
+        m2 += delta * (r - mean);
+        peak = std::max(peak, equity_curve_[i]);
+        max_dd = std::max(max_dd, (peak - equity_curve_[i]) / peak);
+    }
+    double std_dev = n_returns > 0 ? std::sqrt(m2 / n_returns) : 0.0;
+    metrics_.sharpe_ratio = std_dev > 0 ? mean / std_dev : 0.0;
+    metrics_.max_drawdown = max_dd;
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    LOG("Portfolio backtest completed in " << duration.count() << "ms over " << metrics_.slices << " timestamps");
+}
+
+void PortfolioBacktester::printSummary() const {
+    std::cout << "\n=== PORTFOLIO RESULTS ===\n" << metrics_.toString() << "\n";
+    std::cout << "\nPer-symbol:\n";
+    for (const auto& kv : metrics_.per_symbol) {
+        const SymbolStats& s = kv.second;
+        double wr = s.trades > 0 ? 100.0 * s.winning_trades / s.trades : 0.0;
+        std::cout << "  " << std::left << std::setw(8) << kv.first << std::right
+                  << " trades: " << std::setw(6) << s.trades
+                  << "  win: " << std::fixed << std::setprecision(1) << std::setw(5) << wr << "%"
+                  << "  pnl: " << std::setprecision(2) << s.pnl << "\n";
+    }
+}
@@ -0,0 +1,70 @@
+#include "../include/PositionEngine.hpp"
+#ifdef COMPUTE_X86
+#include <immintrin.h>
+#endif
+
+namespace PositionRules {
+#ifdef COMPUTE_X86
+    COMPUTE_TARGET_AVX2 size_t scanBarrierAvx2(const double* high, const double* low, size_t from, size_t to,
+                                               double stop, double target) {
+        size_t j = from;
+        const __m256d vstop = _mm256_set1_pd(stop);
+        const __m256d vtarget = _mm256_set1_pd(target);
+        for (; j + 4 <= to; j += 4) {
+            __m256d hit = _mm256_or_pd(_mm256_cmp_pd(_mm256_loadu_pd(low + j), vstop, _CMP_LE_OQ),
+                                       _mm256_cmp_pd(_mm256_loadu_pd(high + j), vtarget, _CMP_GE_OQ));
+            if (_mm256_movemask_pd(hit)) break;
+        }
+        for (; j < to; ++j) {
+            if (low[j] <= stop || high[j] >= target) return j;
+        }
+        return to;
+    }
+
+    // Eight bars per compare; the last partial block is masked, and the
+    // first hit is the lowest set bit of the compare mask
+    COMPUTE_TARGET_AVX512 size_t scanBarrierAvx512(const double* high, const double* low, size_t from, size_t to,
+                                                   double stop, double target) {
+        const __m512d vstop = _mm512_set1_pd(stop);
+        const __m512d vtarget = _mm512_set1_pd(target);
+        for (size_t j = from; j < to; j += 8) {
+            const __mmask8 lanes = to - j >= 8 ? __mmask8(0xff) : static_cast<__mmask8>((1u << (to - j)) - 1);
+            const __mmask8 hit =
+                _mm512_mask_cmp_pd_mask(lanes, _mm512_maskz_loadu_pd(lanes, low + j), vstop, _CMP_LE_OQ) |
+                _mm512_mask_cmp_pd_mask(lanes, _mm512_maskz_loadu_pd(lanes, high + j), vtarget, _CMP_GE_OQ);
+            if (hit) return j + _tzcnt_u32(hit);
+        }
+        return to;
+    }
+
+    COMPUTE_TARGET_AVX2 size_t scanBarrierAvx2(const float* high, const float* low, size_t from, size_t to,
+                                               float stop, float target) {
+        size_t j = from;
+        const __m256 vstop = _mm256_set1_ps(stop);
+        const __m256 vtarget = _mm256_set1_ps(target);
+        for (; j + 8 <= to; j += 8) {
+            __m256 hit = _mm256_or_ps(_mm256_cmp_ps(_mm256_loadu_ps(low + j), vstop, _CMP_LE_OQ),
+                                      _mm256_cmp_ps(_mm256_loadu_ps(high + j), vtarget, _CMP_GE_OQ));
+            if (_mm256_movemask_ps(hit)) break;
+        }
+        for (; j < to; ++j) {
+            if (low[j] <= stop || high[j] >= target) return j;
+        }
+        return to;
+    }
+
+    COMPUTE_TARGET_AVX512 size_t scanBarrierAvx512(const float* high, const float* low, size_t from, size_t to,
+                                                   float stop, float target) {
+        const __m512 vstop = _mm512_set1_ps(stop);
+        const __m512 vtarget = _mm512_set1_ps(target);
+        for (size_t j = from; j < to; j += 16) {
+            const __mmask16 lanes = to - j >= 16 ? __mmask16(0xffff) : static_cast<__mmask16>((1u << (to - j)) - 1);
+            const __mmask16 hit =
+                _mm512_mask_cmp_ps_mask(lanes, _mm512_maskz_loadu_ps(lanes, low + j), vstop, _CMP_LE_OQ) |
+                _mm512_mask_cmp_ps_mask(lanes, _mm512_maskz_loadu_ps(lanes, high + j), vtarget, _CMP_GE_OQ);
+            if (hit) return j + _tzcnt_u32(hit);
+        }
+        return to;
+    }
+#endif
+}
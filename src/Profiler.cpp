@@ -0,0 +1,485 @@
+#include "../include/Profiler.hpp"
+
+#if defined(TRADING_PROFILE)
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <thread>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Profiler {
+
+struct SiteStats {
+    uint64_t calls = 0;
+    uint64_t ticks = 0;
+    uint64_t min_ticks = UINT64_MAX;
+    uint64_t max_ticks = 0;
+    uint64_t counted_calls = 0;  // calls that also have counter deltas
+    uint64_t counters[kCounterCount] = {};
+};
+
+// One zone (ticks = duration) or instant event (ticks = kInstant)
+struct TraceEvent {
+    uint64_t start;
+    uint64_t ticks;
+    int64_t arg;
+    uint32_t site;
+};
+
+struct TraceChunk {
+    size_t count = 0;
+    uint32_t tid = 0;
+    TraceEvent events[kChunkEvents];
+};
+
+struct ThreadBuffer {
+    std::array<SiteStats, kMaxSites> sites;
+    uint32_t tid = 0;               // trace thread id, in registration order
+    TraceChunk* chunk = nullptr;    // events not yet handed to the writer
+    int perf_fd = -1;  // group leader; -1 when counters are off for this thread
+    int member_fds[kCounterCount - 1] = {-1, -1, -1};
+
+    ~ThreadBuffer() {
+#if defined(__linux__)
+        for (int fd : member_fds) {
+            if (fd >= 0) close(fd);
+        }
+        if (perf_fd >= 0) close(perf_fd);
+#endif
+    }
+};
+
+namespace {
+    std::atomic<uint32_t> g_site_count{0};
+    const char* g_site_names[kMaxSites] = {};
+
+    // Thread buffers outlive their threads so the exit report sees them
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        uint64_t start_ticks = now();
+        std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+        bool counters = false;
+    };
+
+    constexpr uint64_t kInstant = UINT64_MAX;
+
+    // Chunks cycle between the threads, the writer queue and the free list;
+    // at most kMaxQueuedChunks + one per thread + one being written exist
+    struct Tracer {
+        std::atomic<bool> active{false};
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::deque<TraceChunk*> queue;
+        std::vector<TraceChunk*> free;
+        std::vector<std::unique_ptr<TraceChunk>> storage;
+        std::atomic<uint64_t> dropped{0};
+        bool stopping = false;
+        std::thread writer;
+        std::ofstream out;
+        uint64_t origin = 0;       // ticks at startTrace
+        double ticks_per_us = 1.0;
+        bool first_event = true;
+    };
+
+    Tracer& tracer() {
+        static Tracer* instance = new Tracer();  // leaked like the registry
+        return *instance;
+    }
+
+    // Ticks per nanosecond over a busy-wait of at least `wait`
+    double measureTicksPerNs(std::chrono::steady_clock::time_point since, uint64_t since_ticks,
+                             std::chrono::nanoseconds wait) {
+#if defined(PROFILER_HAS_TSC)
+        auto elapsed = std::chrono::steady_clock::now() - since;
+        while (elapsed < wait) elapsed = std::chrono::steady_clock::now() - since;
+        const uint64_t ticks = now() - since_ticks;
+        const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        return ns > 0 ? static_cast<double>(ticks) / ns : 1.0;
+#else
+        (void)since;
+        (void)since_ticks;
+        (void)wait;
+        return 1.0;
+#endif
+    }
+
+    std::string jsonName(const char* name) {
+        std::string out;
+        for (const char* c = name; *c; ++c) {
+            if (*c == '"' || *c == '\\') out += '\\';
+            out += *c;
+        }
+        return out;
+    }
+
+    // Caller holds t.mutex
+    TraceChunk* freeChunk(Tracer& t) {
+        if (!t.free.empty()) {
+            TraceChunk* chunk = t.free.back();
+            t.free.pop_back();
+            return chunk;
+        }
+        t.storage.push_back(std::make_unique<TraceChunk>());
+        return t.storage.back().get();
+    }
+
+    // Hands a full chunk to the writer and returns an empty one for the
+    // thread; when the writer is kMaxQueuedChunks behind, the events are
+    // dropped and the same chunk is reused
+    TraceChunk* submit(Tracer& t, TraceChunk* chunk) {
+        std::lock_guard<std::mutex> lock(t.mutex);
+        if (t.queue.size() >= kMaxQueuedChunks) {
+            t.dropped.fetch_add(chunk->count, std::memory_order_relaxed);
+            chunk->count = 0;
+            return chunk;
+        }
+        t.queue.push_back(chunk);
+        t.ready.notify_one();
+        TraceChunk* next = freeChunk(t);
+        next->count = 0;
+        next->tid = chunk->tid;
+        return next;
+    }
+
+    void writeChunk(Tracer& t, const TraceChunk& chunk) {
+        char line[96];
+        for (size_t k = 0; k < chunk.count; ++k) {
+            const TraceEvent& e = chunk.events[k];
+            const double ts = static_cast<double>(e.start - t.origin) / t.ticks_per_us;
+            t.out << (t.first_event ? "\n" : ",\n") << "{\"name\":\"" << jsonName(g_site_names[e.site]) << "\",";
+            t.first_event = false;
+            if (e.ticks == kInstant) {
+                std::snprintf(line, sizeof(line), "\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f", ts);
+            } else {
+                std::snprintf(line, sizeof(line), "\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f", ts,
+                              static_cast<double>(e.ticks) / t.ticks_per_us);
+            }
+            t.out << line << ",\"pid\":1,\"tid\":" << chunk.tid;
+            if (e.arg >= 0) t.out << ",\"args\":{\"n\":" << e.arg << "}";
+            t.out << "}";
+        }
+    }
+
+    void writerLoop(Tracer& t) {
+        for (;;) {
+            TraceChunk* chunk = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(t.mutex);
+                t.ready.wait(lock, [&] { return t.stopping || !t.queue.empty(); });
+                if (t.queue.empty()) return;  // stopping and drained
+                chunk = t.queue.front();
+                t.queue.pop_front();
+            }
+            writeChunk(t, *chunk);
+            std::lock_guard<std::mutex> lock(t.mutex);
+            chunk->count = 0;
+            t.free.push_back(chunk);
+        }
+    }
+
+    void traceEvent(ThreadBuffer& buffer, uint32_t site, uint64_t start, uint64_t ticks, int64_t arg) {
+        Tracer& t = tracer();
+        if (!buffer.chunk) {
+            std::lock_guard<std::mutex> lock(t.mutex);
+            buffer.chunk = freeChunk(t);
+            buffer.chunk->count = 0;
+            buffer.chunk->tid = buffer.tid;
+        }
+        buffer.chunk->events[buffer.chunk->count++] = {start, ticks, arg, site};
+        if (buffer.chunk->count == kChunkEvents) buffer.chunk = submit(t, buffer.chunk);
+    }
+
+    // Opens the file and starts the writer; false if the file cannot be
+    // written or a trace is already running
+    bool openTrace(Tracer& t, const std::string& path) {
+        std::lock_guard<std::mutex> lock(t.mutex);
+        if (t.active.load() || t.writer.joinable()) return false;
+        t.out.open(path, std::ios::trunc);
+        if (!t.out) return false;
+        const auto since = std::chrono::steady_clock::now();
+        t.origin = now();
+        t.ticks_per_us = 1e3 * measureTicksPerNs(since, t.origin, std::chrono::milliseconds(5));
+        t.out << "{\"traceEvents\":[";
+        t.first_event = true;
+        t.stopping = false;
+        t.dropped = 0;
+        t.writer = std::thread(writerLoop, std::ref(t));
+        t.active.store(true);
+        return true;
+    }
+
+    void reportAtExit() {
+        stopTrace();
+        report(std::cerr);
+    }
+
+    Registry& registry() {
+        static Registry* instance = [] {
+            auto* r = new Registry();  // leaked: must survive static destruction of other objects
+            const char* env = std::getenv("TRADING_PROFILE_COUNTERS");
+            r->counters = env && env[0] && std::strcmp(env, "0") != 0;
+            const char* trace = std::getenv("TRADING_TRACE");
+            if (trace && trace[0] && !openTrace(tracer(), trace)) {
+                std::cerr << "[WARNING] Cannot write trace file " << trace << std::endl;
+            }
+            std::atexit(reportAtExit);
+            return r;
+        }();
+        return *instance;
+    }
+
+#if defined(__linux__)
+    int openCounter(uint64_t config, int group) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = group < 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+    }
+
+    // Cycles leads a group with the other three so one read() returns all
+    void openCounters(ThreadBuffer& buffer) {
+        static std::once_flag warned;
+        const uint64_t configs[kCounterCount] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                 PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        int leader = openCounter(configs[0], -1);
+        bool ok = leader >= 0;
+        for (size_t k = 1; ok && k < kCounterCount; ++k) {
+            buffer.member_fds[k - 1] = openCounter(configs[k], leader);
+            ok = buffer.member_fds[k - 1] >= 0;
+        }
+        if (!ok) {
+            for (int& fd : buffer.member_fds) {
+                if (fd >= 0) close(fd);
+                fd = -1;
+            }
+            if (leader >= 0) close(leader);
+            std::call_once(warned, [] {
+                std::cerr << "[WARNING] perf_event counters unavailable (" << std::strerror(errno)
+                          << "); profiling time only" << std::endl;
+            });
+            return;
+        }
+        ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        buffer.perf_fd = leader;
+    }
+#endif
+
+    // TSC ticks per nanosecond, measured against the steady clock over the
+    // whole run (at least 10 ms)
+    double ticksPerNs() {
+        Registry& r = registry();
+        return measureTicksPerNs(r.start_time, r.start_ticks, std::chrono::milliseconds(10));
+    }
+}
+
+Site::Site(const char* site_name) : name(site_name) {
+    const uint32_t next = g_site_count.fetch_add(1, std::memory_order_relaxed);
+    if (next < kMaxSites) {
+        id = next;
+        g_site_names[id] = site_name;
+    } else {
+        id = kMaxSites - 1;  // overflow sites share the last slot
+        g_site_names[id] = "(other)";
+    }
+}
+
+ThreadBuffer& threadBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        Registry& r = registry();
+        auto owned = std::make_unique<ThreadBuffer>();
+#if defined(__linux__)
+        if (r.counters) openCounters(*owned);
+#endif
+        buffer = owned.get();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        owned->tid = static_cast<uint32_t>(r.buffers.size());
+        r.buffers.push_back(std::move(owned));
+    }
+    return *buffer;
+}
+
+bool readCounters(ThreadBuffer& buffer, uint64_t* values) {
+#if defined(__linux__)
+    if (buffer.perf_fd < 0) return false;
+    struct {
+        uint64_t count;
+        uint64_t values[kCounterCount];
+    } group;
+    if (read(buffer.perf_fd, &group, sizeof(group)) != static_cast<ssize_t>(sizeof(group))) return false;
+    std::memcpy(values, group.values, sizeof(group.values));
+    return true;
+#else
+    (void)buffer;
+    (void)values;
+    return false;
+#endif
+}
+
+void record(ThreadBuffer& buffer, uint32_t site, uint64_t start, uint64_t ticks, int64_t arg,
+            const uint64_t* counter_delta) {
+    if (tracer().active.load(std::memory_order_relaxed)) traceEvent(buffer, site, start, ticks, arg);
+    SiteStats& s = buffer.sites[site];
+    ++s.calls;
+    s.ticks += ticks;
+    s.min_ticks = std::min(s.min_ticks, ticks);
+    s.max_ticks = std::max(s.max_ticks, ticks);
+    if (counter_delta) {
+        ++s.counted_calls;
+        for (size_t k = 0; k < kCounterCount; ++k) s.counters[k] += counter_delta[k];
+    }
+}
+
+void instant(const Site& site, int64_t arg) {
+    if (!tracer().active.load(std::memory_order_relaxed)) return;
+    traceEvent(threadBuffer(), site.id, now(), kInstant, arg);
+}
+
+bool startTrace(const std::string& path) {
+    registry();  // registers the exit handler that finishes the file
+    return openTrace(tracer(), path);
+}
+
+void stopTrace() {
+    Tracer& t = tracer();
+    if (!t.active.exchange(false)) return;
+
+    // Hand over every thread's partial chunk, ignoring the queue bound
+    std::vector<uint32_t> tids;
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> registry_lock(r.mutex);
+        std::lock_guard<std::mutex> lock(t.mutex);
+        for (auto& buffer : r.buffers) {
+            tids.push_back(buffer->tid);
+            if (buffer->chunk) {
+                if (buffer->chunk->count) t.queue.push_back(buffer->chunk);
+                else t.free.push_back(buffer->chunk);
+                buffer->chunk = nullptr;
+            }
+        }
+        t.stopping = true;
+    }
+    t.ready.notify_one();
+    t.writer.join();
+
+    for (uint32_t tid : tids) {
+        t.out << (t.first_event ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+              << ",\"args\":{\"name\":\"" << (tid == 0 ? "main" : "thread " + std::to_string(tid)) << "\"}}";
+        t.first_event = false;
+    }
+    t.out << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":" << t.dropped.load() << "}}\n";
+    t.out.close();
+    if (t.dropped.load()) {
+        std::cerr << "[WARNING] Trace writer fell behind; " << t.dropped.load() << " events dropped" << std::endl;
+    }
+    std::lock_guard<std::mutex> lock(t.mutex);
+    t.queue.clear();
+    t.free.clear();
+    t.storage.clear();
+}
+
+void report(std::ostream& out) {
+    Registry& r = registry();
+    const uint32_t sites = std::min<uint32_t>(g_site_count.load(), kMaxSites);
+
+    struct Row {
+        const char* name;
+        SiteStats total;
+        size_t threads = 0;
+    };
+    std::vector<Row> rows;
+    size_t thread_count = 0;
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        thread_count = r.buffers.size();
+        for (uint32_t id = 0; id < sites; ++id) {
+            Row row{g_site_names[id], SiteStats()};
+            for (const auto& buffer : r.buffers) {
+                const SiteStats& s = buffer->sites[id];
+                if (s.calls == 0) continue;
+                ++row.threads;
+                row.total.calls += s.calls;
+                row.total.ticks += s.ticks;
+                row.total.min_ticks = std::min(row.total.min_ticks, s.min_ticks);
+                row.total.max_ticks = std::max(row.total.max_ticks, s.max_ticks);
+                row.total.counted_calls += s.counted_calls;
+                for (size_t k = 0; k < kCounterCount; ++k) row.total.counters[k] += s.counters[k];
+            }
+            if (row.total.calls) rows.push_back(row);
+        }
+    }
+    if (rows.empty()) return;
+    std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) { return a.total.ticks > b.total.ticks; });
+
+    const double tpn = ticksPerNs();
+    bool any_counters = false;
+    for (const Row& row : rows) any_counters |= row.total.counted_calls > 0;
+
+    std::ostringstream oss;
+    oss << "\n=== Profile (" << thread_count << " threads";
+#if defined(PROFILER_HAS_TSC)
+    oss << ", TSC " << std::fixed << std::setprecision(3) << tpn << " GHz";
+#endif
+    oss << ") ===\n"
+        << std::left << std::setw(36) << "Zone" << std::right << std::setw(10) << "Calls" << std::setw(8) << "Thr"
+        << std::setw(12) << "Total ms" << std::setw(12) << "Mean us" << std::setw(12) << "Min us"
+        << std::setw(12) << "Max us";
+    if (any_counters) oss << std::setw(8) << "IPC" << std::setw(12) << "Cache/kI" << std::setw(12) << "Branch/kI";
+    oss << "\n" << std::string(any_counters ? 134 : 102, '-') << "\n";
+    for (const Row& row : rows) {
+        const SiteStats& s = row.total;
+        auto us = [&](double ticks) { return ticks / tpn / 1e3; };
+        oss << std::left << std::setw(36) << row.name << std::right << std::setw(10) << s.calls
+            << std::setw(8) << row.threads << std::fixed << std::setprecision(2)
+            << std::setw(12) << us(static_cast<double>(s.ticks)) / 1e3
+            << std::setw(12) << us(static_cast<double>(s.ticks) / s.calls)
+            << std::setw(12) << us(static_cast<double>(s.min_ticks))
+            << std::setw(12) << us(static_cast<double>(s.max_ticks));
+        if (any_counters && s.counted_calls && s.counters[0] && s.counters[1]) {
+            const double instr = static_cast<double>(s.counters[1]);
+            oss << std::setw(8) << instr / s.counters[0]
+                << std::setw(12) << 1e3 * s.counters[2] / instr
+                << std::setw(12) << 1e3 * s.counters[3] / instr;
+        }
+        oss << "\n";
+    }
+    if (any_counters) oss << "(per 1000 instructions; zone counters include nested zones)\n";
+    out << oss.str() << std::flush;
+}
+
+void reset() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (auto& buffer : r.buffers) buffer->sites.fill(SiteStats());
+}
+
+} // namespace Profiler
+#endif
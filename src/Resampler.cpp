@@ -0,0 +1,257 @@
+#include "../include/Resampler.hpp"
+#include "../include/DataStore.hpp"
+#include "../include/TimeUtils.hpp"
+#include "../include/Profiler.hpp"
+#include "../include/FileUtils.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#define LOG(msg)     std::cout << "[LOG] " << msg << std::endl;
+#define ERROR(msg)   std::cerr << "[ERROR] " << msg << std::endl;
+
+namespace {
+    constexpr int64_t kSessionOpen = 9 * 3600 + 30 * 60; // 09:30 New York
+
+    int64_t timeframeSeconds(Timeframe tf) {
+        switch (tf) {
+            case Timeframe::M1:  return 60;
+            case Timeframe::M5:  return 5 * 60;
+            case Timeframe::M15: return 15 * 60;
+            case Timeframe::H1:  return 3600;
+            case Timeframe::D1:  return 86400;
+        }
+        return 60;
+    }
+
+    int64_t floorDiv(int64_t a, int64_t b) {
+        return a >= 0 ? a / b : -((-a + b - 1) / b);
+    }
+
+    std::string storeSymbol(const std::string& symbol, Timeframe tf) {
+        return symbol + "@" + Resampler::timeframeName(tf);
+    }
+
+    // Fingerprint of the base a stored pyramid was built from, kept in
+    // <root>/<symbol>.pyramid as "bars,last_timestamp,hash"
+    std::filesystem::path fingerprintPath(const std::string& store_root, const std::string& symbol) {
+        return std::filesystem::path(store_root) / (symbol + ".pyramid");
+    }
+
+    // FNV-1a over every base bar: timestamp and OHLCV
+    uint64_t baseHash(const BarView& base) {
+        uint64_t hash = 1469598103934665603ULL;
+        auto mix = [&hash](const void* data, size_t size) {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                hash ^= bytes[i];
+                hash *= 1099511628211ULL;
+            }
+        };
+        for (size_t i = 0; i < base.size(); ++i) {
+            const OHLCV& bar = base[i];
+            mix(bar.timestamp.data(), bar.timestamp.size());
+            const double values[5] = {bar.open, bar.high, bar.low, bar.close, bar.volume};
+            mix(values, sizeof(values));
+        }
+        return hash;
+    }
+
+    std::string fingerprint(const BarView& base) {
+        std::ostringstream out;
+        out << base.size() << "," << (base.empty() ? std::string() : base.back().timestamp) << ","
+            << std::hex << baseHash(base) << "\n";
+        return out.str();
+    }
+
+    // Fills base_end from bucket starts: bar k ends where bar k+1 begins
+    bool rebuildBaseEnd(const BarView& base, TimeframeLevel& level) {
+        const auto& bars = level.bars;
+        level.base_end.assign(bars.size(), 0);
+        for (size_t k = 0; k < bars.size(); ++k) {
+            size_t end = (k + 1 < bars.size()) ? base.lowerBound(bars[k + 1].timestamp) : base.size();
+            size_t begin = k > 0 ? level.base_end[k - 1] : 0;
+            if (end <= begin) return false;
+            // The first base bar of every bucket must map back to that bucket
+            int64_t t;
+            if (!TimeUtils::tryParseTimestamp(base[begin].timestamp, t) ||
+                TimeUtils::formatTimestamp(Resampler::bucketStart(t, level.timeframe)) != bars[k].timestamp) {
+                return false;
+            }
+            level.base_end[k] = static_cast<uint32_t>(end);
+        }
+        return !bars.empty() && level.base_end.back() == base.size();
+    }
+}
+
+namespace Resampler {
+    const char* timeframeName(Timeframe tf) {
+        switch (tf) {
+            case Timeframe::M1:  return "1m";
+            case Timeframe::M5:  return "5m";
+            case Timeframe::M15: return "15m";
+            case Timeframe::H1:  return "1h";
+            case Timeframe::D1:  return "1d";
+        }
+        return "1m";
+    }
+
+    bool parseTimeframe(const std::string& name, Timeframe& out) {
+        for (Timeframe tf : kTimeframes) {
+            if (name == timeframeName(tf)) {
+                out = tf;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int64_t bucketStart(int64_t t, Timeframe tf) {
+        int64_t offset = TimeUtils::easternUtcOffset(t);
+        int64_t local = t + offset;
+        int64_t day_start = floorDiv(local, 86400) * 86400;
+        if (tf == Timeframe::D1) return day_start - offset;
+
+        int64_t span = timeframeSeconds(tf);
+        int64_t start = day_start + kSessionOpen + floorDiv(local - day_start - kSessionOpen, span) * span;
+        return std::max(start, day_start) - offset;
+    }
+}
+
+TimeframePyramid TimeframePyramid::build(const BarView& base) {
+    PROFILE_ZONE("TimeframePyramid::build");
+    TimeframePyramid pyramid;
+    pyramid.setBase(base);
+    pyramid.levels_.resize(kTimeframeCount);
+    for (size_t l = 0; l < kTimeframeCount; ++l) {
+        pyramid.levels_[l].timeframe = kTimeframes[l];
+        if (kTimeframes[l] != Timeframe::M1) {
+            pyramid.levels_[l].bars.reserve(base.size() / (timeframeSeconds(kTimeframes[l]) / 60) + 1);
+        }
+    }
+
+    std::vector<int64_t> current(kTimeframeCount, INT64_MIN);
+    int64_t t = 0;
+    for (size_t i = 0; i < base.size(); ++i) {
+        const OHLCV& bar = base[i];
+        // An unparseable timestamp continues the current bucket
+        TimeUtils::tryParseTimestamp(bar.timestamp, t);
+
+        for (size_t l = 1; l < kTimeframeCount; ++l) {
+            TimeframeLevel& level = pyramid.levels_[l];
+            int64_t start = Resampler::bucketStart(t, level.timeframe);
+            if (start != current[l] || level.bars.empty()) {
+                current[l] = start;
+                level.bars.push_back({TimeUtils::formatTimestamp(start), bar.open, bar.high, bar.low, bar.close, bar.volume});
+                level.base_end.push_back(static_cast<uint32_t>(i + 1));
+                continue;
+            }
+            OHLCV& agg = level.bars.back();
+            agg.high = std::max(agg.high, bar.high);
+            agg.low = std::min(agg.low, bar.low);
+            agg.close = bar.close;
+            agg.volume += bar.volume;
+            level.base_end.back() = static_cast<uint32_t>(i + 1);
+        }
+    }
+    return pyramid;
+}
+
+TimeframePyramid TimeframePyramid::loadOrBuild(const std::string& store_root, const std::string& symbol, const BarView& base) {
+    if (base.empty()) return build(base);
+
+    // Stored levels are reused only if they were built from exactly these
+    // bars: a corrected or extended base (e.g. a last bucket that was still
+    // filling when it was saved) maps to the same buckets but not the same values
+    std::string stored;
+    {
+        std::ifstream in(fingerprintPath(store_root, symbol));
+        std::getline(in, stored);
+        stored += "\n";
+    }
+    int64_t first, last;
+    if (stored == fingerprint(base) &&
+        TimeUtils::tryParseTimestamp(base.front().timestamp, first) &&
+        TimeUtils::tryParseTimestamp(base.back().timestamp, last)) {
+        DataStore store(store_root);
+        TimeframePyramid pyramid;
+        pyramid.setBase(base);
+        pyramid.levels_.resize(kTimeframeCount);
+        bool complete = true;
+        for (size_t l = 0; l < kTimeframeCount && complete; ++l) {
+            TimeframeLevel& level = pyramid.levels_[l];
+            level.timeframe = kTimeframes[l];
+            if (level.timeframe == Timeframe::M1) continue;
+            level.bars = store.load(storeSymbol(symbol, level.timeframe),
+                                    Resampler::bucketStart(first, level.timeframe),
+                                    Resampler::bucketStart(last, level.timeframe));
+            complete = rebuildBaseEnd(base, level);
+        }
+        if (complete) return pyramid;
+    }
+
+    LOG("Building timeframe pyramid for " << symbol << " from " << base.size() << " bars");
+    TimeframePyramid pyramid = build(base);
+    pyramid.save(store_root, symbol);
+    return pyramid;
+}
+
+bool TimeframePyramid::save(const std::string& store_root, const std::string& symbol) const {
+    bool ok = true;
+    for (const auto& level : levels_) {
+        if (level.timeframe == Timeframe::M1 || level.bars.empty()) continue;
+        ok = DataStore::ingest(store_root, storeSymbol(symbol, level.timeframe), level.bars) && ok;
+    }
+    // Written last, so a partial save is never taken for a complete one
+    if (ok) ok = FileUtils::atomicWrite(fingerprintPath(store_root, symbol), fingerprint(base_));
+    if (!ok) ERROR("Could not persist timeframe pyramid for " << symbol);
+    return ok;
+}
+
+void TimeframePyramid::setBase(const BarView& base) {
+    base_ = base;
+    base_first_ = base.empty() ? std::string() : base.front().timestamp;
+    base_last_ = base.empty() ? std::string() : base.back().timestamp;
+}
+
+bool TimeframePyramid::builtFrom(const BarView& data) const {
+    if (!built() || data.size() != base_.size()) return false;
+    if (data.empty()) return true;
+    // A buffer refilled with other bars keeps its addresses, so compare the
+    // timestamps recorded at build time too
+    return &data.front() == &base_.front() && &data.back() == &base_.back() &&
+           data.front().timestamp == base_first_ && data.back().timestamp == base_last_;
+}
+
+const TimeframeLevel& TimeframePyramid::level(Timeframe tf) const {
+    if (levels_.empty()) throw std::logic_error("TimeframePyramid has not been built");
+    return levels_[static_cast<size_t>(tf)];
+}
+
+BarView TimeframePyramid::view(Timeframe tf) const {
+    if (tf == Timeframe::M1) return base_;
+    return BarView(level(tf).bars);
+}
+
+template <class T>
+void TimeframePyramid::alignToBase(Timeframe tf, const T* values, size_t count, T* out, T fill) const {
+    if (tf == Timeframe::M1) {
+        std::copy(values, values + std::min(count, base_.size()), out);
+        return;
+    }
+    const auto& ends = level(tf).base_end;
+    std::fill(out, out + base_.size(), fill);
+    // values[k] becomes visible at the first base bar after bucket k: a bar
+    // cannot be known to be the last of its bucket until the next one prints
+    for (size_t k = 0; k < ends.size() && k < count; ++k) {
+        size_t from = ends[k];
+        size_t to = (k + 1 < ends.size()) ? ends[k + 1] : base_.size();
+        std::fill(out + from, out + to, values[k]);
+    }
+}
+
+template void TimeframePyramid::alignToBase(Timeframe, const double*, size_t, double*, double) const;
+template void TimeframePyramid::alignToBase(Timeframe, const float*, size_t, float*, float) const;
@@ -0,0 +1,139 @@
+#include "../include/ScreeningReport.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <numeric>
+#include <sstream>
+
+namespace {
+    // NaN sorts lowest so a failed score never ranks as a finalist
+    double orderKey(double score) {
+        return std::isnan(score) ? -HUGE_VAL : score;
+    }
+
+    // Indices by descending score, ties by index
+    std::vector<size_t> byScore(const std::vector<double>& scores) {
+        std::vector<size_t> order(scores.size());
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return orderKey(scores[a]) > orderKey(scores[b]);
+        });
+        return order;
+    }
+
+    // 1-based ranks, tied scores sharing their mean rank
+    std::vector<double> ranks(const std::vector<double>& scores) {
+        const std::vector<size_t> order = byScore(scores);
+        std::vector<double> rank(scores.size());
+        for (size_t i = 0; i < order.size();) {
+            size_t j = i + 1;
+            while (j < order.size() && orderKey(scores[order[j]]) == orderKey(scores[order[i]])) ++j;
+            const double mean = 0.5 * static_cast<double>(i + 1 + j);
+            for (size_t k = i; k < j; ++k) rank[order[k]] = mean;
+            i = j;
+        }
+        return rank;
+    }
+
+    double pearson(const std::vector<double>& x, const std::vector<double>& y) {
+        const double n = static_cast<double>(x.size());
+        const double mx = std::accumulate(x.begin(), x.end(), 0.0) / n;
+        const double my = std::accumulate(y.begin(), y.end(), 0.0) / n;
+        double sxy = 0.0, sxx = 0.0, syy = 0.0;
+        for (size_t i = 0; i < x.size(); ++i) {
+            sxy += (x[i] - mx) * (y[i] - my);
+            sxx += (x[i] - mx) * (x[i] - mx);
+            syy += (y[i] - my) * (y[i] - my);
+        }
+        if (sxx == 0.0 || syy == 0.0) return sxx == syy ? 1.0 : 0.0;
+        return sxy / std::sqrt(sxx * syy);
+    }
+
+    double kendallTauB(const std::vector<double>& x, const std::vector<double>& y) {
+        double concordant = 0.0, discordant = 0.0, ties_x = 0.0, ties_y = 0.0;
+        for (size_t i = 0; i < x.size(); ++i) {
+            for (size_t j = i + 1; j < x.size(); ++j) {
+                const double dx = x[i] - x[j];
+                const double dy = y[i] - y[j];
+                if (dx == 0.0 && dy == 0.0) continue;
+                if (dx == 0.0) {
+                    ties_x += 1.0;
+                } else if (dy == 0.0) {
+                    ties_y += 1.0;
+                } else if ((dx > 0) == (dy > 0)) {
+                    concordant += 1.0;
+                } else {
+                    discordant += 1.0;
+                }
+            }
+        }
+        const double denom = std::sqrt((concordant + discordant + ties_y) * (concordant + discordant + ties_x));
+        if (denom == 0.0) return ties_x == ties_y ? 1.0 : 0.0;
+        return (concordant - discordant) / denom;
+    }
+}
+
+ScreeningReport ScreeningReport::compare(const std::vector<double>& screened, const std::vector<double>& reference,
+                                         size_t top_k) {
+    ScreeningReport report;
+    const size_t n = std::min(screened.size(), reference.size());
+    report.candidates = n;
+    report.top_k = std::min(top_k, n);
+    if (n == 0) return report;
+    const std::vector<double> s(screened.begin(), screened.begin() + n);
+    const std::vector<double> r(reference.begin(), reference.begin() + n);
+
+    for (size_t i = 0; i < n; ++i) {
+        double abs_error = 0.0, rel_error = 0.0;
+        if (s[i] != r[i]) {
+            if (std::isfinite(s[i]) && std::isfinite(r[i])) {
+                abs_error = std::fabs(s[i] - r[i]);
+                rel_error = abs_error / std::max(std::fabs(r[i]), 1e-12);
+            } else {
+                abs_error = rel_error = HUGE_VAL;
+            }
+        }
+        report.max_abs_error = std::max(report.max_abs_error, abs_error);
+        if (rel_error > report.max_rel_error) {
+            report.max_rel_error = rel_error;
+            report.worst = i;
+        }
+    }
+
+    const std::vector<double> rank_s = ranks(s);
+    const std::vector<double> rank_r = ranks(r);
+    report.spearman = pearson(rank_s, rank_r);
+    report.kendall_tau = kendallTauB(rank_s, rank_r);
+
+    const std::vector<size_t> order_s = byScore(s);
+    const std::vector<size_t> order_r = byScore(r);
+    report.same_best = orderKey(r[order_s[0]]) == orderKey(r[order_r[0]]);
+    std::vector<size_t> top_s(order_s.begin(), order_s.begin() + report.top_k);
+    std::vector<size_t> top_r(order_r.begin(), order_r.begin() + report.top_k);
+    std::sort(top_s.begin(), top_s.end());
+    std::sort(top_r.begin(), top_r.end());
+    std::vector<size_t> both;
+    std::set_intersection(top_s.begin(), top_s.end(), top_r.begin(), top_r.end(), std::back_inserter(both));
+    report.top_k_overlap = both.size();
+    return report;
+}
+
+bool ScreeningReport::within(double max_rel_error_bound, double min_rank_correlation) const {
+    return max_rel_error <= max_rel_error_bound && spearman >= min_rank_correlation && same_best;
+}
+
+std::string ScreeningReport::toString() const {
+    std::ostringstream out;
+    out << "Float32 screening vs float64 re-score (" << candidates << " candidates)\n";
+    out << "  Spearman rank correlation: " << spearman << "\n";
+    out << "  Kendall tau-b:             " << kendall_tau << "\n";
+    out << "  Same best:                 " << (same_best ? "yes" : "no") << "\n";
+    const std::string top_label = "  Top-" + std::to_string(top_k) + " overlap:";
+    out << top_label << std::string(top_label.size() < 29 ? 29 - top_label.size() : 1, ' ')
+        << top_k_overlap << "/" << top_k << "\n";
+    out << "  Max absolute error:        " << max_abs_error << "\n";
+    out << "  Max relative error:        " << max_rel_error << " (candidate " << worst << ")\n";
+    out << "  Within bounds:             " << (within() ? "yes" : "no")
+        << " (relative error <= " << kMaxRelError << ", Spearman >= " << kMinRankCorrelation << ")";
+    return out.str();
+}
@@ -1,5 +1,7 @@
 #include "../include/Strategy.hpp"
 #include "../include/MovingAverage.hpp"
+#include "../include/IndicatorSeries.hpp"
+#include "../include/Profiler.hpp"
 #include <algorithm>
 #include <iostream>
 #include <vector>
@@ -23,7 +25,7 @@ double Strategy::calculateDaysBetween(const std::string& start_timestamp, const
 }
 
 // Calculate dynamic SMA and RSI periods based on data date range
-std::pair<size_t, size_t> Strategy::calculateDynamicPeriods(const std::vector<OHLCV>& data) {
+std::pair<size_t, size_t> Strategy::calculateDynamicPeriods(const BarView& data) {
     if (data.size() < 2) {
         std::cout << "Not enough data for dynamic period calculation, using defaults" << std::endl;
         return {50, 14}; // Default periods
@@ -54,89 +56,95 @@ std::pair<size_t, size_t> Strategy::calculateDynamicPeriods(const std::vector<OH
     return {sma_period, rsi_period};
 }
 
-void GoldenFoundationStrategy::precomputeSignals(const std::vector<OHLCV>& data) {
+void GoldenFoundationStrategy::precomputeSignals(const BarView& data) {
+    PROFILE_ZONE("GoldenFoundation::precomputeSignals");
     if (data.empty()) return;
     
     int n = static_cast<int>(data.size());
     
-    // Calculate dynamic periods based on data date range
-    auto periods = calculateDynamicPeriods(data);
-    sma_period_ = periods.first;
-    rsi_period_ = periods.second;
-    
-    const double rsi_oversold = 30.0;
-    
-    // Allocate arrays
-    sma_values_.resize(n);
-    rsi_values_.resize(n);
-    signals_.resize(n);
-    stops_.resize(n);
-    targets_.resize(n);
+    // Calculate dynamic periods based on data date range, unless both were set
+    const bool dynamic = !(fixed_sma_ && fixed_rsi_);
+    if (dynamic) {
+        auto periods = calculateDynamicPeriods(data);
+        if (!fixed_sma_) sma_period_ = periods.first;
+        if (!fixed_rsi_) rsi_period_ = periods.second;
+    }
     
-    std::cout << "Computing indicators on CPU for " << n << " bars with dynamic periods..." << std::endl;
-    std::cout << "Using SMA period: " << sma_period_ << ", RSI period: " << rsi_period_ << std::endl;
+    const double rsi_oversold = fixed_rsi_ ? rsi_oversold_ : 30.0;
     
-    // Pre-compute all indicators
-    for (int i = 0; i < n; i++) {
-        sma_values_[i] = Indicators::SMA(data, i, sma_period_);
-        rsi_values_[i] = Indicators::RSI(data, i, rsi_period_);
+    if (dynamic) {
+        std::cout << "Computing indicators on CPU for " << n << " bars with dynamic periods..." << std::endl;
+        std::cout << "Using SMA period: " << sma_period_ << ", RSI period: " << rsi_period_ << std::endl;
     }
     
-    // Pre-compute all signals
-    int signal_count = 0;
+    std::vector<double> close(n), high(n), low(n);
     for (int i = 0; i < n; i++) {
-        if (i < std::max(sma_period_, rsi_period_)) {
-            signals_[i] = 0;
-            stops_[i] = 0.0;
-            targets_[i] = 0.0;
-            continue;
-        }
-        
-        // Check conditions for buy signal
-        bool uptrend = data[i].close > sma_values_[i];
-        bool oversold = rsi_values_[i] < rsi_oversold;
-        
-        // FVG detection
-        bool fvg = Indicators::detectFVG(data, i);
-        
-        if (uptrend && oversold && fvg) {
-            signals_[i] = 1; // BUY signal
-            double entry = data[i].close;
-            double stop_loss_pct = 0.005 / risk_reward_;
-            stops_[i] = entry - (entry * stop_loss_pct);
-            targets_[i] = entry + (entry - stops_[i]) * risk_reward_;
-            signal_count++;
-        } else {
-            signals_[i] = 0; // NO signal
-            stops_[i] = 0.0;
-            targets_[i] = 0.0;
-        }
+        close[i] = data[i].close;
+        high[i] = data[i].high;
+        low[i] = data[i].low;
     }
+    signals_.compute(close.data(), high.data(), low.data(), n, sma_period_, rsi_period_, rsi_oversold, risk_reward_);
     
-    std::cout << "CPU generated " << signal_count << " signals using dynamic periods" << std::endl;
+    if (dynamic) {
+        std::cout << "CPU generated " << signals_.count << " signals using dynamic periods" << std::endl;
+    }
     precomputed_ = true;
 }
 
-TradeSignal GoldenFoundationStrategy::generateSignal(const std::vector<OHLCV>& data, size_t current_index) {
+template <class Real>
+void GoldenFoundationSignals<Real>::compute(const Real* close, const Real* high, const Real* low, size_t n,
+                                            size_t sma_period, size_t rsi_period, double rsi_oversold,
+                                            double risk_reward) {
+    // Pre-compute all indicators (same values as the per-bar Indicators::)
+    sma.resize(n);
+    rsi.resize(n);
+    entry.assign(n, 0);
+    stop.assign(n, Real(0));
+    target.assign(n, Real(0));
+    count = 0;
+    std::vector<uint8_t> fvg(n);
+    Indicators::Series::sma(close, n, sma_period, sma.data());
+    Indicators::Series::rsi(close, n, rsi_period, rsi.data());
+    Indicators::Series::fvg(high, low, n, fvg.data());
+    
+    const Real oversold = static_cast<Real>(rsi_oversold);
+    const Real stop_loss_pct = static_cast<Real>(0.005 / risk_reward);
+    const Real reward = static_cast<Real>(risk_reward);
+    for (size_t i = std::max(sma_period, rsi_period); i < n; i++) {
+        // Uptrend, oversold and an open fair-value gap
+        if (close[i] > sma[i] && rsi[i] < oversold && fvg[i]) {
+            entry[i] = 1;
+            stop[i] = close[i] - (close[i] * stop_loss_pct);
+            target[i] = close[i] + (close[i] - stop[i]) * reward;
+            count++;
+        }
+    }
+}
+
+template struct GoldenFoundationSignals<double>;
+template struct GoldenFoundationSignals<float>;
+
+TradeSignal GoldenFoundationStrategy::generateSignal(const BarView& data, size_t current_index) {
     if (!precomputed_) {
         precomputeSignals(data);
     }
     
-    if (current_index >= signals_.size()) {
-        return {SignalType::NONE, current_index, 0.0, 0.0, "Index out of range"};
+    if (current_index >= signals_.entry.size()) {
+        return {SignalType::NONE, current_index, 0.0, 0.0, "Index out of range", ExitSpec{}};
     }
     
-    if (signals_[current_index] == 1) {
+    if (signals_.entry[current_index]) {
         return {
             SignalType::BUY,
             current_index,
-            stops_[current_index],
-            targets_[current_index],
-            "CPU: Uptrend, RSI<30, FVG (Dynamic periods)"
+            signals_.stop[current_index],
+            signals_.target[current_index],
+            "CPU: Uptrend, RSI<30, FVG (Dynamic periods)",
+            ExitSpec{}
         };
     }
     
-    return {SignalType::NONE, current_index, 0.0, 0.0, "CPU: No setup"};
+    return {SignalType::NONE, current_index, 0.0, 0.0, "CPU: No setup", ExitSpec{}};
 }
 
 // Factory function implementation
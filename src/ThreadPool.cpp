@@ -0,0 +1,74 @@
+#include "../include/ThreadPool.hpp"
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // The caller participates in every parallelFor, so spawn one fewer worker
+    for (size_t i = 1; i < threads; ++i) {
+        workers_.emplace_back([this] { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& t : workers_) {
+        if (t.joinable()) t.join();
+    }
+}
+
+void ThreadPool::runChunks() {
+    const auto& fn = *job_;
+    for (size_t i = next_index_.fetch_add(1); i < job_size_; i = next_index_.fetch_add(1)) {
+        fn(i);
+    }
+}
+
+void ThreadPool::workerLoop() {
+    unsigned long long seen_generation = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+            if (stopping_) return;
+            seen_generation = generation_;
+        }
+        runChunks();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--pending_workers_ == 0) done_cv_.notify_one();
+        }
+    }
+}
+
+void ThreadPool::parallelFor(size_t n, const std::function<void(size_t)>& fn, size_t min_parallel) {
+    if (n == 0) return;
+    if (workers_.empty() || n < min_parallel) {
+        for (size_t i = 0; i < n; ++i) fn(i);
+        return;
+    }
+
+    std::lock_guard<std::mutex> call_lock(call_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &fn;
+        job_size_ = n;
+        next_index_.store(0);
+        pending_workers_ = workers_.size();
+        ++generation_;
+    }
+    work_cv_.notify_all();
+
+    runChunks();
+
+    // Every worker checks in once per generation, so none can still be
+    // touching job_ after this returns
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [&] { return pending_workers_ == 0; });
+    job_ = nullptr;
+}
@@ -0,0 +1,193 @@
+#include "../include/TpeOptimizer.hpp"
+#include "../include/ThreadPool.hpp"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <cmath>
+#include <limits>
+
+namespace {
+    const double kSqrt2 = std::sqrt(2.0);
+    const double kLogSqrt2Pi = 0.5 * std::log(2.0 * std::acos(-1.0));
+
+    double normalCdf(double z) { return 0.5 * std::erfc(-z / kSqrt2); }
+}
+
+TpeOptimizer::TpeOptimizer(std::vector<SearchDimension> space, uint64_t seed, const TpeOptions& options)
+    : space_(std::move(space)), options_(options), rng_(seed) {}
+
+double TpeOptimizer::toUnit(size_t dim, double value) const {
+    const SearchDimension& d = space_[dim];
+    switch (d.kind) {
+        case SearchDimension::Kind::Integer:
+            // Every integer gets an equal share of the interval
+            return (value - d.low + 0.5) / (d.high - d.low + 1.0);
+        case SearchDimension::Kind::Categorical:
+            return value;
+        default:
+            return d.high > d.low ? (value - d.low) / (d.high - d.low) : 0.0;
+    }
+}
+
+double TpeOptimizer::fromUnit(size_t dim, double unit) const {
+    const SearchDimension& d = space_[dim];
+    if (d.kind == SearchDimension::Kind::Categorical) return unit;
+    unit = std::clamp(unit, 0.0, 1.0);
+    if (d.kind == SearchDimension::Kind::Integer) {
+        return std::min(d.high, d.low + std::floor(unit * (d.high - d.low + 1.0)));
+    }
+    return d.low + unit * (d.high - d.low);
+}
+
+SearchPoint TpeOptimizer::uniformPoint() {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    SearchPoint point(space_.size());
+    for (size_t d = 0; d < space_.size(); ++d) {
+        if (space_[d].kind == SearchDimension::Kind::Categorical) {
+            point[d] = std::uniform_int_distribution<int>(0, space_[d].choices - 1)(rng_);
+        } else {
+            point[d] = fromUnit(d, unit(rng_));
+        }
+    }
+    return point;
+}
+
+// Numeric: one Gaussian per member plus a wide prior at the centre, each
+// as wide as the larger gap to its sorted neighbours (hyperopt's rule).
+// Categorical: choice frequencies with one pseudo-count per choice.
+TpeOptimizer::Density TpeOptimizer::fit(size_t dim, const std::vector<size_t>& members) const {
+    Density density;
+    if (space_[dim].kind == SearchDimension::Kind::Categorical) {
+        const int choices = space_[dim].choices;
+        density.centers.assign(choices, 1.0);
+        for (size_t t : members) {
+            int c = static_cast<int>(trials_[t].point[dim]);
+            if (c >= 0 && c < choices) density.centers[c] += 1.0;
+        }
+        const double total = static_cast<double>(members.size() + choices);
+        for (double& w : density.centers) w /= total;
+        return density;
+    }
+
+    density.centers.reserve(members.size() + 1);
+    for (size_t t : members) density.centers.push_back(toUnit(dim, trials_[t].point[dim]));
+    std::sort(density.centers.begin(), density.centers.end());
+    // The prior goes in sorted position; its index is kept because a member
+    // can sit at the centre too
+    const auto prior_at = std::lower_bound(density.centers.begin(), density.centers.end(), 0.5);
+    const size_t prior = static_cast<size_t>(prior_at - density.centers.begin());
+    density.centers.insert(prior_at, 0.5);
+
+    const size_t k = density.centers.size();
+    const double min_width = 1.0 / std::min<double>(100.0, static_cast<double>(k));
+    density.widths.resize(k);
+    for (size_t i = 0; i < k; ++i) {
+        const double left = density.centers[i] - (i > 0 ? density.centers[i - 1] : 0.0);
+        const double right = (i + 1 < k ? density.centers[i + 1] : 1.0) - density.centers[i];
+        density.widths[i] = std::clamp(std::max(left, right), min_width, 1.0);
+    }
+    // The prior keeps the whole interval reachable
+    density.widths[prior] = 1.0;
+    density.norms.resize(k);
+    for (size_t i = 0; i < k; ++i) {
+        const double mu = density.centers[i], sigma = density.widths[i];
+        const double mass = normalCdf((1.0 - mu) / sigma) - normalCdf(-mu / sigma);
+        density.norms[i] = sigma * mass * k;
+    }
+    return density;
+}
+
+double TpeOptimizer::sample(size_t dim, const Density& density) {
+    if (space_[dim].kind == SearchDimension::Kind::Categorical) {
+        std::discrete_distribution<int> choice(density.centers.begin(), density.centers.end());
+        return choice(rng_);
+    }
+    std::uniform_int_distribution<size_t> component(0, density.centers.size() - 1);
+    const size_t c = component(rng_);
+    std::normal_distribution<double> normal(density.centers[c], density.widths[c]);
+    // Truncated to the unit interval by rejection
+    for (int tries = 0; tries < 64; ++tries) {
+        double x = normal(rng_);
+        if (x >= 0.0 && x <= 1.0) return x;
+    }
+    return std::clamp(density.centers[c], 0.0, 1.0);
+}
+
+double TpeOptimizer::logPdf(size_t dim, const Density& density, double unit) const {
+    if (space_[dim].kind == SearchDimension::Kind::Categorical) {
+        return std::log(density.centers[static_cast<size_t>(unit)]);
+    }
+    double sum = 0.0;
+    for (size_t i = 0; i < density.centers.size(); ++i) {
+        const double z = (unit - density.centers[i]) / density.widths[i];
+        sum += std::exp(-0.5 * z * z) / density.norms[i];
+    }
+    return std::log(sum) - kLogSqrt2Pi;
+}
+
+std::vector<SearchPoint> TpeOptimizer::propose(size_t count) {
+    std::vector<SearchPoint> points;
+    points.reserve(count);
+    if (trials_.size() < std::max<size_t>(options_.startup_trials, 2)) {
+        for (size_t k = 0; k < count; ++k) points.push_back(uniformPoint());
+        return points;
+    }
+
+    // Best scores first; ties keep observation order
+    std::vector<size_t> order(trials_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return trials_[a].score > trials_[b].score; });
+    const size_t n_good = std::clamp<size_t>(static_cast<size_t>(std::ceil(options_.gamma * order.size())), 1,
+                                             std::min(order.size() - 1, std::max<size_t>(options_.max_good, 1)));
+    const std::vector<size_t> good(order.begin(), order.begin() + n_good);
+    const std::vector<size_t> bad(order.begin() + n_good, order.end());
+
+    std::vector<Density> good_density, bad_density;
+    for (size_t d = 0; d < space_.size(); ++d) {
+        good_density.push_back(fit(d, good));
+        bad_density.push_back(fit(d, bad));
+    }
+
+    // Whole candidate points compete on their summed log ratio; picking
+    // every coordinate's best draw on its own exploits too greedily
+    const size_t candidates = std::max<size_t>(options_.candidates, 1);
+    std::vector<double> units(space_.size()), best_units(space_.size());
+    for (size_t k = 0; k < count; ++k) {
+        double best_ratio = -std::numeric_limits<double>::infinity();
+        for (size_t c = 0; c < candidates; ++c) {
+            double ratio = 0.0;
+            for (size_t d = 0; d < space_.size(); ++d) {
+                units[d] = sample(d, good_density[d]);
+                ratio += logPdf(d, good_density[d], units[d]) - logPdf(d, bad_density[d], units[d]);
+            }
+            if (ratio > best_ratio) {
+                best_ratio = ratio;
+                best_units = units;
+            }
+        }
+        SearchPoint point(space_.size());
+        for (size_t d = 0; d < space_.size(); ++d) point[d] = fromUnit(d, best_units[d]);
+        points.push_back(std::move(point));
+    }
+    return points;
+}
+
+void TpeOptimizer::observe(const SearchPoint& point, double score) {
+    if (std::isnan(score)) score = -std::numeric_limits<double>::infinity();
+    trials_.push_back({point, score});
+    if (trials_.size() == 1 || score > trials_[best_].score) best_ = trials_.size() - 1;
+}
+
+const SearchTrial& TpeOptimizer::optimize(const std::function<double(const SearchPoint&)>& objective,
+                                          size_t budget, size_t batch, ThreadPool& pool) {
+    batch = std::max<size_t>(batch, 1);
+    for (size_t done = 0; done < budget;) {
+        const std::vector<SearchPoint> points = propose(std::min(batch, budget - done));
+        std::vector<double> scores(points.size());
+        pool.parallelFor(points.size(), [&](size_t k) { scores[k] = objective(points[k]); });
+        for (size_t k = 0; k < points.size(); ++k) observe(points[k], scores[k]);
+        done += points.size();
+    }
+    return best();
+}
@@ -0,0 +1,95 @@
+#include "../include/DataLoader.hpp"
+#include "../include/DataStore.hpp"
+#include "../include/Resampler.hpp"
+#include "../include/TimeUtils.hpp"
+#include <iostream>
+#include <string>
+
+// Usage:
+//   data_store ingest <root> <SYMBOL> <file.csv>
+//   data_store info   <root>
+//   data_store query  <root> <SYMBOL> <from> <to>
+//   data_store pyramid <root> <SYMBOL>
+// Dates are UTC, "YYYY-MM-DD" or "YYYY-MM-DD HH:MM:SS". A date-only <to>
+// covers the whole day.
+static void usage() {
+    std::cerr << "Usage:\n"
+              << "  data_store ingest <root> <SYMBOL> <file.csv>\n"
+              << "  data_store info   <root>\n"
+              << "  data_store query  <root> <SYMBOL> <from> <to>\n"
+              << "  data_store pyramid <root> <SYMBOL>\n";
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        usage();
+        return 1;
+    }
+    std::string command = argv[1];
+    std::string root = argv[2];
+
+    if (command == "ingest" && argc == 5) {
+        auto bars = DataLoader::loadCSV(argv[4]);
+        if (bars.empty()) {
+            std::cerr << "[ERROR] No bars loaded from " << argv[4] << std::endl;
+            return 1;
+        }
+        return DataStore::ingest(root, argv[3], bars) ? 0 : 1;
+    }
+
+    if (command == "info") {
+        DataStore store(root);
+        for (const auto& symbol : store.symbols()) {
+            auto shards = store.shardsFor(symbol, INT64_MIN, INT64_MAX);
+            uint64_t rows = 0, bytes = 0;
+            for (const auto& s : shards) {
+                rows += s.rows;
+                bytes += s.byte_length;
+            }
+            std::cout << symbol << ": " << shards.size() << " shards, " << rows << " bars, "
+                      << bytes << " bytes, " << TimeUtils::formatTimestamp(shards.front().first_time)
+                      << " to " << TimeUtils::formatTimestamp(shards.back().last_time) << "\n";
+        }
+        return 0;
+    }
+
+    if (command == "query" && argc == 6) {
+        std::string from_str = argv[4], to_str = argv[5];
+        int64_t from, to;
+        if (!TimeUtils::tryParseTimestamp(from_str, from) || !TimeUtils::tryParseTimestamp(to_str, to)) {
+            std::cerr << "[ERROR] Could not parse date range" << std::endl;
+            return 1;
+        }
+        if (to_str.size() == 10) to += 86399;
+
+        DataStore store(root);
+        auto slices = store.map(argv[3], from, to);
+        size_t bars = 0;
+        for (const auto& s : slices) bars += s.count;
+        std::cout << argv[3] << ": " << bars << " bars in " << slices.size() << " shards ("
+                  << bars * sizeof(BarRecord) << " bytes)\n";
+        if (bars > 0) {
+            std::cout << "  first: " << TimeUtils::formatTimestamp(slices.front().records[0].time) << "\n"
+                      << "  last : " << TimeUtils::formatTimestamp(slices.back().records[slices.back().count - 1].time) << "\n";
+        }
+        return 0;
+    }
+
+    // Builds (or validates) the 5m/15m/1h/1d levels stored as SYMBOL@<tf>
+    if (command == "pyramid" && argc == 4) {
+        DataStore store(root);
+        auto bars = store.load(argv[3], INT64_MIN, INT64_MAX);
+        if (bars.empty()) {
+            std::cerr << "[ERROR] No bars stored for " << argv[3] << std::endl;
+            return 1;
+        }
+        auto pyramid = TimeframePyramid::loadOrBuild(root, argv[3], bars);
+        for (Timeframe tf : kTimeframes) {
+            std::cout << "  " << Resampler::timeframeName(tf) << ": " << pyramid.view(tf).size() << " bars\n";
+        }
+        return 0;
+    }
+
+    usage();
+    return 1;
+}
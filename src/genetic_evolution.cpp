@@ -1,12 +1,21 @@
 
 #include "../include/GeneticStrategy.hpp"
+#include "../include/PopulationEvaluator.hpp"
 #include "../include/DataLoader.hpp"
+#include "../include/Profiler.hpp"
 #include <fstream>
 #include <chrono>
 #include <iostream>
 #include <filesystem>
 #include <limits>
 #include <numeric>
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <cstdint>
 
 
 #define LOG(msg)     std::cout << "[LOG] " << msg << std::endl;
@@ -25,8 +34,9 @@ namespace {
             : label(std::move(name)), start(std::chrono::high_resolution_clock::now()) {}
         ~ScopedTimer() {
             auto end = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::seconds>(end - start).count();
-            INFO(label << " completed in " << duration << " seconds");
+            std::ostringstream seconds;
+            seconds << std::fixed << std::setprecision(3) << std::chrono::duration<double>(end - start).count();
+            INFO(label << " completed in " << seconds.str() << " seconds");
         }
     };
 
@@ -44,12 +54,13 @@ namespace {
         return {};
     }
 
-    void print_params(int pop, int gen, double mut, double cross) {
+    void print_params(int pop, int gen, double mut, double cross, uint64_t seed) {
         INFO("Genetic Algorithm Parameters:");
         std::cout << "  Population Size : " << pop   << "\n"
                   << "  Generations     : " << gen   << "\n"
                   << "  Mutation Rate   : " << mut   << "\n"
                   << "  Crossover Rate  : " << cross << "\n"
+                  << "  Seed            : " << seed  << " (rerun with --seed " << seed << ")\n"
                   << "  Mode            : Overnight Training\n";
     }
 
@@ -122,7 +133,102 @@ namespace {
     }
 }
 
-int main() {
+} // namespace
+
+// Usage: genetic_evolution [--seed N] [--threads N] [--checkpoint FILE] [--checkpoint-every N] [--resume]
+//                          [--telemetry FILE] [--racing] [--racing-blocks N] [--racing-rank K] [--trace FILE]
+//                          [--batch cpu] [--float32] [--finalists K]
+// A run is reproducible from its seed regardless of the thread count. The
+// run state is snapshotted to the checkpoint file (default
+// evolution_checkpoint.bin) every generation, or every N with
+// --checkpoint-every; the fitness cache is appended to
+// evolution_checkpoint.bin.cache.<epoch>. --resume continues from them.
+// Per-generation telemetry goes to evolution_telemetry.csv by default.
+// --racing stops backtests that provably cannot reach the K-th best fitness
+// (default 10) of the previous generation, checking every 1/N of the bars
+// (default 8). --trace writes a Chrome Trace Event file of the profiling
+// zones (open it in Perfetto); it needs a -DTRADING_PROFILE=ON build.
+// --batch evaluates each generation as one batch on the CPU backend instead
+// of gene by gene; it does not combine with --racing. The CUDA backend is
+// refused until its kernel implements the gene rules.
+// --float32 screens every generation in single precision, then re-scores the
+// K best distinct genes (default 20) in double and reports how well the two
+// rankings agree; the best strategy comes from the double scores.
+int main(int argc, char** argv) {
+    uint64_t seed = GeneticAlgorithm::randomSeed();
+    size_t threads = 0;
+    std::string checkpoint_path = "evolution_checkpoint.bin";
+    int checkpoint_every = 1;
+    bool resume = false;
+    std::string telemetry_path = "evolution_telemetry.csv";
+    bool racing = false;
+    size_t racing_blocks = 8, racing_rank = 10;
+    std::string trace_path;
+    bool batched = false;
+    PopulationBackend batch_backend = PopulationBackend::Cpu;
+    Precision screening = Precision::Float64;
+    size_t finalists = 20;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) {
+            seed = std::stoull(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--checkpoint" && i + 1 < argc) {
+            checkpoint_path = argv[++i];
+        } else if (arg == "--checkpoint-every" && i + 1 < argc) {
+            checkpoint_every = std::stoi(argv[++i]);
+        } else if (arg == "--resume") {
+            resume = true;
+        } else if (arg == "--telemetry" && i + 1 < argc) {
+            telemetry_path = argv[++i];
+        } else if (arg == "--racing") {
+            racing = true;
+        } else if (arg == "--racing-blocks" && i + 1 < argc) {
+            racing_blocks = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--racing-rank" && i + 1 < argc) {
+            racing_rank = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--trace" && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (arg == "--batch" && i + 1 < argc && PopulationEvaluator::parse(argv[i + 1], batch_backend)) {
+            batched = true;
+            ++i;
+        } else if (arg == "--float32") {
+            screening = Precision::Float32;
+        } else if (arg == "--finalists" && i + 1 < argc) {
+            finalists = static_cast<size_t>(std::stoul(argv[++i]));
+        } else {
+            std::cerr << "Usage: genetic_evolution [--seed N] [--threads N] [--checkpoint FILE] [--checkpoint-every N] [--resume] [--telemetry FILE]"
+                      << " [--racing] [--racing-blocks N] [--racing-rank K] [--trace FILE] [--batch cpu]"
+                      << " [--float32] [--finalists K]" << std::endl;
+            return 1;
+        }
+    }
+    if (!trace_path.empty()) {
+#if defined(TRADING_PROFILE)
+        if (!Profiler::startTrace(trace_path)) {
+            ERROR("Cannot write trace file " << trace_path);
+            return 1;
+        }
+        INFO("Tracing to " << trace_path);
+#else
+        ERROR("--trace needs a build with -DTRADING_PROFILE=ON");
+        return 1;
+#endif
+    }
+    if (batched && batch_backend == PopulationBackend::Cuda) {
+        ERROR("--batch cuda is not supported: the CUDA population kernel does not implement gene semantics yet");
+        return 1;
+    }
+    if (batched && !PopulationEvaluator::available(batch_backend)) {
+        ERROR("--batch " << PopulationEvaluator::name(batch_backend) << " is not available in this build");
+        return 1;
+    }
+    if (batched && racing) {
+        ERROR("--racing does not apply to --batch (batches run every backtest in full); use one or the other");
+        return 1;
+    }
+
     std::string data_path;
     const std::vector<std::string> search_paths = {
         "data/SPY_1m.csv",
@@ -142,11 +248,25 @@ int main() {
 
     int population_size = 200, generations = 200;
     double mutation_rate = 0.1, crossover_rate = 0.8;
-    print_params(population_size, generations, mutation_rate, crossover_rate);
+    print_params(population_size, generations, mutation_rate, crossover_rate, seed);
 
     ScopedTimer timer("Evolution");
 
-    GeneticAlgorithm ga(data, population_size, generations, mutation_rate, crossover_rate);
+    GeneticAlgorithm ga(data, population_size, generations, mutation_rate, crossover_rate, seed, threads);
+    ga.setCheckpoint(checkpoint_path, checkpoint_every);
+    ga.setRacing(racing, racing_blocks, racing_rank);
+    if (!ga.setBatchEvaluation(batched, batch_backend)) return 1;
+    if (batched) INFO("Batched evaluation on " << PopulationEvaluator::name(batch_backend));
+    ga.setScreening(screening, finalists);
+    if (screening == Precision::Float32) INFO("Float32 screening, " << finalists << " finalists re-scored in float64");
+    if (resume) {
+        if (!std::filesystem::exists(checkpoint_path)) {
+            INFO("No checkpoint at " << checkpoint_path << ", starting a new run");
+        } else if (!ga.resume(checkpoint_path)) {
+            return 1;
+        }
+    }
+    ga.setTelemetry(telemetry_path, resume);
     auto final_population = ga.evolve();
 
     StrategyGene best_strategy = ga.getBestStrategy();
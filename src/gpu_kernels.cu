@@ -8,6 +8,9 @@
 #include <thrust/sequence.h>
 #include <iostream>
 #include <cuda_profiler_api.h>
+#include "../include/PositionEngine.hpp"
+#include "../include/IndicatorKernels.hpp"
+#include "../include/PopulationEvaluator.hpp"
 
 // Error checking macros
 #define CUDA_CHECK_RETURN_NULLPTR(call) \
@@ -32,215 +35,69 @@ __device__ __forceinline__ int getOptimalBlockSize() {
     return 256; // Optimized for most modern GPUs
 }
 
-// Optimized SMA kernel with improved memory coalescing
+// One thread per bar; Indicators::Kernels is the CPU reference, so these
+// series are bit-identical to Indicators::SMA / RSI and the Series backends
 __global__ void optimized_sma_kernel(const double* prices, double* sma, int n, int period) {
-    extern __shared__ double s_prices[];
     int idx = blockIdx.x * blockDim.x + threadIdx.x;
-    int tid = threadIdx.x;
-    
     if (idx >= n) return;
-
-    // Coalesced memory access pattern
-    int window_start = max(0, idx - period + 1);
-    int window_end = min(n - 1, idx);
-    
-    // Load data into shared memory with coalesced access
-    double local_sum = 0.0;
-    for (int i = window_start; i <= window_end; i += blockDim.x) {
-        int load_idx = i + tid;
-        if (load_idx <= window_end) {
-            local_sum += prices[load_idx];
-        }
-    }
-    
-    // Reduce within thread block
-    __shared__ double s_sums[256];
-    s_sums[tid] = local_sum;
-    __syncthreads();
-    
-    // Parallel reduction
-    for (int stride = blockDim.x / 2; stride > 0; stride >>= 1) {
-        if (tid < stride) {
-            s_sums[tid] += s_sums[tid + stride];
-        }
-        __syncthreads();
-    }
-    
-    if (tid == 0) {
-        int block_start = blockIdx.x * blockDim.x;
-        int block_end = min(n - 1, block_start + blockDim.x - 1);
-        int actual_period = min(period, block_end - block_start + 1);
-        sma[idx] = s_sums[0] / actual_period;
-    }
+    sma[idx] = Indicators::Kernels::sma(Indicators::Kernels::ArrayClose{prices}, idx, period);
 }
 
-// Optimized RSI kernel with improved numerical stability
 __global__ void optimized_rsi_kernel(const double* prices, double* rsi, int n, int period) {
-    extern __shared__ double s_data[];
     int idx = blockIdx.x * blockDim.x + threadIdx.x;
-    
     if (idx >= n) return;
-    
-    if (idx < period) {
-        rsi[idx] = 50.0;
-        return;
-    }
-    
-    // Load price data into shared memory
-    int start_idx = idx - period;
-    for (int i = 0; i <= period; i += blockDim.x) {
-        int load_idx = start_idx + i + threadIdx.x;
-        if (load_idx <= idx && load_idx < n) {
-            s_data[threadIdx.x * (period + 1) + i] = prices[load_idx];
-        }
-    }
-    __syncthreads();
-    
-    // Calculate gains and losses
-    double gain_sum = 0.0, loss_sum = 0.0;
-    for (int i = 1; i <= period; i++) {
-        double change = s_data[threadIdx.x * (period + 1) + i] - s_data[threadIdx.x * (period + 1) + i - 1];
-        if (change > 0) {
-            gain_sum += change;
-        } else if (change < 0) {
-            loss_sum -= change;
-        }
-    }
-    
-    // Improved numerical stability
-    if (gain_sum + loss_sum < 1e-10) {
-        rsi[idx] = 50.0;
+    rsi[idx] = Indicators::Kernels::rsi(Indicators::Kernels::ArrayClose{prices}, idx, period);
+}
+
+// Entry rule of GoldenFoundationStrategy::precomputeSignals for bar idx
+__device__ void golden_foundation_signal(
+    int idx, double price, double sma_val, double rsi_val, bool fvg,
+    int warmup, double rsi_oversold, double risk_reward,
+    int* signals, double* stops, double* targets
+) {
+    bool uptrend = price > sma_val;
+    bool oversold = rsi_val < rsi_oversold;
+    if (idx >= warmup && uptrend && oversold && fvg) {
+        signals[idx] = 1; // BUY signal
+        double entry = price;
+        double stop_loss_pct = 0.005 / risk_reward;
+        stops[idx] = entry - (entry * stop_loss_pct);
+        targets[idx] = entry + (entry - stops[idx]) * risk_reward;
     } else {
-        double avg_gain = gain_sum / period;
-        double avg_loss = loss_sum / period;
-        
-        if (avg_loss < 1e-10) {
-            rsi[idx] = 100.0;
-        } else {
-            double rs = avg_gain / avg_loss;
-            rsi[idx] = 100.0 - (100.0 / (1.0 + rs));
-        }
+        signals[idx] = 0; // NO signal
+        stops[idx] = 0.0;
+        targets[idx] = 0.0;
     }
 }
 
 // Fused kernel that calculates SMA, RSI, and generates signals in one pass
 __global__ void fused_indicators_kernel(
-    const double* prices, 
+    const double* prices, const double* highs, const double* lows,
     double* sma, double* rsi, int* signals, double* stops, double* targets,
     int n, int sma_period, int rsi_period, double rsi_oversold, double risk_reward
 ) {
-    extern __shared__ double s_data[];
     int idx = blockIdx.x * blockDim.x + threadIdx.x;
-    int tid = threadIdx.x;
-    
     if (idx >= n) return;
-    
-    // Calculate SMA
-    if (idx >= sma_period - 1) {
-        double sma_sum = 0.0;
-        for (int i = idx - sma_period + 1; i <= idx; i++) {
-            sma_sum += prices[i];
-        }
-        sma[idx] = sma_sum / sma_period;
-    } else {
-        sma[idx] = 0.0;
-    }
-    
-    // Calculate RSI
-    if (idx >= rsi_period) {
-        double gain_sum = 0.0, loss_sum = 0.0;
-        for (int i = idx - rsi_period + 1; i <= idx; i++) {
-            double change = prices[i] - prices[i - 1];
-            if (change > 0) gain_sum += change;
-            else loss_sum -= change;
-        }
-        
-        if (gain_sum + loss_sum < 1e-10) {
-            rsi[idx] = 50.0;
-        } else {
-            double avg_gain = gain_sum / rsi_period;
-            double avg_loss = loss_sum / rsi_period;
-            
-            if (avg_loss < 1e-10) {
-                rsi[idx] = 100.0;
-            } else {
-                double rs = avg_gain / avg_loss;
-                rsi[idx] = 100.0 - (100.0 / (1.0 + rs));
-            }
-        }
-    } else {
-        rsi[idx] = 50.0;
-    }
-    
-    // Generate signals
-    if (idx >= max(sma_period, rsi_period)) {
-        bool uptrend = prices[idx] > sma[idx];
-        bool oversold = rsi[idx] < rsi_oversold;
-        
-        // Enhanced FVG detection
-        bool fvg = false;
-        if (idx >= 1) {
-            double gap_threshold = 0.01; // 1% threshold
-            fvg = (prices[idx] > prices[idx-1] * (1.0 + gap_threshold)) || 
-                  (prices[idx] < prices[idx-1] * (1.0 - gap_threshold));
-        }
-        
-        if (uptrend && oversold && fvg) {
-            signals[idx] = 1; // BUY signal
-            double entry = prices[idx];
-            double stop_loss_pct = 0.005 / risk_reward;
-            stops[idx] = entry * (1.0 - stop_loss_pct);
-            targets[idx] = entry + (entry - stops[idx]) * risk_reward;
-        } else {
-            signals[idx] = 0; // NO signal
-            stops[idx] = 0.0;
-            targets[idx] = 0.0;
-        }
-    } else {
-        signals[idx] = 0;
-        stops[idx] = 0.0;
-        targets[idx] = 0.0;
-    }
+
+    const Indicators::Kernels::ArrayClose close{prices};
+    sma[idx] = Indicators::Kernels::sma(close, idx, sma_period);
+    rsi[idx] = Indicators::Kernels::rsi(close, idx, rsi_period);
+    bool fvg = idx >= 1 && Indicators::Kernels::fvg(highs[idx - 1], lows[idx - 1], highs[idx], lows[idx]);
+    golden_foundation_signal(idx, prices[idx], sma[idx], rsi[idx], fvg, max(sma_period, rsi_period),
+                             rsi_oversold, risk_reward, signals, stops, targets);
 }
 
-// Optimized signal generation kernel with vectorized operations
+// Signals from precomputed SMA and RSI series
 __global__ void optimized_signal_kernel(
-    const double* prices, const double* sma, const double* rsi,
+    const double* prices, const double* highs, const double* lows, const double* sma, const double* rsi,
     int* signals, double* stops, double* targets,
     int n, double rsi_oversold, double risk_reward
 ) {
     int idx = blockIdx.x * blockDim.x + threadIdx.x;
     if (idx >= n) return;
-    
-    // Vectorized condition checking
-    double price = prices[idx];
-    double sma_val = sma[idx];
-    double rsi_val = rsi[idx];
-    
-    // Use bitwise operations for condition checking
-    bool uptrend = price > sma_val;
-    bool oversold = rsi_val < rsi_oversold;
-    
-    // Enhanced FVG detection with multiple timeframes
-    bool fvg = false;
-    if (idx >= 1) {
-        double gap_threshold = 0.01;
-        double price_change = price / prices[idx-1];
-        fvg = (price_change > 1.0 + gap_threshold) || (price_change < 1.0 - gap_threshold);
-    }
-    
-    // Combined condition check
-    if (uptrend && oversold && fvg) {
-        signals[idx] = 1;
-        double entry = price;
-        double stop_loss_pct = 0.005 / risk_reward;
-        stops[idx] = entry * (1.0 - stop_loss_pct);
-        targets[idx] = entry + (entry - stops[idx]) * risk_reward;
-    } else {
-        signals[idx] = 0;
-        stops[idx] = 0.0;
-        targets[idx] = 0.0;
-    }
+    bool fvg = idx >= 1 && Indicators::Kernels::fvg(highs[idx - 1], lows[idx - 1], highs[idx], lows[idx]);
+    golden_foundation_signal(idx, prices[idx], sma[idx], rsi[idx], fvg, 0,
+                             rsi_oversold, risk_reward, signals, stops, targets);
 }
 
 // Memory pool for reducing allocation overhead
@@ -317,10 +174,10 @@ void gpu_calculate_indicators(
     // Launch fused kernel
     int block_size = 256;
     int grid_size = (n + block_size - 1) / block_size;
-    size_t shared_mem = block_size * max(sma_period, rsi_period + 1) * sizeof(double);
     
-    fused_indicators_kernel<<<grid_size, block_size, shared_mem>>>(
-        d_prices, d_sma, d_rsi, d_signals, d_stops, d_targets,
+    // Signals are discarded here, so closes stand in for highs and lows
+    fused_indicators_kernel<<<grid_size, block_size>>>(
+        d_prices, d_prices, d_prices, d_sma, d_rsi, d_signals, d_stops, d_targets,
         n, sma_period, rsi_period, 30.0, 2.0
     );
     
@@ -348,16 +205,18 @@ void gpu_calculate_indicators(
 }
 
 void gpu_generate_signals(
-    const double* prices, const double* sma, const double* rsi,
+    const double* prices, const double* highs, const double* lows, const double* sma, const double* rsi,
     int n, double rsi_oversold, double risk_reward,
     int* signals, double* stops, double* targets
 ) {
     // Allocate device memory using pool
-    double *d_prices, *d_sma, *d_rsi;
+    double *d_prices, *d_highs, *d_lows, *d_sma, *d_rsi;
     int *d_signals;
     double *d_stops, *d_targets;
     
     d_prices = (double*)g_memory_pool.allocate(n * sizeof(double));
+    d_highs = (double*)g_memory_pool.allocate(n * sizeof(double));
+    d_lows = (double*)g_memory_pool.allocate(n * sizeof(double));
     d_sma = (double*)g_memory_pool.allocate(n * sizeof(double));
     d_rsi = (double*)g_memory_pool.allocate(n * sizeof(double));
     d_signals = (int*)g_memory_pool.allocate(n * sizeof(int));
@@ -366,6 +225,8 @@ void gpu_generate_signals(
     
     // Asynchronous memory copies
     CUDA_CHECK_RETURN_VOID(cudaMemcpyAsync(d_prices, prices, n * sizeof(double), cudaMemcpyHostToDevice, 0));
+    CUDA_CHECK_RETURN_VOID(cudaMemcpyAsync(d_highs, highs, n * sizeof(double), cudaMemcpyHostToDevice, 0));
+    CUDA_CHECK_RETURN_VOID(cudaMemcpyAsync(d_lows, lows, n * sizeof(double), cudaMemcpyHostToDevice, 0));
     CUDA_CHECK_RETURN_VOID(cudaMemcpyAsync(d_sma, sma, n * sizeof(double), cudaMemcpyHostToDevice, 0));
     CUDA_CHECK_RETURN_VOID(cudaMemcpyAsync(d_rsi, rsi, n * sizeof(double), cudaMemcpyHostToDevice, 0));
     
@@ -374,7 +235,7 @@ void gpu_generate_signals(
     int grid_size = (n + block_size - 1) / block_size;
     
     optimized_signal_kernel<<<grid_size, block_size>>>(
-        d_prices, d_sma, d_rsi, d_signals, d_stops, d_targets,
+        d_prices, d_highs, d_lows, d_sma, d_rsi, d_signals, d_stops, d_targets,
         n, rsi_oversold, risk_reward
     );
     
@@ -394,6 +255,8 @@ void gpu_generate_signals(
     
     // Free memory back to pool
     g_memory_pool.free(d_prices);
+    g_memory_pool.free(d_highs);
+    g_memory_pool.free(d_lows);
     g_memory_pool.free(d_sma);
     g_memory_pool.free(d_rsi);
     g_memory_pool.free(d_signals);
@@ -403,32 +266,34 @@ void gpu_generate_signals(
 
 // New optimized function that does everything in one GPU call
 void gpu_calculate_all_indicators_and_signals(
-    const double* prices, int n,
+    const double* prices, const double* highs, const double* lows, int n,
     double* sma, double* rsi, int* signals, double* stops, double* targets,
     int sma_period, int rsi_period, double rsi_oversold, double risk_reward
 ) {
     // Allocate device memory using pool
-    double *d_prices, *d_sma, *d_rsi;
+    double *d_prices, *d_highs, *d_lows, *d_sma, *d_rsi;
     int *d_signals;
     double *d_stops, *d_targets;
     
     d_prices = (double*)g_memory_pool.allocate(n * sizeof(double));
+    d_highs = (double*)g_memory_pool.allocate(n * sizeof(double));
+    d_lows = (double*)g_memory_pool.allocate(n * sizeof(double));
     d_sma = (double*)g_memory_pool.allocate(n * sizeof(double));
     d_rsi = (double*)g_memory_pool.allocate(n * sizeof(double));
     d_signals = (int*)g_memory_pool.allocate(n * sizeof(int));
     d_stops = (double*)g_memory_pool.allocate(n * sizeof(double));
     d_targets = (double*)g_memory_pool.allocate(n * sizeof(double));
     
-    // Single memory copy
     CUDA_CHECK_RETURN_VOID(cudaMemcpyAsync(d_prices, prices, n * sizeof(double), cudaMemcpyHostToDevice, 0));
+    CUDA_CHECK_RETURN_VOID(cudaMemcpyAsync(d_highs, highs, n * sizeof(double), cudaMemcpyHostToDevice, 0));
+    CUDA_CHECK_RETURN_VOID(cudaMemcpyAsync(d_lows, lows, n * sizeof(double), cudaMemcpyHostToDevice, 0));
     
     // Launch single fused kernel
     int block_size = 256;
     int grid_size = (n + block_size - 1) / block_size;
-    size_t shared_mem = block_size * max(sma_period, rsi_period + 1) * sizeof(double);
     
-    fused_indicators_kernel<<<grid_size, block_size, shared_mem>>>(
-        d_prices, d_sma, d_rsi, d_signals, d_stops, d_targets,
+    fused_indicators_kernel<<<grid_size, block_size>>>(
+        d_prices, d_highs, d_lows, d_sma, d_rsi, d_signals, d_stops, d_targets,
         n, sma_period, rsi_period, rsi_oversold, risk_reward
     );
     
@@ -449,6 +314,8 @@ void gpu_calculate_all_indicators_and_signals(
     
     // Free memory back to pool
     g_memory_pool.free(d_prices);
+    g_memory_pool.free(d_highs);
+    g_memory_pool.free(d_lows);
     g_memory_pool.free(d_sma);
     g_memory_pool.free(d_rsi);
     g_memory_pool.free(d_signals);
@@ -458,71 +325,11 @@ void gpu_calculate_all_indicators_and_signals(
 
 } // extern "C" 
 
-// CUDA-compatible versions of the structs
-struct CudaOHLCV {
-    double open, high, low, close, volume;
-};
-
-struct CudaStrategyGene {
-    int primary_indicator;
-    int secondary_indicator;
-    int primary_period;
-    int secondary_period;
-    double primary_threshold;
-    double secondary_threshold;
-    int entry_condition;
-    int exit_condition;
-    double risk_reward_ratio;
-    double stop_loss_pct;
-    double take_profit_pct;
-    int max_hold_time;
-    double position_size_pct;
-};
-
-struct CudaFitnessResult {
-    double total_return;
-    double sharpe_ratio;
-    double max_drawdown;
-    double win_rate;
-    int total_trades;
-    double profit_factor;
-    double calmar_ratio;
-    double fitness_score;
-};
-
-__device__ double cuda_max(double a, double b) { return a > b ? a : b; }
-__device__ double cuda_min(double a, double b) { return a < b ? a : b; }
-
-__device__ double calculateSharpeRatio(const double* returns, int n) {
-    if (n == 0) return 0.0;
-    double mean = 0.0;
-    for (int i = 0; i < n; ++i) mean += returns[i];
-    mean /= n;
-    double variance = 0.0;
-    for (int i = 0; i < n; ++i) variance += (returns[i] - mean) * (returns[i] - mean);
-    variance /= n;
-    double std_dev = sqrt(variance);
-    return (std_dev > 0) ? mean / std_dev : 0.0;
-}
-
-__device__ double calculateMaxDrawdown(const double* equity_curve, int n) {
-    if (n == 0) return 0.0;
-    double max_dd = 0.0, peak = equity_curve[0];
-    for (int i = 0; i < n; ++i) {
-        if (equity_curve[i] > peak) peak = equity_curve[i];
-        double dd = (peak - equity_curve[i]) / peak;
-        if (dd > max_dd) max_dd = dd;
-    }
-    return max_dd;
-}
-
-__device__ double calculateProfitFactor(const double* profits, int n_profits, const double* losses, int n_losses) {
-    double total_profit = 0.0, total_loss = 0.0;
-    for (int i = 0; i < n_profits; ++i) total_profit += profits[i];
-    for (int i = 0; i < n_losses; ++i) total_loss += losses[i];
-    return (total_loss > 0) ? total_profit / total_loss : (total_profit > 0) ? 1000.0 : 0.0;
-}
+// CudaOHLCV / CudaStrategyGene / CudaFitnessResult are shared with the CPU
+// backend in PopulationEvaluator.hpp
 
+// Running metrics in the order StreamingMetrics uses, so the kernel needs no
+// per-bar arrays and handles any number of bars
 __global__ void evaluate_population_kernel(
     const CudaStrategyGene* genes,
     const CudaOHLCV* data,
@@ -533,41 +340,57 @@ __global__ void evaluate_population_kernel(
     int idx = blockIdx.x * blockDim.x + threadIdx.x;
     if (idx >= population_size) return;
     const CudaStrategyGene& gene = genes[idx];
-    double current_equity = 10000.0;
+    const double initial_equity = 10000.0;
+    double current_equity = initial_equity;
     int winning_trades = 0, total_trades = 0;
-    double equity_curve[1024]; // Assume max 1024 bars for demo; for real use, use dynamic alloc or limit size
-    double returns[1024];
-    double profits[256], losses[256];
-    int n_profits = 0, n_losses = 0;
-    int eq_idx = 0, ret_idx = 0;
+    double gross_profit = 0.0, gross_loss = 0.0;
+    double peak = initial_equity, max_drawdown = 0.0, last_equity = initial_equity;
+    double return_sum = 0.0, welford_mean = 0.0, welford_m2 = 0.0;
+    int n_returns = 0;
     for (int i = 0; i < data_size; ++i) {
-        // Simple buy signal: if close > open (placeholder for real logic)
+        // Simple buy signal: if close > open (placeholder; the CPU backend in
+        // PopulationEvaluator evaluates the gene's indicators)
         if (data[i].close > data[i].open) {
             double entry_price = data[i].close;
-            double stop_loss = entry_price * (1.0 - gene.stop_loss_pct);
-            double take_profit = entry_price * (1.0 + gene.take_profit_pct);
+            // No indicator series on the device, so signal exits keep only their stop/target
+            GeneExit exit = GeneExit::forGene(gene, entry_price, nullptr);
+            Position position;
+            position.open(i, entry_price, exit.stop, exit.target, exit.spec);
+            ExitFill fill;
             for (int j = i + 1; j < data_size; ++j) {
-                if (data[j].low <= stop_loss || data[j].high >= take_profit) {
-                    double exit_price = (data[j].low <= stop_loss) ? stop_loss : take_profit;
-                    double trade_return = (exit_price - entry_price) / entry_price;
-                    if (trade_return > 0) { winning_trades++; profits[n_profits++] = trade_return; }
-                    else { losses[n_losses++] = -trade_return; }
+                if (position.step(j, data[j].high, data[j].low, data[j].close, fill)) {
+                    double trade_return = (fill.price - entry_price) / entry_price;
+                    if (trade_return > 0) { winning_trades++; gross_profit += trade_return; }
+                    else { gross_loss -= trade_return; }
                     total_trades++;
                     current_equity *= (1 + trade_return * gene.position_size_pct);
                     break;
                 }
             }
         }
-        equity_curve[eq_idx++] = current_equity;
-        if (i > 0) returns[ret_idx++] = (current_equity - equity_curve[i-1]) / equity_curve[i-1];
+        if (i > 0) {
+            double r = (current_equity - last_equity) / last_equity;
+            ++n_returns;
+            return_sum += r;
+            double delta = r - welford_mean;
+            welford_mean += delta / n_returns;
+            welford_m2 += delta * (r - welford_mean);
+        } else {
+            peak = current_equity;
+        }
+        if (current_equity > peak) peak = current_equity;
+        double dd = (peak - current_equity) / peak;
+        if (dd > max_drawdown) max_drawdown = dd;
+        last_equity = current_equity;
     }
     CudaFitnessResult result;
-    result.total_return = (current_equity - 10000.0) / 10000.0;
-    result.sharpe_ratio = calculateSharpeRatio(returns, ret_idx);
-    result.max_drawdown = calculateMaxDrawdown(equity_curve, eq_idx);
+    double std_dev = n_returns > 0 ? sqrt(welford_m2 / n_returns) : 0.0;
+    result.total_return = (current_equity - initial_equity) / initial_equity;
+    result.sharpe_ratio = (std_dev > 0) ? (return_sum / n_returns) / std_dev : 0.0;
+    result.max_drawdown = max_drawdown;
     result.win_rate = (total_trades > 0) ? ((double)winning_trades / total_trades) : 0.0;
     result.total_trades = total_trades;
-    result.profit_factor = calculateProfitFactor(profits, n_profits, losses, n_losses);
+    result.profit_factor = (gross_loss > 0) ? gross_profit / gross_loss : (gross_profit > 0) ? 1000.0 : 0.0;
     result.calmar_ratio = (result.max_drawdown > 0) ? result.total_return / result.max_drawdown : 0.0;
     result.fitness_score = result.sharpe_ratio * 0.4 + result.total_return * 0.3 + result.win_rate * 0.2 + result.profit_factor * 0.1 - result.max_drawdown * 0.5;
     results[idx] = result;
@@ -5,8 +5,24 @@
 #include <iostream>
 #include <filesystem>
 #include <memory>
+#include <string>
+
+// Usage: trading_bot [--latency PREFIX]
+// --latency times every bar (signal, position update, whole bar), prints
+// p50/p90/p99/p99.9/max and writes PREFIX_signal.hgrm, PREFIX_update.hgrm
+// and PREFIX_bar.hgrm (HdrHistogram percentile format, microseconds).
+int main(int argc, char** argv) {
+    std::string latency_prefix;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--latency" && i + 1 < argc) {
+            latency_prefix = argv[++i];
+        } else {
+            std::cerr << "Usage: trading_bot [--latency PREFIX]" << std::endl;
+            return 1;
+        }
+    }
 
-int main() {
     std::string data_path = FileUtils::findDataFile("SPY_1m.csv");
     if (!std::filesystem::exists(data_path)) {
         std::cerr << "ERROR: SPY_1m.csv not found!" << std::endl;
@@ -35,11 +51,26 @@ int main() {
     std::unique_ptr<Strategy> strategy(createGoldenFoundationStrategy(1.0));
     std::cout << "Creating backtester...\n";
     Backtester backtester(data, strategy.get(), 1000.0);
+    std::unique_ptr<BarLatency> latency;
+    if (!latency_prefix.empty()) {
+        latency = std::make_unique<BarLatency>();
+        backtester.setLatency(latency.get());
+        // Per-bar logging would land inside the timed windows
+        backtester.setLogging(false);
+    }
     std::cout << "Running backtest...\n";
     backtester.run();
     std::cout << "Backtest complete.\n";
     backtester.printYearlyPnL();
     backtester.printTotalGain();
+    if (latency) {
+        latency->report(std::cout);
+        if (!latency->writeHgrm(latency_prefix)) {
+            std::cerr << "ERROR: Cannot write " << latency_prefix << "_*.hgrm" << std::endl;
+            return 1;
+        }
+        std::cout << "Latency histograms written to " << latency_prefix << "_{signal,update,bar}.hgrm" << std::endl;
+    }
 
     return 0;
 }
\ No newline at end of file
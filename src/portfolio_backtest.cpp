@@ -0,0 +1,82 @@
+#include "../include/DataLoader.hpp"
+#include "../include/Strategy.hpp"
+#include "../include/PortfolioBacktester.hpp"
+#include <iostream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <memory>
+
+// Usage: portfolio_backtest [--rr R] [--risk F] [--max-positions N] [--threads N] [--latency PREFIX] file1.csv file2.csv ...
+// The symbol is taken from the file name up to the first '_' (SPY_1m.csv -> SPY).
+// --latency prints per-bar signal and per-slice update latency percentiles
+// and writes them to PREFIX_{signal,update,bar}.hgrm.
+int main(int argc, char** argv) {
+    PortfolioConfig config;
+    double risk_reward = 3.0;
+    std::vector<std::string> files;
+    std::string latency_prefix;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--rr" && i + 1 < argc) {
+            risk_reward = std::stod(argv[++i]);
+        } else if (arg == "--risk" && i + 1 < argc) {
+            config.risk_per_trade = std::stod(argv[++i]);
+        } else if (arg == "--max-positions" && i + 1 < argc) {
+            config.max_open_positions = std::stoi(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            config.threads = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--equity" && i + 1 < argc) {
+            config.initial_equity = std::stod(argv[++i]);
+        } else if (arg == "--latency" && i + 1 < argc) {
+            latency_prefix = argv[++i];
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    if (files.empty()) {
+        std::cerr << "Usage: portfolio_backtest [--rr R] [--risk F] [--max-positions N] [--threads N] [--equity E] [--latency PREFIX] file1.csv ..." << std::endl;
+        return 1;
+    }
+
+    std::vector<SymbolSeries> universe;
+    for (const auto& path : files) {
+        SymbolSeries series;
+        std::string stem = std::filesystem::path(path).stem().string();
+        series.symbol = stem.substr(0, stem.find('_'));
+        series.bars = DataLoader::loadCSV(path);
+        if (series.bars.empty()) {
+            std::cerr << "[ERROR] No bars loaded from " << path << ", skipping" << std::endl;
+            continue;
+        }
+        std::cout << "[INFO] " << series.symbol << ": " << series.bars.size() << " bars ("
+                  << series.bars.front().timestamp << " to " << series.bars.back().timestamp << ")" << std::endl;
+        universe.push_back(std::move(series));
+    }
+    if (universe.empty()) {
+        std::cerr << "[ERROR] No data loaded" << std::endl;
+        return 1;
+    }
+
+    PortfolioBacktester portfolio(universe, [risk_reward](const std::string&) {
+        return std::unique_ptr<Strategy>(createGoldenFoundationStrategy(risk_reward));
+    }, config);
+    std::unique_ptr<BarLatency> latency;
+    if (!latency_prefix.empty()) {
+        latency = std::make_unique<BarLatency>();
+        portfolio.setLatency(latency.get());
+    }
+    portfolio.run();
+    portfolio.printSummary();
+    if (latency) {
+        latency->report(std::cout);
+        if (!latency->writeHgrm(latency_prefix)) {
+            std::cerr << "[ERROR] Cannot write " << latency_prefix << "_*.hgrm" << std::endl;
+            return 1;
+        }
+        std::cout << "[INFO] Latency histograms written to " << latency_prefix << "_{signal,update,bar}.hgrm" << std::endl;
+    }
+    return 0;
+}
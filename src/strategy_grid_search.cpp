@@ -2,11 +2,18 @@
 #include "../include/Backtester.hpp"
 #include "../include/Strategy.hpp"
 #include "../include/Strategy.hpp" // For GoldenFoundationStrategy
+#include "../include/BarView.hpp"
+#include "../include/ThreadPool.hpp"
+#include "../include/ScreeningReport.hpp"
 #include <fstream>
 #include <iostream>
 #include <vector>
 #include <iomanip>
 #include <memory>
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
 
 // Helper: Run a backtest and return results
 struct GridResult {
@@ -19,18 +26,149 @@ struct GridResult {
     double win_rate;
 };
 
-int main() {
+namespace {
+
+// Backtests one grid point on bars
+GridResult runConfig(const BarView& bars, int sma, int rsi, double rsi_th, double rr) {
+    std::unique_ptr<Strategy> strategy(createGoldenFoundationStrategy(rr));
+    auto* strat = dynamic_cast<GoldenFoundationStrategy*>(strategy.get());
+    if (strat) {
+        strat->setSMA(sma);
+        strat->setRSI(rsi, rsi_th);
+    }
+    Backtester backtester(bars, strategy.get(), 10000.0);
+    backtester.setLogging(false);
+    backtester.run();
+    return {sma, rsi, rsi_th, rr, backtester.getFinalEquity(), backtester.getTotalTrades(), backtester.getWinRate()};
+}
+
+// Float32 close/high/low of the bars, for screening
+struct FloatBars {
+    std::vector<float> close, high, low;
+
+    explicit FloatBars(const BarView& bars) : close(bars.size()), high(bars.size()), low(bars.size()) {
+        for (size_t i = 0; i < bars.size(); ++i) {
+            close[i] = static_cast<float>(bars[i].close);
+            high[i] = static_cast<float>(bars[i].high);
+            low[i] = static_cast<float>(bars[i].low);
+        }
+    }
+};
+
+// runConfig in float32 on the first n bars: the same GoldenFoundation rule
+// and Backtester fills, instantiated for float
+GridResult screenConfig(const FloatBars& bars, size_t n, int sma, int rsi, double rsi_th, double rr) {
+    GoldenFoundationSignals<float> signals;
+    signals.compute(bars.close.data(), bars.high.data(), bars.low.data(), n,
+                    static_cast<size_t>(sma), static_cast<size_t>(rsi), rsi_th, rr);
+    const TradeTotals t = Backtester::runSignals(bars.close.data(), bars.high.data(), bars.low.data(), n, signals, 10000.0);
+    return {sma, rsi, rsi_th, rr, t.final_equity, t.trades, t.trades > 0 ? static_cast<double>(t.wins) / t.trades : 0.0};
+}
+
+// Backtests configs[i] on bars for every i, in parallel; results keep the
+// order. With screen, the first bars.size() bars of screen are backtested in
+// float32 instead.
+std::vector<GridResult> runRung(ThreadPool& pool, const BarView& bars, const std::vector<GridResult>& configs,
+                                const FloatBars* screen = nullptr) {
+    std::vector<GridResult> results(configs.size());
+    pool.parallelFor(configs.size(), [&](size_t i) {
+        const GridResult& c = configs[i];
+        results[i] = screen ? screenConfig(*screen, bars.size(), c.sma_period, c.rsi_period, c.rsi_threshold, c.risk_reward)
+                            : runConfig(bars, c.sma_period, c.rsi_period, c.rsi_threshold, c.risk_reward);
+    });
+    return results;
+}
+
+// Re-scores the screened finalists in double on bars and prints how well the
+// float32 ranking held; returns the double results
+std::vector<GridResult> rescore(ThreadPool& pool, const BarView& bars, const std::vector<GridResult>& finalists) {
+    std::vector<GridResult> reference = runRung(pool, bars, finalists);
+    std::vector<double> screened_equity(finalists.size()), reference_equity(reference.size());
+    for (size_t i = 0; i < finalists.size(); ++i) {
+        screened_equity[i] = finalists[i].final_equity;
+        reference_equity[i] = reference[i].final_equity;
+    }
+    const ScreeningReport report = ScreeningReport::compare(screened_equity, reference_equity, 5);
+    std::cout << "[INFO] " << report.toString() << std::endl;
+    if (!report.within()) {
+        std::cout << "[WARNING] Float32 screening disagrees with float64 beyond the bounds; "
+                     "the best config comes from the float64 results" << std::endl;
+    }
+    return reference;
+}
+
+// Indices of results by final equity, best first; ties keep grid order
+std::vector<size_t> byEquity(const std::vector<GridResult>& results) {
+    std::vector<size_t> order(results.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return results[a].final_equity > results[b].final_equity; });
+    return order;
+}
+
+// Bars seen by rung r of `rungs` when each rung keeps 1/eta of the configs:
+// the last rung sees all n bars, each earlier one 1/eta of the next
+size_t rungBars(size_t n, size_t rung, size_t rungs, double eta, size_t min_bars) {
+    double bars = static_cast<double>(n) / std::pow(eta, static_cast<double>(rungs - 1 - rung));
+    return std::min(n, std::max(min_bars, static_cast<size_t>(bars)));
+}
+
+} // namespace
+
+// Usage: strategy_grid_search [--halving] [--eta N] [--min-bars N] [--threads N] [--float32] [--finalists K]
+// Without --halving every grid point is backtested on the full history.
+// --halving runs successive halving: all points are backtested on a short
+// prefix of the history, the best 1/eta (default 3) by final equity move on
+// to a prefix eta times longer, and so on until the last rung runs the
+// finalists on the full history. The first prefix is never shorter than
+// --min-bars (default 2000). Each rung runs in parallel.
+// --float32 screens every backtest in single precision, then re-scores the
+// finalists in double: the K best configs (default 10), or with --halving
+// the last rung. The results file gets a Precision column, and the agreement
+// of the two rankings is printed.
+int main(int argc, char** argv) {
+    bool halving = false;
+    double eta = 3.0;
+    size_t min_bars = 2000;
+    size_t threads = 0;
+    bool float32 = false;
+    size_t finalist_count = 10;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--halving") {
+            halving = true;
+        } else if (arg == "--eta" && i + 1 < argc) {
+            eta = std::stod(argv[++i]);
+        } else if (arg == "--min-bars" && i + 1 < argc) {
+            min_bars = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--float32") {
+            float32 = true;
+        } else if (arg == "--finalists" && i + 1 < argc) {
+            finalist_count = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else {
+            std::cerr << "Usage: strategy_grid_search [--halving] [--eta N] [--min-bars N] [--threads N]"
+                      << " [--float32] [--finalists K]" << std::endl;
+            return 1;
+        }
+    }
+    if (eta < 2.0) {
+        std::cerr << "[ERROR] --eta must be at least 2" << std::endl;
+        return 1;
+    }
+
     // Try multiple possible data file paths
     std::vector<std::string> possible_paths = {
         "data/SPY_1m.csv",
-        "../data/SPY_1m.csv", 
+        "../data/SPY_1m.csv",
         "../../data/SPY_1m.csv",
         "../../../data/SPY_1m.csv"
     };
-    
+
     std::string data_path;
     auto data = std::vector<OHLCV>();
-    
+
     for (const auto& path : possible_paths) {
         std::cout << "[INFO] Trying data path: " << path << std::endl;
         data = DataLoader::loadCSV(path);
@@ -40,7 +178,7 @@ int main() {
             break;
         }
     }
-    
+
     if (data.empty()) {
         std::cerr << "[ERROR] Could not find SPY_1m.csv in any of the expected locations:" << std::endl;
         for (const auto& path : possible_paths) {
@@ -49,7 +187,7 @@ int main() {
         std::cerr << "[ERROR] Please ensure SPY_1m.csv exists in the data directory." << std::endl;
         return 1;
     }
-    
+
     std::cout << "[INFO] Loaded " << data.size() << " bars from " << data_path << std::endl;
 
     // Parameter ranges
@@ -58,36 +196,115 @@ int main() {
     std::vector<double> rsi_thresholds = {20.0, 30.0, 40.0};
     std::vector<double> risk_rewards = {1.5, 2.0, 3.0, 5.0};
 
-    std::ofstream csv("grid_search_results.csv");
-    csv << "SMA,RSI,RSI_Threshold,RR,FinalEquity,TotalTrades,WinRate\n";
-
-    int test_count = 0;
+    std::vector<GridResult> configs;
     for (int sma : sma_periods) {
         for (int rsi : rsi_periods) {
             for (double rsi_th : rsi_thresholds) {
                 for (double rr : risk_rewards) {
-                    std::unique_ptr<Strategy> strategy(createGoldenFoundationStrategy(rr));
-                    auto* strat = dynamic_cast<GoldenFoundationStrategy*>(strategy.get());
-                    if (strat) {
-                        strat->setSMA(sma);
-                        strat->setRSI(rsi, rsi_th);
-                    }
-                    Backtester backtester(data, strategy.get(), 10000.0);
-                    backtester.run();
-                    double final_equity = backtester.getFinalEquity();
-                    int total_trades = backtester.getTotalTrades();
-                    double win_rate = backtester.getWinRate();
-                    csv << sma << "," << rsi << "," << rsi_th << "," << rr << ","
-                        << std::fixed << std::setprecision(2) << final_equity << ","
-                        << total_trades << ","
-                        << std::setprecision(4) << win_rate << "\n";
-                    test_count++;
-                    std::cout << "Test " << test_count << ": SMA=" << sma << ", RSI=" << rsi << ", RSI_Th=" << rsi_th << ", RR=" << rr << " => Equity=" << final_equity << ", Trades=" << total_trades << ", WinRate=" << win_rate << std::endl;
+                    configs.push_back({sma, rsi, rsi_th, rr, 0.0, 0, 0.0});
                 }
             }
         }
     }
+
+    const BarView bars(data);
+    const size_t n = bars.size();
+    ThreadPool pool(threads);
+    std::cout << "[INFO] " << configs.size() << " grid points, " << pool.size() << " threads" << std::endl;
+    std::unique_ptr<FloatBars> screen;
+    if (float32) {
+        screen = std::make_unique<FloatBars>(bars);
+        std::cout << "[INFO] Float32 screening, finalists re-scored in float64" << std::endl;
+    }
+
+    std::ofstream csv("grid_search_results.csv");
+    // One results row; the Precision column only with --float32
+    auto writeRow = [&](const GridResult& r, const char* precision) {
+        csv << r.sma_period << "," << r.rsi_period << "," << r.rsi_threshold << "," << r.risk_reward << ","
+            << std::fixed << std::setprecision(2) << r.final_equity << ","
+            << r.total_trades << ","
+            << std::setprecision(4) << r.win_rate;
+        csv.unsetf(std::ios::floatfield);
+        if (screen) csv << "," << precision;
+        csv << "\n";
+    };
+    const char* precision_column = screen ? ",Precision\n" : "\n";
+
+    if (!halving) {
+        csv << "SMA,RSI,RSI_Threshold,RR,FinalEquity,TotalTrades,WinRate" << precision_column;
+        std::vector<GridResult> results = runRung(pool, bars, configs, screen.get());
+        int test_count = 0;
+        for (const auto& r : results) {
+            writeRow(r, "float32");
+            test_count++;
+            std::cout << "Test " << test_count << ": SMA=" << r.sma_period << ", RSI=" << r.rsi_period << ", RSI_Th=" << r.rsi_threshold << ", RR=" << r.risk_reward << " => Equity=" << r.final_equity << ", Trades=" << r.total_trades << ", WinRate=" << r.win_rate << std::endl;
+        }
+        if (screen) {
+            const std::vector<size_t> order = byEquity(results);
+            std::vector<GridResult> finalists;
+            for (size_t k = 0; k < std::min(finalist_count, order.size()); ++k) finalists.push_back(results[order[k]]);
+            const std::vector<GridResult> reference = rescore(pool, bars, finalists);
+            for (const GridResult& r : reference) writeRow(r, "float64");
+            const GridResult& best = reference[byEquity(reference).front()];
+            std::cout << "Best (float64): SMA=" << best.sma_period << ", RSI=" << best.rsi_period
+                      << ", RSI_Th=" << best.rsi_threshold << ", RR=" << best.risk_reward
+                      << " => Equity=" << best.final_equity << ", Trades=" << best.total_trades
+                      << ", WinRate=" << best.win_rate << std::endl;
+        }
+        csv.close();
+        std::cout << "Grid search complete. Results written to grid_search_results.csv" << std::endl;
+        return 0;
+    }
+
+    // Successive halving: rungs until at most eta finalists remain for the
+    // full history, each rung on a prefix eta times longer than the last
+    size_t rungs = 1;
+    for (size_t count = configs.size(); count > eta; count = static_cast<size_t>(std::ceil(count / eta))) ++rungs;
+
+    csv << "Rung,Bars,SMA,RSI,RSI_Threshold,RR,FinalEquity,TotalTrades,WinRate" << precision_column;
+    size_t bars_evaluated = 0;
+    std::vector<GridResult> survivors = configs;
+    std::vector<GridResult> results;
+    for (size_t rung = 0; rung < rungs; ++rung) {
+        const size_t window = rungBars(n, rung, rungs, eta, min_bars);
+        results = runRung(pool, bars.slice(0, window), survivors, screen.get());
+        bars_evaluated += survivors.size() * window;
+
+        const std::vector<size_t> order = byEquity(results);
+        for (size_t i : order) {
+            csv << rung << "," << window << ",";
+            writeRow(results[i], "float32");
+        }
+        const GridResult& top = results[order.front()];
+        std::cout << "Rung " << rung << ": " << results.size() << " configs on " << window << " bars, best SMA="
+                  << top.sma_period << ", RSI=" << top.rsi_period << ", RSI_Th=" << top.rsi_threshold
+                  << ", RR=" << top.risk_reward << " => Equity=" << top.final_equity << std::endl;
+
+        if (rung + 1 < rungs) {
+            const size_t keep = std::max<size_t>(1, static_cast<size_t>(std::ceil(results.size() / eta)));
+            survivors.clear();
+            for (size_t k = 0; k < keep; ++k) survivors.push_back(results[order[k]]);
+        }
+    }
+    if (screen) {
+        // The last rung ran on the full history: its configs are the finalists
+        results = rescore(pool, bars, results);
+        for (size_t i : byEquity(results)) {
+            csv << rungs - 1 << "," << n << ",";
+            writeRow(results[i], "float64");
+        }
+    }
     csv.close();
+
+    const GridResult& best = *std::max_element(results.begin(), results.end(),
+        [](const GridResult& a, const GridResult& b) { return a.final_equity < b.final_equity; });
+    const double full_sweep = static_cast<double>(configs.size()) * n;
+    std::cout << "Best: SMA=" << best.sma_period << ", RSI=" << best.rsi_period << ", RSI_Th=" << best.rsi_threshold
+              << ", RR=" << best.risk_reward << " => Equity=" << best.final_equity << ", Trades=" << best.total_trades
+              << ", WinRate=" << best.win_rate << std::endl;
+    std::cout << "Search cost: " << bars_evaluated << " bars backtested, " << std::fixed << std::setprecision(1)
+              << 100.0 * bars_evaluated / full_sweep << "% of a full sweep, "
+              << static_cast<double>(bars_evaluated) / n << " full-history backtests" << std::endl;
     std::cout << "Grid search complete. Results written to grid_search_results.csv" << std::endl;
     return 0;
 }
@@ -0,0 +1,245 @@
+#include "../include/DataLoader.hpp"
+#include "../include/Backtester.hpp"
+#include "../include/Strategy.hpp"
+#include "../include/GeneticStrategy.hpp"
+#include "../include/GeneEvaluator.hpp"
+#include "../include/TpeOptimizer.hpp"
+#include "../include/ThreadPool.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+#define INFO(msg)  std::cout << "[INFO] " << msg << std::endl;
+#define ERROR(msg) std::cerr << "[ERROR] " << msg << std::endl;
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Same ranges as StrategyGene::random
+    std::vector<SearchDimension> geneSpace() {
+        return {
+            SearchDimension::categorical("primary_indicator", 8),
+            SearchDimension::categorical("secondary_indicator", 8),
+            SearchDimension::integer("primary_period", 5, 50),
+            SearchDimension::integer("secondary_period", 5, 50),
+            SearchDimension::real("primary_threshold", -30.0, 30.0),
+            SearchDimension::real("secondary_threshold", -30.0, 30.0),
+            SearchDimension::categorical("entry_condition", 6),
+            SearchDimension::categorical("exit_condition", 4),
+            SearchDimension::real("risk_reward_ratio", 1.0, 5.0),
+            SearchDimension::real("stop_loss_pct", 0.005, 0.10),
+            SearchDimension::real("take_profit_pct", 0.005, 0.10),
+            SearchDimension::integer("max_hold_time", 1, 48),
+            SearchDimension::real("position_size_pct", 0.01, 0.3),
+            SearchDimension::categorical("primary_timeframe", static_cast<int>(kTimeframeCount)),
+            SearchDimension::categorical("secondary_timeframe", static_cast<int>(kTimeframeCount)),
+        };
+    }
+
+    StrategyGene toGene(const SearchPoint& p) {
+        StrategyGene g;
+        g.primary_indicator   = static_cast<StrategyGene::IndicatorType>(static_cast<int>(p[0]));
+        g.secondary_indicator = static_cast<StrategyGene::IndicatorType>(static_cast<int>(p[1]));
+        g.primary_period      = static_cast<int>(p[2]);
+        g.secondary_period    = static_cast<int>(p[3]);
+        g.primary_threshold   = p[4];
+        g.secondary_threshold = p[5];
+        g.entry_condition     = static_cast<StrategyGene::EntryCondition>(static_cast<int>(p[6]));
+        g.exit_condition      = static_cast<StrategyGene::ExitCondition>(static_cast<int>(p[7]));
+        g.risk_reward_ratio   = p[8];
+        g.stop_loss_pct       = p[9];
+        g.take_profit_pct     = p[10];
+        g.max_hold_time       = static_cast<int>(p[11]);
+        g.position_size_pct   = p[12];
+        g.primary_timeframe   = kTimeframes[static_cast<size_t>(p[13])];
+        g.secondary_timeframe = kTimeframes[static_cast<size_t>(p[14])];
+        return g;
+    }
+
+    // GoldenFoundationStrategy parameters over the strategy_grid_search ranges
+    std::vector<SearchDimension> goldenSpace() {
+        return {
+            SearchDimension::integer("sma_period", 5, 100),
+            SearchDimension::integer("rsi_period", 7, 21),
+            SearchDimension::real("rsi_threshold", 20.0, 40.0),
+            SearchDimension::real("risk_reward", 1.5, 5.0),
+        };
+    }
+
+    double goldenEquity(const BarView& bars, int sma, int rsi, double rsi_th, double rr) {
+        std::unique_ptr<Strategy> strategy(createGoldenFoundationStrategy(rr));
+        auto* strat = dynamic_cast<GoldenFoundationStrategy*>(strategy.get());
+        if (strat) {
+            strat->setSMA(sma);
+            strat->setRSI(rsi, rsi_th);
+        }
+        Backtester backtester(bars, strategy.get(), 10000.0);
+        backtester.setLogging(false);
+        backtester.run();
+        return backtester.getFinalEquity();
+    }
+
+    // First trial (1-based) scoring at least target, or 0
+    size_t trialsToReach(const TpeOptimizer& tpe, double target) {
+        for (size_t i = 0; i < tpe.trials().size(); ++i) {
+            if (tpe.trials()[i].score >= target) return i + 1;
+        }
+        return 0;
+    }
+
+    void printPoint(const TpeOptimizer& tpe, const SearchPoint& p) {
+        for (size_t d = 0; d < p.size(); ++d) {
+            std::cout << (d ? ", " : "  ") << tpe.space()[d].name << "=" << p[d];
+        }
+        std::cout << "\n";
+    }
+
+    // TPE against the GA, both given the same number of backtests
+    int compareWithGA(const std::vector<OHLCV>& data, size_t budget, size_t batch, uint64_t seed, ThreadPool& pool) {
+        const BarView bars(data);
+        TimeframePyramid pyramid = TimeframePyramid::build(bars);
+        GeneEvaluator evaluator(bars, pyramid);
+
+        TpeOptimizer tpe(geneSpace(), seed);
+        auto start = Clock::now();
+        const SearchTrial& best = tpe.optimize(
+            [&](const SearchPoint& p) { return evaluator.evaluate(toGene(p)).fitness_score; },
+            budget, batch, pool);
+        const double tpe_seconds = secondsSince(start);
+
+        const int population = 50;
+        const int generations = std::max(1, static_cast<int>(budget / population));
+        start = Clock::now();
+        GeneticAlgorithm ga(bars, population, generations, 0.1, 0.8, seed, pool.size());
+        ga.evolve();
+        const double ga_seconds = secondsSince(start);
+        const double ga_best = ga.getBestStrategy().fitness;
+
+        std::cout << "\n=== TPE vs GA (StrategyGene fitness) ===\n"
+                  << std::setprecision(6)
+                  << "TPE: best " << best.score << " after " << tpe.trials().size() << " backtests, "
+                  << tpe_seconds << " s\n"
+                  << "GA : best " << ga_best << " after " << ga.cacheMisses() << " backtests ("
+                  << population << " x " << generations << "), " << ga_seconds << " s\n";
+        const size_t reach = trialsToReach(tpe, ga_best);
+        if (reach) {
+            std::cout << "TPE reached the GA's best after " << reach << " backtests\n";
+        } else {
+            std::cout << "TPE did not reach the GA's best within " << budget << " backtests\n";
+        }
+        std::cout << "Best TPE gene: " << toGene(best.point).toString() << "\n";
+        return 0;
+    }
+
+    // TPE against the exhaustive strategy_grid_search grid
+    int compareWithGrid(const std::vector<OHLCV>& data, size_t budget, size_t batch, uint64_t seed, ThreadPool& pool) {
+        const BarView bars(data);
+        std::vector<SearchPoint> grid;
+        for (int sma : {5, 10, 20, 50, 100}) {
+            for (int rsi : {7, 14, 21}) {
+                for (double rsi_th : {20.0, 30.0, 40.0}) {
+                    for (double rr : {1.5, 2.0, 3.0, 5.0}) grid.push_back({double(sma), double(rsi), rsi_th, rr});
+                }
+            }
+        }
+        auto equity = [&](const SearchPoint& p) {
+            return goldenEquity(bars, static_cast<int>(p[0]), static_cast<int>(p[1]), p[2], p[3]);
+        };
+
+        auto start = Clock::now();
+        std::vector<double> grid_equity(grid.size());
+        pool.parallelFor(grid.size(), [&](size_t i) { grid_equity[i] = equity(grid[i]); });
+        const double grid_seconds = secondsSince(start);
+        const size_t grid_best = std::max_element(grid_equity.begin(), grid_equity.end()) - grid_equity.begin();
+
+        TpeOptimizer tpe(goldenSpace(), seed);
+        start = Clock::now();
+        const SearchTrial& best = tpe.optimize(equity, budget, batch, pool);
+        const double tpe_seconds = secondsSince(start);
+
+        std::cout << "\n=== TPE vs grid (GoldenFoundationStrategy final equity) ===\n"
+                  << std::fixed << std::setprecision(2)
+                  << "Grid: best " << grid_equity[grid_best] << " after " << grid.size() << " backtests, "
+                  << std::setprecision(3) << grid_seconds << " s\n";
+        printPoint(tpe, grid[grid_best]);
+        std::cout << std::setprecision(2)
+                  << "TPE : best " << best.score << " after " << tpe.trials().size() << " backtests, "
+                  << std::setprecision(3) << tpe_seconds << " s\n";
+        printPoint(tpe, best.point);
+        const size_t rank = 1 + std::count_if(grid_equity.begin(), grid_equity.end(),
+                                              [&](double e) { return e > best.score; });
+        std::cout << "TPE best would rank #" << rank << " of " << grid.size() << " grid points\n";
+        const size_t reach = trialsToReach(tpe, grid_equity[grid_best]);
+        if (reach) {
+            std::cout << "TPE reached the grid optimum after " << reach << " backtests ("
+                      << std::setprecision(1) << static_cast<double>(grid.size()) / reach << "x fewer)\n";
+        } else {
+            std::cout << "TPE did not reach the grid optimum within " << budget << " backtests\n";
+        }
+        return 0;
+    }
+
+} // namespace
+
+// Usage: surrogate_search [--target gene|golden] [--budget N] [--batch N] [--seed N] [--threads N] [--data FILE]
+// Tree-structured Parzen search over StrategyGene parameters (compared with
+// a GeneticAlgorithm run given the same number of backtests) or over the
+// GoldenFoundationStrategy grid parameters (compared with the full
+// strategy_grid_search grid). Each batch of proposals is backtested in
+// parallel; --batch defaults to the thread count.
+int main(int argc, char** argv) {
+    std::string target = "gene";
+    std::string data_path = "data/SPY_1m.csv";
+    size_t budget = 0, batch = 0, threads = 0;
+    uint64_t seed = 42;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--target" && i + 1 < argc) {
+            target = argv[++i];
+        } else if (arg == "--budget" && i + 1 < argc) {
+            budget = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--batch" && i + 1 < argc) {
+            batch = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::stoull(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--data" && i + 1 < argc) {
+            data_path = argv[++i];
+        } else {
+            std::cerr << "Usage: surrogate_search [--target gene|golden] [--budget N] [--batch N] [--seed N]"
+                      << " [--threads N] [--data FILE]" << std::endl;
+            return 1;
+        }
+    }
+    if (target != "gene" && target != "golden") {
+        ERROR("Unknown target " << target << " (expected gene or golden)");
+        return 1;
+    }
+
+    auto data = DataLoader::loadCSV(data_path);
+    if (data.empty()) {
+        ERROR("No bars loaded from " << data_path);
+        return 1;
+    }
+    INFO("Loaded " << data.size() << " bars from " << data_path);
+
+    ThreadPool pool(threads);
+    if (batch == 0) batch = pool.size();
+    if (budget == 0) budget = (target == "gene") ? 1000 : 36;
+    INFO("Target " << target << ", budget " << budget << " backtests, batch " << batch << ", seed " << seed
+         << ", threads " << pool.size());
+
+    return (target == "gene") ? compareWithGA(data, budget, batch, seed, pool)
+                              : compareWithGrid(data, budget, batch, seed, pool);
+}